@@ -0,0 +1,188 @@
+/*********************************************************************************
+*     File Name           :     bench.cc
+*     Created By          :     yuewu
+*     Description         :     micro-benchmarks of readers, kernels and models
+**********************************************************************************/
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#include <cmdline/cmdline.h>
+
+using namespace std;
+using namespace sol::pario;
+
+namespace sol {
+namespace bench {
+
+volatile double g_sink = 0;
+
+Runner::Runner(double min_time, const string& filter)
+    : min_time_(min_time), filter_(filter), results_(Json::arrayValue) {}
+
+bool Runner::Selected(const string& name) const {
+  return this->filter_.empty() || name.find(this->filter_) != string::npos;
+}
+
+void Runner::Run(const string& name, const function<size_t()>& func,
+                 size_t bytes) {
+  if (!this->Selected(name)) return;
+  typedef chrono::steady_clock clock;
+  func();
+
+  size_t run_num = 0, item_num = 0;
+  double seconds = 0;
+  clock::time_point start = clock::now();
+  do {
+    item_num += func();
+    ++run_num;
+    seconds = chrono::duration<double>(clock::now() - start).count();
+  } while (seconds < this->min_time_);
+
+  Json::Value result;
+  result["name"] = name;
+  result["runs"] = Json::UInt64(run_num);
+  result["seconds"] = seconds;
+  result["items"] = Json::UInt64(item_num);
+  result["items_per_sec"] = item_num / seconds;
+  result["ns_per_item"] = item_num > 0 ? seconds * 1e9 / item_num : 0;
+  if (bytes > 0) {
+    result["mb_per_sec"] = bytes * double(run_num) / seconds / 1048576.0;
+  }
+  this->results_.append(result);
+  fprintf(stderr, "%-40s %12.1f ns/item %14.0f items/s\n", name.c_str(),
+          result["ns_per_item"].asDouble(), result["items_per_sec"].asDouble());
+}
+
+void Runner::Speedup(const string& name, const string& base_name) {
+  Json::Value* result = nullptr;
+  const Json::Value* base = nullptr;
+  for (Json::Value& res : this->results_) {
+    if (res["name"] == name) result = &res;
+    if (res["name"] == base_name) base = &res;
+  }
+  if (result == nullptr || base == nullptr || result->isMember("error") ||
+      base->isMember("error")) {
+    return;
+  }
+  double speedup = (*result)["items_per_sec"].asDouble() /
+                   (*base)["items_per_sec"].asDouble();
+  (*result)["speedup"] = speedup;
+  (*result)["speedup_over"] = base_name;
+  fprintf(stderr, "%-40s %12.2fx speedup over %s\n", name.c_str(), speedup,
+          base_name.c_str());
+}
+
+void Runner::Fail(const string& name, const string& error) {
+  if (!this->Selected(name)) return;
+  Json::Value result;
+  result["name"] = name;
+  result["error"] = error;
+  this->results_.append(result);
+  fprintf(stderr, "%-40s failed: %s\n", name.c_str(), error.c_str());
+}
+
+void Runner::Write(ostream& os, const string& tag) const {
+  Json::Value root;
+  if (!tag.empty()) root["tag"] = tag;
+  root["min_time"] = this->min_time_;
+  root["benchmarks"] = this->results_;
+  Json::StyledStreamWriter writer;
+  writer.write(os, root);
+}
+
+void GenerateData(size_t data_num, index_t dim, size_t feat_num,
+                  unsigned int seed, vector<DataPoint>& data) {
+  mt19937 gen(seed);
+  uniform_int_distribution<index_t> index_dis(1, dim - 1);
+  normal_distribution<float> feat_dis(0.f, 1.f);
+  vector<float> hyperplane(dim);
+  for (index_t i = 0; i < dim; ++i) hyperplane[i] = feat_dis(gen);
+
+  data.resize(data_num);
+  vector<index_t> indexes;
+  for (size_t i = 0; i < data_num; ++i) {
+    indexes.clear();
+    for (size_t k = 0; k < feat_num; ++k) indexes.push_back(index_dis(gen));
+    sort(indexes.begin(), indexes.end());
+    indexes.erase(unique(indexes.begin(), indexes.end()), indexes.end());
+
+    DataPoint& x = data[i];
+    x.Clear();
+    float margin = 0;
+    for (index_t index : indexes) {
+      real_t feat = feat_dis(gen);
+      x.AddNewFeat(index, feat);
+      margin += hyperplane[index] * feat;
+    }
+    x.set_label(margin >= 0 ? 1 : -1);
+  }
+}
+
+}  // namespace bench
+}  // namespace sol
+
+int main(int argc, char** argv) {
+  cmdline::parser parser;
+  parser.add<double>("min-time", 0, "minimum seconds to run each benchmark",
+                     false, "", 0.5);
+  parser.add<string>("filter", 0,
+                     "only run the benchmarks whose names contain the string",
+                     false, "", "");
+  parser.add<int>("data-num", 0, "number of generated data points", false, "",
+                  20000);
+  parser.add<int>("dim", 0, "dimension of the generated data", false, "",
+                  100000);
+  parser.add<int>("feat-num", 0, "number of features of each data point",
+                  false, "", 50);
+  parser.add<int>("threads", 0, "number of threads of the parallel training "
+                  "benchmarks", false, "", 4);
+  parser.add<string>("tag", 0, "label of the results, e.g. the commit", false,
+                     "", "");
+  parser.add<string>("output", 'o', "path to write the json results, stdout "
+                                    "if not specified",
+                     false, "", "");
+  parser.add("help", 'h', "print this message");
+  bool ok = parser.parse(argc, argv);
+  if (!ok || parser.exist("help")) {
+    fprintf(stderr, "%s\n%s\n", parser.error().c_str(),
+            parser.usage().c_str());
+    return ok ? 0 : 1;
+  }
+  if (parser.get<int>("data-num") <= 0 || parser.get<int>("dim") <= 1 ||
+      parser.get<int>("feat-num") <= 0 || parser.get<int>("threads") <= 1) {
+    fprintf(stderr, "data-num and feat-num should be positive, dim and "
+                    "threads > 1\n");
+    return 1;
+  }
+
+  vector<DataPoint> data;
+  sol::bench::GenerateData(size_t(parser.get<int>("data-num")),
+                           sol::index_t(parser.get<int>("dim")),
+                           size_t(parser.get<int>("feat-num")), 1, data);
+
+  sol::bench::Runner runner(parser.get<double>("min-time"),
+                            parser.get<string>("filter"));
+  sol::bench::BenchPario(runner, data);
+  sol::bench::BenchMath(runner, data);
+  sol::bench::BenchModel(runner, data);
+  sol::bench::BenchParallel(runner, data, parser.get<int>("threads"));
+
+  const string& output = parser.get<string>("output");
+  if (output.empty()) {
+    runner.Write(cout, parser.get<string>("tag"));
+  } else {
+    ofstream out_file(output.c_str(), ios::out);
+    if (!out_file) {
+      fprintf(stderr, "open file %s failed\n", output.c_str());
+      return 1;
+    }
+    runner.Write(out_file, parser.get<string>("tag"));
+  }
+  return 0;
+}
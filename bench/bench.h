@@ -0,0 +1,98 @@
+/*********************************************************************************
+*     File Name           :     bench.h
+*     Created By          :     yuewu
+*     Description         :     micro-benchmark harness
+**********************************************************************************/
+
+#ifndef SOL_BENCH_BENCH_H__
+#define SOL_BENCH_BENCH_H__
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include <sol/pario/data_point.h>
+
+namespace sol {
+namespace bench {
+
+/// \brief  runs the benchmarks and collects the results in json
+class Runner {
+ public:
+  /// \brief  create a runner
+  ///
+  /// \param min_time minimum seconds to repeat each benchmark
+  /// \param filter only the benchmarks whose names contain it are run
+  Runner(double min_time, const std::string& filter);
+
+  /// \brief  whether a benchmark should be run
+  bool Selected(const std::string& name) const;
+
+  /// \brief  run a benchmark repeatedly for at least min_time seconds after
+  // one warm-up run
+  ///
+  /// \param name name of the benchmark, e.g. 'pario/svm_parse'
+  /// \param func function to run once, returns the number of items processed
+  /// \param bytes bytes processed by each run, 0 if not applicable
+  void Run(const std::string& name, const std::function<size_t()>& func,
+           size_t bytes = 0);
+
+  /// \brief  record the speedup of a benchmark over a baseline benchmark run
+  // before, i.e. the ratio of the items processed per second, ignored if
+  // either is not run
+  void Speedup(const std::string& name, const std::string& base_name);
+
+  /// \brief  record a benchmark which can not be run
+  void Fail(const std::string& name, const std::string& error);
+
+  /// \brief  write the results in json
+  ///
+  /// \param os output stream
+  /// \param tag label of the results, e.g. the commit, ignored if empty
+  void Write(std::ostream& os, const std::string& tag) const;
+
+ private:
+  double min_time_;
+  std::string filter_;
+  Json::Value results_;
+};  // class Runner
+
+/// \brief  sink of the results of the benchmarks
+extern volatile double g_sink;
+
+/// \brief  keep a value computed by a benchmark from being optimized out
+inline void DoNotOptimize(double value) { g_sink = value; }
+
+/// \brief  generate random sparse data of binary labels separated by a
+// random hyperplane, the indexes of each data point are sorted
+///
+/// \param data_num number of data points
+/// \param dim dimension of the features, the indexes are in [1, dim)
+/// \param feat_num number of features of each data point
+/// \param seed random seed
+/// \param data generated data
+void GenerateData(size_t data_num, index_t dim, size_t feat_num,
+                  unsigned int seed, std::vector<pario::DataPoint>& data);
+
+/// \brief  benchmarks of the data readers, index compression and the
+// mini-batch queue
+void BenchPario(Runner& runner, const std::vector<pario::DataPoint>& data);
+
+/// \brief  benchmarks of the sparse kernels
+void BenchMath(Runner& runner, const std::vector<pario::DataPoint>& data);
+
+/// \brief  benchmarks of Iterate of all the registered models
+void BenchModel(Runner& runner, const std::vector<pario::DataPoint>& data);
+
+/// \brief  benchmarks of training by parameter mixing with multiple threads,
+// and the speedups over training with a single thread
+void BenchParallel(Runner& runner, const std::vector<pario::DataPoint>& data,
+                   int thread_num);
+
+}  // namespace bench
+}  // namespace sol
+
+#endif
@@ -0,0 +1,43 @@
+/*********************************************************************************
+*     File Name           :     bench_math.cc
+*     Created By          :     yuewu
+*     Description         :     benchmarks of the sparse kernels
+**********************************************************************************/
+#include "bench.h"
+
+#include <sol/math/vector.h>
+
+using namespace std;
+using namespace sol::math;
+using namespace sol::pario;
+
+namespace sol {
+namespace bench {
+
+void BenchMath(Runner& runner, const vector<DataPoint>& data) {
+  index_t dim = 0;
+  size_t feat_num = 0;
+  for (const DataPoint& x : data) {
+    dim = (std::max)(dim, x.dim());
+    feat_num += x.size();
+  }
+  Vector<real_t> w(dim);
+  w = 0.01f;
+
+  runner.Run("math/dotmul", [&]() {
+    real_t sum = 0;
+    for (const DataPoint& x : data) sum += expr::dotmul(w, x.data());
+    DoNotOptimize(sum);
+    return feat_num;
+  });
+
+  // the update of the weights by the gradients of OGD
+  runner.Run("math/sparse_update", [&]() {
+    for (const DataPoint& x : data) w -= 1e-6f * x.label() * x.data();
+    DoNotOptimize(w[1]);
+    return feat_num;
+  });
+}
+
+}  // namespace bench
+}  // namespace sol
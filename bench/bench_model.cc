@@ -0,0 +1,83 @@
+/*********************************************************************************
+*     File Name           :     bench_model.cc
+*     Created By          :     yuewu
+*     Description         :     benchmarks of the online models
+**********************************************************************************/
+#include "bench.h"
+
+#include <memory>
+#include <stdexcept>
+
+#include <sol/model/online_model.h>
+#include <sol/pario/data_arena.h>
+#include <sol/util/reflector.h>
+#include <sol/util/str_util.h>
+
+using namespace std;
+using namespace sol::model;
+using namespace sol::pario;
+
+namespace sol {
+namespace bench {
+
+void BenchModel(Runner& runner, const vector<DataPoint>& data) {
+  // models are registered as 'name_model'
+  ClassFactory::ClsInfoMapType info_map = ClassFactory::ClassInfoMap();
+  for (auto& pair : info_map) {
+    const vector<string>& parts = split(pair.first, '_');
+    if (parts.size() != 2 || parts[1] != "model") continue;
+    const string& name = "model/" + parts[0] + "/iterate";
+    if (!runner.Selected(name)) continue;
+
+    unique_ptr<Model> model(Model::Create(parts[0], 2));
+    OnlineModel* online_model = dynamic_cast<OnlineModel*>(model.get());
+    if (online_model == nullptr) {
+      runner.Fail(name, "not an online model");
+      continue;
+    }
+    try {
+      online_model->BeginTrain();
+    }
+    catch (invalid_argument& err) {
+      runner.Fail(name, err.what());
+      continue;
+    }
+
+    vector<float> predicts(online_model->clf_num());
+    runner.Run(name, [&]() {
+      for (const DataPoint& x : data) online_model->Iterate(x, predicts.data());
+      return data.size();
+    });
+  }
+}
+
+void BenchParallel(Runner& runner, const vector<DataPoint>& data,
+                   int thread_num) {
+  DataArena arena;
+  for (const DataPoint& x : data) arena.Append(x);
+  vector<size_t> rows(arena.size());
+  for (size_t i = 0; i < rows.size(); ++i) rows[i] = i;
+
+  // one pass of training by parameter mixing, compared with the single
+  // thread training of the same model on the same data
+  for (const char* algo : {"ogd", "arow", "cw"}) {
+    const string& prefix = string("model/") + algo + "/train_threads";
+    for (int threads : {1, thread_num}) {
+      runner.Run(prefix + to_string(threads), [&]() {
+        unique_ptr<Model> model(Model::Create(algo, 2));
+        OnlineModel* online_model = dynamic_cast<OnlineModel*>(model.get());
+        online_model->set_iterate_callback(nullptr, nullptr);
+        model->SetParameter("threads", to_string(threads));
+        model->SetParameter("parallel", "mix");
+        ArenaIter iter(arena, rows);
+        model->Train(iter, nullptr, nullptr, nullptr, nullptr, nullptr,
+                     nullptr);
+        return arena.size();
+      });
+    }
+    runner.Speedup(prefix + to_string(thread_num), prefix + "1");
+  }
+}
+
+}  // namespace bench
+}  // namespace sol
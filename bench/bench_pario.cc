@@ -0,0 +1,127 @@
+/*********************************************************************************
+*     File Name           :     bench_pario.cc
+*     Created By          :     yuewu
+*     Description         :     benchmarks of readers, compression and queues
+**********************************************************************************/
+#include "bench.h"
+
+#include <cstdio>
+#include <memory>
+
+#include <sol/pario/compress.h>
+#include <sol/pario/data_reader.h>
+#include <sol/pario/data_writer.h>
+#include <sol/pario/mini_batch.h>
+#include <sol/util/block_queue.h>
+#include <sol/util/error_code.h>
+#include <sol/util/thread_task.h>
+#include <sol/util/util.h>
+
+using namespace std;
+using namespace sol::math;
+using namespace sol::pario;
+
+namespace sol {
+namespace bench {
+
+/// \brief  write the data to a file
+///
+/// \return size of the file in bytes, 0 if failed
+static size_t WriteData(const vector<DataPoint>& data, const string& type,
+                        const string& path) {
+  unique_ptr<DataWriter> writer(DataWriter::Create(type));
+  if (writer == nullptr || writer->Open(path) != Status_OK) return 0;
+  if (type == "csv") {
+    index_t dim = 0;
+    for (const DataPoint& x : data) dim = (std::max)(dim, x.dim());
+    writer->SetExtraInfo((const char*)(&dim));
+  }
+  for (const DataPoint& x : data) {
+    if (writer->Write(x) != Status_OK) return 0;
+  }
+  writer->Close();
+
+  FILE* file = open_file(path.c_str(), "rb");
+  if (file == nullptr) return 0;
+  fseek(file, 0, SEEK_END);
+  size_t size = size_t(ftell(file));
+  fclose(file);
+  return size;
+}
+
+/// \brief  parse all the data of a file
+///
+/// \return number of data parsed
+static size_t ReadData(const string& type, const string& path) {
+  unique_ptr<DataReader> reader(DataReader::Create(type));
+  if (reader == nullptr || reader->Open(path) != Status_OK) return 0;
+  DataPoint x;
+  size_t data_num = 0;
+  while (reader->Next(x) == Status_OK) ++data_num;
+  reader->Close();
+  return data_num;
+}
+
+void BenchPario(Runner& runner, const vector<DataPoint>& data) {
+  // parsers, the csv data are dense and of a lower dimension
+  vector<DataPoint> dense_data;
+  GenerateData(data.size() / 4 + 1, 257, 64, 2, dense_data);
+  const char* types[] = {"svm", "bin", "csv"};
+  for (const char* type : types) {
+    const string& name = string("pario/parse_") + type;
+    if (!runner.Selected(name)) continue;
+    const string& path = string("sol_bench_data.") + type;
+    size_t bytes =
+        WriteData(string(type) == "csv" ? dense_data : data, type, path);
+    if (bytes == 0) {
+      runner.Fail(name, "write data to " + path + " failed");
+      continue;
+    }
+    runner.Run(name, [&]() { return ReadData(type, path); }, bytes);
+    remove(path.c_str());
+  }
+
+  // index compression of each data point
+  runner.Run("pario/comp_index", [&data]() {
+    Vector<char> codes;
+    size_t index_num = 0;
+    for (const DataPoint& x : data) {
+      codes.clear();
+      comp_index(x.indexes(), codes);
+      index_num += x.size();
+    }
+    return index_num;
+  });
+
+  vector<Vector<char>> codes_list(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    comp_index(data[i].indexes(), codes_list[i]);
+  }
+  runner.Run("pario/decomp_index", [&codes_list]() {
+    Vector<index_t> indexes;
+    size_t index_num = 0;
+    for (const Vector<char>& codes : codes_list) {
+      decomp_index(codes, indexes);
+      index_num += indexes.size();
+    }
+    return index_num;
+  });
+
+  // mini-batches handed from a reader thread to the trainer through a queue
+  // of the default buffer size of the data iterator
+  runner.Run("pario/block_queue_handoff", []() {
+    const size_t item_num = 100000;
+    MiniBatch mb;
+    BlockQueue<MiniBatch*> queue(2);
+    FunctionTask producer([&queue, &mb, item_num]() {
+      for (size_t i = 0; i < item_num; ++i) queue.Enqueue(&mb);
+    });
+    producer.Start();
+    for (size_t i = 0; i < item_num; ++i) queue.Dequeue();
+    producer.Join();
+    return item_num;
+  });
+}
+
+}  // namespace bench
+}  // namespace sol
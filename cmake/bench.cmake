@@ -0,0 +1,20 @@
+option(BUILD_BENCH "build the micro-benchmarks in bench/" ON)
+
+if (BUILD_BENCH)
+    file(GLOB bench_src
+        "${PROJECT_SOURCE_DIR}/bench/*.cpp"
+        "${PROJECT_SOURCE_DIR}/bench/*.cc"
+        )
+
+    add_executable(sol_bench ${bench_src})
+    target_link_libraries(sol_bench sol ${LINK_LIBS})
+    SET_PROPERTY(TARGET sol_bench PROPERTY FOLDER "bench")
+
+    # run the benchmarks and write the results to bench.json
+    add_custom_target(bench
+        COMMAND sol_bench --output ${CMAKE_BINARY_DIR}/bench.json
+        DEPENDS sol_bench
+        WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+        COMMENT "Running the benchmarks"
+        )
+endif()
@@ -1,4 +1,4 @@
-set(src_dirs util math pario loss model model/olm)
+set(src_dirs util math pario loss model model/olm dist)
 foreach (src_dir ${src_dirs})
     file(GLOB ${src_dir}_headers
         "${PROJECT_SOURCE_DIR}/include/sol/${src_dir}/*.h"
@@ -16,6 +16,13 @@ foreach (src_dir ${src_dirs})
     list(APPEND sol_list ${${src_dir}_headers} ${${src_dir}_src})
 endforeach()
 
+# the batch gradients of loss functions are vectorized only if floating point
+# comparisons are assumed not to trap
+if (CMAKE_CXX_COMPILER_ID MATCHES "Clang" OR CMAKE_CXX_COMPILER_ID MATCHES "GNU")
+    set_source_files_properties(${loss_src} PROPERTIES COMPILE_FLAGS
+        -fno-trapping-math)
+endif()
+
 file(GLOB json_files
 	"${PROJECT_SOURCE_DIR}/external/json/*.h"
 	"${PROJECT_SOURCE_DIR}/external/json/*.cpp"
@@ -29,6 +36,10 @@ add_library(sol SHARED ${sol_list}
     ${PROJECT_SOURCE_DIR}/src/sol/c_api.cc
     ${PROJECT_SOURCE_DIR}/src/sol/tools.cc
     )
+# shm_open of the shared memory transport
+if (UNIX AND NOT APPLE)
+    list(APPEND LINK_LIBS rt)
+endif()
 target_link_libraries(sol ${LINK_LIBS})
 list(APPEND TARGET_LIBS sol)
 
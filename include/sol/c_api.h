@@ -51,6 +51,22 @@ SOL_EXPORTS void sol_ReleaseDataIter(void** data_iter);
 SOL_EXPORTS int sol_LoadData(void* data_iter, const char* path,
                              const char* format, int pass_num);
 
+/// \brief  add transforms applied to the data on the reader threads, should
+// be called before iterating the data
+///
+/// \param data_iter data iteration instance
+/// \param spec transforms in the format 'name:param=val,...;name:param=val'
+///
+/// \return status code, 0 if succeed
+SOL_EXPORTS int sol_AddTransform(void* data_iter, const char* spec);
+
+/// \brief  preprocess the data of a model (normalization, feature filtering)
+// on the reader threads, should be called before iterating the data
+///
+/// \param data_iter data iteration instance
+/// \param model model to consume the data, should be alive when iterating
+SOL_EXPORTS void sol_AddPreProcess(void* data_iter, void* model);
+
 /// \brief  create a new model for learning or prediction
 ///
 /// \param name name of the model (algorithm)
@@ -128,6 +144,22 @@ SOL_EXPORTS float sol_Train(void* model, void* data_iter, long long* data_no, lo
 SOL_EXPORTS float sol_Test(void* model, void* data_iter,
 	const char* output_path, float* tpr_fig, float*fpr_fig, float* tpr_tab, float* fpr_tab, float* auc);
 
+/// \brief  test a model and evaluate the predicted results
+///
+/// \param model model to be tested
+/// \param data_iter data iterator
+/// \param approx whether to compute AUC approximately with bounded memory
+/// \param thread_num number of testing threads, only online linear models
+/// support multiple threads
+/// \param auc area under the ROC curve of binary classification, ignored if
+/// NULL
+/// \param log_loss average logistic loss (binary) or cross entropy
+/// (multi-class), ignored if NULL
+///
+/// \return test error rate
+SOL_EXPORTS float sol_Evaluate(void* model, void* data_iter, int approx,
+                               int thread_num, float* auc, float* log_loss);
+
 /// \brief  C type to predict detailed scores
 ///
 /// \param user_context flexible place to handle predicted results
@@ -150,6 +182,74 @@ typedef void (*sol_predict_callback)(void* user_context, double label,
 SOL_EXPORTS int sol_Predict(void* model, void* data_iter,
                             sol_predict_callback callback, void* user_context);
 
+/// \brief  predict the scores on the given data with the latest weight
+/// snapshot of an online linear model, which can be called by any number of
+/// threads while the model is trained, see the "snapshot_interval" and
+/// "snapshot_ms" parameters
+///
+/// \param model model in training
+/// \param data_iter data iterator, not preprocessed by the model
+/// \param callback callback to handle the predicted results
+/// \param user_context flexible place to handle predicted results
+///
+/// \return number of samples processed, -1 if no snapshot is published
+SOL_EXPORTS int sol_PredictSnapshot(void* model, void* data_iter,
+                                    sol_predict_callback callback,
+                                    void* user_context);
+
+/// \brief  predict the scores of the rows of a CSR matrix directly into the
+/// given buffers, column j of the matrix is feature j + 1 as in
+/// sol_loadCsrMatrix. The model should be an online linear model, and should
+/// not be trained or released during the call. The model is not modified, so
+/// the calls can be made concurrently, no python objects are accessed so the
+/// GIL can be released.
+///
+/// \param model model to predict
+/// \param indptr offsets of the rows in indices and data, n_samples + 1
+/// \param indices column indexes of the values
+/// \param index_size size of the elements of indptr and indices, 4 or 8
+/// \param data values of the matrix
+/// \param data_size size of the elements of data, 4 (float) or 8 (double)
+/// \param n_samples number of rows
+/// \param scores buffer of the predicted scores, n_samples by classifier
+/// number
+/// \param predicts buffer of the predicted labels, ignored if NULL
+///
+/// \return status code, 0 if succeed
+SOL_EXPORTS int sol_PredictCsr(void* model, const void* indptr,
+                               const void* indices, int index_size,
+                               const void* data, int data_size,
+                               long long n_samples, float* scores,
+                               double* predicts);
+
+/// \brief  predict the scores of the rows of a dense matrix directly into the
+/// given buffers, column j of the matrix is feature j + 1 as in
+/// sol_loadArray, see sol_PredictCsr
+///
+/// \param model model to predict
+/// \param X first element of the matrix
+/// \param data_size size of the elements of X, 4 (float) or 8 (double)
+/// \param n_samples number of rows
+/// \param n_features number of columns
+/// \param row_stride distance between the rows in bytes
+/// \param scores buffer of the predicted scores, n_samples by classifier
+/// number
+/// \param predicts buffer of the predicted labels, ignored if NULL
+///
+/// \return status code, 0 if succeed
+SOL_EXPORTS int sol_PredictDense(void* model, const void* X, int data_size,
+                                 long long n_samples, long long n_features,
+                                 long long row_stride, float* scores,
+                                 double* predicts);
+
+/// \brief  get the number of classifiers of the model, which is the number of
+/// scores of each sample
+///
+/// \param model pretrained model
+///
+/// \return number of classifiers
+SOL_EXPORTS int sol_GetClfNum(void* model);
+
 /// \brief  get the model sparsity
 ///
 /// \param model pretrained model
@@ -157,6 +257,27 @@ SOL_EXPORTS int sol_Predict(void* model, void* data_iter,
 /// \return model sparsity
 SOL_EXPORTS float sol_model_sparsity(void* model);
 
+/// \brief  C type to handle the memory of a component of a model
+///
+/// \param user_context flexible place to handle the memory
+/// \param name name of the component, e.g. 'weight[0]'
+/// \param used bytes of the elements in use
+/// \param allocated bytes allocated, including the slack reserved by the
+/// growth of the arrays
+typedef void (*sol_memory_callback)(void* user_context, const char* name,
+                                    long long used, long long allocated);
+
+/// \brief  get the memory of the states of a model
+///
+/// \param model model
+/// \param callback callback to handle the memory of each component, ignored
+/// if NULL
+/// \param user_context flexible place to handle the memory
+///
+/// \return total bytes allocated by the model
+SOL_EXPORTS long long sol_MemoryUsage(void* model, sol_memory_callback callback,
+                                      void* user_context);
+
 /// \brief  C type to inspect iteration callback
 ///
 /// \param user_context flexible place to handle iteration status
@@ -178,6 +299,137 @@ typedef void (*sol_inspect_iterate_callback)(void* user_context,
 SOL_EXPORTS void sol_InspectOnlineIteration(
     void* model, sol_inspect_iterate_callback callback, void* user_context);
 
+/// \brief  C type to inspect the weight budget callback
+///
+/// \param user_context flexible place to handle the budget status
+/// \param iter_num number of iterations currently
+/// \param active_num number of features with non-zero weights
+/// \param evict_num number of features evicted so far
+typedef void (*sol_inspect_budget_callback)(void* user_context,
+                                            long long iter_num,
+                                            long long active_num,
+                                            long long evict_num);
+
+/// \brief  Inspect the weight budget ("budget" parameter) of an online linear
+// model, the callback is called along with the iteration callback
+///
+/// \param model model
+/// \param callback callback to handle the budget status, NULL to disable
+/// \param user_context flexible place to handle the budget status
+///
+/// \return status code, Status_Invalid_Argument if the model is not an
+// online linear model
+SOL_EXPORTS int sol_InspectBudget(void* model,
+                                  sol_inspect_budget_callback callback,
+                                  void* user_context);
+
+/// \brief  counters of the stages of the training pipeline summed over the
+/// threads, times are in nanoseconds
+typedef struct sol_stats {
+  /// time of the readers to parse the data
+  unsigned long long parse_ns;
+  /// number of data parsed
+  unsigned long long parse_num;
+  /// bytes read from the data files
+  unsigned long long read_bytes;
+  /// time of the readers waiting for free mini-batches
+  unsigned long long reader_wait_ns;
+  /// time of the trainers waiting for parsed mini-batches
+  unsigned long long trainer_wait_ns;
+  /// time to predict the data in training
+  unsigned long long predict_ns;
+  /// time to compute the losses and gradients
+  unsigned long long loss_ns;
+  /// time to update the models
+  unsigned long long update_ns;
+  /// number of model arrays reallocated to expand the dimension
+  unsigned long long realloc_num;
+  /// bytes of the reallocated model arrays
+  unsigned long long realloc_bytes;
+} sol_stats;
+
+/// \brief  enable or disable the pipeline counters of all the models and data
+/// iterators in the process, the counters are disabled by default and cost
+/// nothing then
+///
+/// \param enable whether to enable the counters
+SOL_EXPORTS void sol_EnableStats(int enable);
+
+/// \brief  get the pipeline counters summed over the threads
+///
+/// \param stats destination of the counters
+SOL_EXPORTS void sol_GetStats(sol_stats* stats);
+
+/// \brief  reset the pipeline counters to zero, should not be called while
+/// training
+SOL_EXPORTS void sol_ResetStats();
+
+/// \brief  C type to handle the training curves of sol_TrainModels
+///
+/// \param user_context flexible place to handle the curves
+/// \param model_id index of the model in the models
+/// \param data_num number of data processed currently
+/// \param iter_num number of iterations currently
+/// \param update_num number of updates currently
+/// \param err_rate training error rate currently
+/// \param time training time in seconds currently
+typedef void (*sol_train_curve_callback)(void* user_context, int model_id,
+                                         long long data_num,
+                                         long long iter_num,
+                                         long long update_num,
+                                         double err_rate, double time);
+
+/// \brief  train multiple models concurrently with one pass of the data, each
+/// mini-batch is parsed once and trained by all the models
+///
+/// \param models models to be trained
+/// \param model_num number of models
+/// \param data_iter data iterator
+/// \param err_rates training error rates of the models, ignored if NULL
+/// \param callback callback to handle the training curves of the models
+/// after training, ignored if NULL
+/// \param user_context flexible place to handle the curves
+///
+/// \return status code, 0 if succeed
+SOL_EXPORTS int sol_TrainModels(void** models, int model_num, void* data_iter,
+                                float* err_rates,
+                                sol_train_curve_callback callback,
+                                void* user_context);
+
+/// \brief  C type to handle the results of sol_CrossValidate
+///
+/// \param user_context flexible place to handle the results
+/// \param params parameter setting, in the format 'param=val;param=val;...'
+/// \param fold_id index of the validation fold
+/// \param train_accu training accuracy on the other folds
+/// \param val_accu validation accuracy on the fold
+typedef void (*sol_cv_callback)(void* user_context, const char* params,
+                                int fold_id, double train_accu,
+                                double val_accu);
+
+/// \brief  k-fold cross validation of a grid of parameters, the data are
+/// loaded in memory once and split into folds the same as sol_split_data
+///
+/// \param algo name of the algorithm
+/// \param class_num number of classes
+/// \param data_iter data iterator, all the data are loaded before validation
+/// \param fold_num number of folds
+/// \param grid parameters to search, 'param=v1,v2;param=v1,v2;...'
+/// \param params fixed parameters, 'param=val;param=val;...'
+/// \param pass_num number of passes over the training folds
+/// \param thread_num number of threads
+/// \param shuffle whether to shuffle the data before splitting
+/// \param callback callback to handle the results of each setting and fold
+/// \param user_context flexible place to handle the results
+///
+/// \return status code, 0 if succeed
+SOL_EXPORTS int sol_CrossValidate(const char* algo, int class_num,
+                                  void* data_iter, int fold_num,
+                                  const char* grid, const char* params,
+                                  int pass_num, int thread_num, int shuffle,
+                                  sol_cv_callback callback,
+                                  void* user_context);
+
 #ifdef HAS_NUMPY_DEV
 #include <Python.h>
 #include <numpy/arrayobject.h>
@@ -0,0 +1,74 @@
+/*********************************************************************************
+*     File Name           :     coordinator.h
+*     Created By          :     yuewu
+*     Description         :     coordinator of data-parallel training workers
+**********************************************************************************/
+
+#ifndef SOL_DIST_COORDINATOR_H__
+#define SOL_DIST_COORDINATOR_H__
+
+#include <vector>
+
+#include <sol/math/vector.h>
+#include <sol/util/types.h>
+#include <sol/dist/transport.h>
+
+namespace sol {
+namespace dist {
+
+/// \brief  coordinator of the workers training a model data-parallel, each
+// worker trains on its own shard and the workers synchronize the models
+// periodically by averaging the deltas since the last synchronization
+class SOL_EXPORTS Coordinator {
+ public:
+  /// \brief  constructor
+  ///
+  /// \param transport transport among the workers, not owned
+  /// \param sync_interval number of local instances between
+  // synchronizations, 0 to synchronize at the end only
+  Coordinator(Transport* transport, size_t sync_interval);
+
+  int rank() const { return this->transport_->rank(); }
+  int worker_num() const { return this->transport_->size(); }
+  size_t sync_interval() const { return this->sync_interval_; }
+
+  /// \brief  whether the mini-batch belongs to the shard of the worker
+  bool Owns(size_t batch_no) const {
+    return int(batch_no % this->worker_num()) == this->rank();
+  }
+
+  /// \brief  get the max dimension of the models on the workers
+  index_t MaxDim(index_t dim);
+
+  /// \brief  average the deltas of the states over the workers having updated
+  // their models since the last synchronization
+  ///
+  /// \param states states of the model, replaced with the averaged states
+  /// \param snapshots states after the last synchronization, which are the
+  // same on all the workers
+  /// \param updated whether the worker updated the model
+  ///
+  /// \return number of workers having updated their models
+  int AverageDeltas(const std::vector<math::Vector<real_t>*>& states,
+                    const std::vector<math::Vector<real_t>*>& snapshots,
+                    bool updated);
+
+  /// \brief  sum the progress counters over the workers
+  ///
+  /// \param counters counters of the worker, replaced with the sums
+  /// \param finished whether the worker finished its shard
+  ///
+  /// \return whether all the workers finished their shards
+  bool SumProgress(std::vector<double>& counters, bool finished);
+
+ protected:
+  Transport* transport_;
+  size_t sync_interval_;
+  // buffer of the deltas
+  math::Vector<real_t> delta_;
+};
+
+}  // namespace dist
+}  // namespace sol
+
+#endif
@@ -0,0 +1,81 @@
+/*********************************************************************************
+*     File Name           :     shm_transport.h
+*     Created By          :     yuewu
+*     Description         :     transport through posix shared memory
+**********************************************************************************/
+
+#ifndef SOL_DIST_SHM_TRANSPORT_H__
+#define SOL_DIST_SHM_TRANSPORT_H__
+
+#include <string>
+
+#include <sol/util/types.h>
+#include <sol/util/util.h>
+#include <sol/dist/transport.h>
+
+namespace sol {
+namespace dist {
+
+/// \brief  transport among the processes on the same host through a named
+// posix shared memory segment, each worker owns a slot of the segment and the
+// workers synchronize with a barrier on the segment
+class SOL_EXPORTS ShmTransport : public Transport {
+ public:
+  /// \brief  default size of the slot of each worker, in bytes
+  static const size_t kDefaultSlotSize = 1 << 22;
+
+  ShmTransport();
+  virtual ~ShmTransport();
+
+  /// \brief  create (rank 0) or attach to (other ranks) the segment, and
+  // wait until all the workers are attached
+  ///
+  /// \param name name of the segment, shared by the workers of a job
+  /// \param rank rank of the current worker
+  /// \param size number of workers
+  /// \param slot_size size of the slot of each worker, in bytes
+  ///
+  /// \return status code, Status_OK if succeed
+  int Open(const std::string& name, int rank, int size,
+           size_t slot_size = kDefaultSlotSize);
+
+  /// \brief  detach from the segment
+  void Close();
+
+ public:
+  virtual int rank() const { return this->rank_; }
+  virtual int size() const { return this->size_; }
+
+  virtual void Barrier();
+
+  virtual void AllReduce(float* data, size_t count, ReduceOp op);
+  virtual void AllReduce(double* data, size_t count, ReduceOp op);
+
+ private:
+  template <typename T>
+  void AllReduceImpl(T* data, size_t count, ReduceOp op);
+
+  char* slot(int rank) { return this->slots_ + rank * this->slot_size_; }
+
+  struct Header;
+  /// \brief  attach to the segment initialized by rank 0 of the current job,
+  // skipping the stale segments left by aborted jobs
+  ///
+  /// \return header of the segment, nullptr if not ready before timeout
+  Header* Attach(const std::string& shm_name, size_t map_size);
+
+ private:
+  Header* header_;
+  char* slots_;
+  size_t slot_size_;
+  size_t map_size_;
+  int rank_;
+  int size_;
+
+  DISABLE_COPY_AND_ASSIGN(ShmTransport);
+};
+
+}  // namespace dist
+}  // namespace sol
+
+#endif
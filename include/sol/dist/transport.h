@@ -0,0 +1,50 @@
+/*********************************************************************************
+*     File Name           :     transport.h
+*     Created By          :     yuewu
+*     Description         :     collective communication among training workers
+**********************************************************************************/
+
+#ifndef SOL_DIST_TRANSPORT_H__
+#define SOL_DIST_TRANSPORT_H__
+
+#include <cstddef>
+
+namespace sol {
+namespace dist {
+
+/// \brief  reduction operators of AllReduce
+enum ReduceOp {
+  kReduceSum = 0,
+  kReduceMax = 1,
+};
+
+/// \brief  transport among the workers of a training job, all the
+// operations are collective and must be called by every worker in the same
+// order
+class Transport {
+ public:
+  virtual ~Transport() {}
+
+  /// \brief  rank of the current worker, in [0, size)
+  virtual int rank() const = 0;
+  /// \brief  number of workers
+  virtual int size() const = 0;
+
+  /// \brief  block until all the workers reach the barrier
+  virtual void Barrier() = 0;
+
+  /// \brief  reduce the buffers of all workers element-wise and put the
+  // result on all the workers, the buffers are reduced in the order of the
+  // ranks so that all the workers get the same result
+  ///
+  /// \param data buffer to reduce
+  /// \param count number of elements
+  /// \param op reduction operator
+  virtual void AllReduce(float* data, size_t count, ReduceOp op) = 0;
+  virtual void AllReduce(double* data, size_t count, ReduceOp op) = 0;
+};
+
+}  // namespace dist
+}  // namespace sol
+
+#endif
@@ -22,6 +22,10 @@ class SOL_EXPORTS BoolLoss : public Loss {
   virtual float gradient(const pario::DataPoint& dp, float* predict,
                          label_t predict_label, float* gradient, int cls_num);
 
+  virtual void BatchGradient(const label_t* labels, const float* predicts,
+                             const label_t* predict_labels, float* gradients,
+                             float* losses, size_t data_num, int cls_num);
+
 };  // class BoolLoss
 
 class SOL_EXPORTS MaxScoreBoolLoss : public Loss {
@@ -34,6 +38,10 @@ class SOL_EXPORTS MaxScoreBoolLoss : public Loss {
 
   virtual float gradient(const pario::DataPoint& dp, float* predict,
                          label_t predict_label, float* gradient, int cls_num);
+
+  virtual void BatchGradient(const label_t* labels, const float* predicts,
+                             const label_t* predict_labels, float* gradients,
+                             float* losses, size_t data_num, int cls_num);
 };
 
 class SOL_EXPORTS UniformBoolLoss : public Loss {
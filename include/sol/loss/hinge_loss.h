@@ -41,6 +41,10 @@ class SOL_EXPORTS HingeLoss : public HingeBase {
   virtual float gradient(const pario::DataPoint& dp, float* predict,
                          label_t predict_label, float* gradient, int cls_num);
 
+  virtual void BatchGradient(const label_t* labels, const float* predicts,
+                             const label_t* predict_labels, float* gradients,
+                             float* losses, size_t data_num, int cls_num);
+
 };  // class HingeLoss
 
 class SOL_EXPORTS MaxScoreHingeLoss : public HingeBase {
@@ -53,6 +57,10 @@ class SOL_EXPORTS MaxScoreHingeLoss : public HingeBase {
 
   virtual float gradient(const pario::DataPoint& dp, float* predict,
                          label_t predict_label, float* gradient, int cls_num);
+
+  virtual void BatchGradient(const label_t* labels, const float* predicts,
+                             const label_t* predict_labels, float* gradients,
+                             float* losses, size_t data_num, int cls_num);
 };
 
 class SOL_EXPORTS UniformHingeLoss : public HingeBase {
@@ -37,6 +37,23 @@ class SOL_EXPORTS Loss {
 
   inline static char Sign(float x) { return x >= 0.f ? 1 : -1; }
 
+  /// \brief  get the class with the max prediction except the true label
+  ///
+  /// \param predict prediction on each class
+  /// \param label true label
+  /// \param predict_label predicted label, i.e. the class with the max
+  // prediction
+  /// \param cls_num number of classes
+  inline static label_t MaxWrongLabel(const float* predict, label_t label,
+                                      label_t predict_label, int cls_num) {
+    if (predict_label != label) return predict_label;
+    label_t max_label = label == 0 ? 1 : 0;
+    for (int c = max_label + 1; c < cls_num; ++c) {
+      if (c != label && predict[c] > predict[max_label]) max_label = c;
+    }
+    return max_label;
+  }
+
  public:
   Loss(int type) : type_(type) {}
   virtual ~Loss() {}
@@ -68,6 +85,21 @@ class SOL_EXPORTS Loss {
                          label_t predict_label, float* gradient,
                          int cls_num) = 0;
 
+  /// \brief  calculate the losses and gradients of a batch of instances,
+  // the default implementation calls gradient on each instance
+  ///
+  /// \param labels labels of the instances
+  /// \param predicts predictions on each class, cls_num values per instance
+  /// \param predict_labels predicted labels of the instances
+  /// \param gradients resulted gradients on each class (without x),
+  // cls_num values per instance
+  /// \param losses resulted losses of the instances
+  /// \param data_num number of instances
+  /// \param cls_num number of classes
+  virtual void BatchGradient(const label_t* labels, const float* predicts,
+                             const label_t* predict_labels, float* gradients,
+                             float* losses, size_t data_num, int cls_num);
+
  public:
   const std::string& name() const { return name_; }
   void set_name(const std::string& name) { this->name_ = name; }
@@ -23,6 +23,10 @@ class SOL_EXPORTS SquareLoss : public Loss {
   virtual float gradient(const pario::DataPoint& dp, float* predict,
                          label_t predict_label, float* gradient, int cls_num);
 
+  virtual void BatchGradient(const label_t* labels, const float* predicts,
+                             const label_t* predict_labels, float* gradients,
+                             float* losses, size_t data_num, int cls_num);
+
 };  // class SquareLoss
 }  // namespace loss
 }  // namespace sol
@@ -0,0 +1,64 @@
+/*********************************************************************************
+*     File Name           :     fast_math.h
+*     Created By          :     yuewu
+*     Description         :     branch-free approximations of elementary
+*                               functions, vectorizable by the compiler
+**********************************************************************************/
+
+#ifndef SOL_MATH_FAST_MATH_H__
+#define SOL_MATH_FAST_MATH_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace sol {
+namespace math {
+
+/// \brief  approximation of exp(x), the relative error is below 5e-7, x is
+// clamped to [-87, 88] so that the result is a normal float
+inline float fast_exp(float x) {
+  x = (std::min)((std::max)(x, -87.f), 88.f);
+  // x = n * ln2 + r, |r| <= ln2 / 2, n is rounded by adding 1.5 * 2^23
+  float fn = (x * 1.44269504f + 12582912.f) - 12582912.f;
+  float r = x - fn * 0.693359375f + fn * 2.12194440e-4f;
+  float p = 1.f + r * (1.f + r * (0.5f + r * (1.66666672e-1f +
+            r * (4.16666679e-2f + r * (8.33333377e-3f +
+            r * 1.38888892e-3f)))));
+  int32_t bits = (int32_t(fn) + 127) << 23;
+  float scale;
+  memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+}
+
+/// \brief  approximation of log(1 + x) for x in [0, 1], the relative error is
+// below 2e-7, it is accurate for tiny x
+inline float fast_log1p(float x) {
+  // log(1 + x) = 2 * atanh(s), s = x / (2 + x) in [0, 1/3]
+  float s = x / (2.f + x);
+  float s2 = s * s;
+  float p = 1.f + s2 * (3.33333343e-1f + s2 * (2.00000003e-1f +
+            s2 * (1.42857149e-1f + s2 * (1.11111112e-1f +
+            s2 * (9.09090936e-2f + s2 * 7.69230798e-2f)))));
+  return 2.f * s * p;
+}
+
+/// \brief  log(1 + exp(z)) and 1 / (1 + exp(-z)) of logistic loss, computed
+// with one exponent
+///
+/// \param z input
+/// \param sigmoid resulted 1 / (1 + exp(-z))
+///
+/// \return log(1 + exp(z))
+inline float fast_softplus(float z, float* sigmoid) {
+  float e = fast_exp(-std::fabs(z));
+  float inv = 1.f / (1.f + e);
+  *sigmoid = z >= 0 ? inv : e * inv;
+  return (std::max)(z, 0.f) + fast_log1p(e);
+}
+
+}  // namespace math
+}  // namespace sol
+
+#endif
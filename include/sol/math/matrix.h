@@ -80,7 +80,7 @@ class Matrix
     return *this;
   }
 
-  inline void copyto(Matrix<DType>& dst_mat) {
+  inline void copyto(Matrix<DType>& dst_mat) const {
     dst_mat.resize(this->shape());
     dst_mat.assign(*this);
   }
@@ -18,9 +18,11 @@ namespace math {
 template <typename DType>
 class MatrixStorage {
  public:
-  MatrixStorage() : begin_(nullptr), size_(0) {}
+  MatrixStorage() : begin_(nullptr), size_(0), owned_(true) {}
 
-  ~MatrixStorage() { DeleteArray(this->begin_); }
+  ~MatrixStorage() {
+    if (this->owned_) DeleteArray(this->begin_);
+  }
 
  public:
   /// \brief  resize the storage
@@ -32,12 +34,26 @@ class MatrixStorage {
       memset(new_begin, 0, sizeof(DType) * new_size);
       // copy data
       std::memcpy(new_begin, this->begin_, sizeof(DType) * this->size());
-      DeleteArray(this->begin_);
+      if (this->owned_) DeleteArray(this->begin_);
       this->begin_ = new_begin;
       this->size_ = new_size;
+      this->owned_ = true;
     }
   }
 
+  /// \brief  use external memory as the storage without copying, the memory is
+  // not owned and should outlive the storage, it is copied to owned memory
+  // when the storage grows
+  ///
+  /// \param begin first element of the external memory
+  /// \param size number of elements of the external memory
+  void attach(DType* begin, size_t size) {
+    if (this->owned_) DeleteArray(this->begin_);
+    this->begin_ = begin;
+    this->size_ = size;
+    this->owned_ = false;
+  }
+
   DISABLE_COPY_AND_ASSIGN(MatrixStorage);
 
  public:
@@ -54,6 +70,8 @@ class MatrixStorage {
   DType* begin_;
   // capacity of the array
   size_t size_;
+  // whether the array is allocated by the storage
+  bool owned_;
 };
 
 }  // namespace math
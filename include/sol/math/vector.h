@@ -67,6 +67,22 @@ class Vector : public Matrix<DType> {
     (*this->shape_)[1] = new_size;
   }
 
+  /// \brief  point the vector to external memory without copying, the vector
+  // no longer shares the storage with its copies, see MatrixStorage::attach
+  ///
+  /// \param data first element of the external memory
+  /// \param size number of elements
+  inline void attach(DType* data, size_t size) {
+    this->release();
+    this->storage_ = nullptr;
+    this->shape_ = nullptr;
+    this->count_ = nullptr;
+    this->init();
+    this->storage_->attach(data, size);
+    (*this->shape_)[0] = 1;
+    (*this->shape_)[1] = size;
+  }
+
   /// \brief  Push a new element to the end of the vector, resize the array
   /// accordingly
   ///
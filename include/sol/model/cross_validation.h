@@ -0,0 +1,91 @@
+/*********************************************************************************
+*     File Name           :     cross_validation.h
+*     Created By          :     yuewu
+*     Description         :     k-fold cross validation on in-memory data
+**********************************************************************************/
+
+#ifndef SOL_MODEL_CROSS_VALIDATION_H__
+#define SOL_MODEL_CROSS_VALIDATION_H__
+
+#include <string>
+#include <vector>
+
+#include <sol/util/types.h>
+#include <sol/pario/data_arena.h>
+
+namespace sol {
+namespace model {
+
+/// \brief  k-fold cross validation of the parameter settings of an algorithm.
+// The folds are the same as sol::split: the data (optionally shuffled) are
+// divided into fold_num consecutive parts of ceil(data_num / fold_num) data.
+// For each validation fold, the model is trained on the other folds in order
+// for pass_num passes. The (setting, fold) pairs are run on a thread pool
+// over the shared arena.
+class SOL_EXPORTS CrossValidation {
+ public:
+  /// \brief  create a cross validation
+  ///
+  /// \param arena dataset, should be alive when running
+  /// \param algo name of the algorithm
+  /// \param class_num number of classes
+  /// \param fold_num number of folds
+  CrossValidation(const pario::DataArena &arena, const std::string &algo,
+                  int class_num, int fold_num);
+
+  /// \brief  add a parameter setting to validate
+  ///
+  /// \param params parameters in the format 'param=val;param=val;...'
+  ///
+  /// \return status code, Status_OK if the parameters are valid
+  int AddSetting(const std::string &params);
+
+  /// \brief  expand a grid of parameters to the settings of the Cartesian
+  // product, the first parameter changes the fastest
+  ///
+  /// \param grid grid in the format 'param=v1,v2,...;param=v1,v2,...'
+  /// \param params fixed parameters appended to each setting
+  ///
+  /// \return parameter settings in the format of AddSetting
+  static std::vector<std::string> ExpandGrid(const std::string &grid,
+                                             const std::string &params = "");
+
+  /// \brief  run the cross validation
+  ///
+  /// \param thread_num number of threads
+  /// \param pass_num number of passes over the training folds
+  /// \param batch_size size of mini-batches
+  /// \param shuffle whether to shuffle the data before splitting
+  /// \param seed random seed of shuffling
+  ///
+  /// \return status code, Status_OK if succeed
+  int Run(int thread_num = 1, int pass_num = 1, int batch_size = 256,
+          bool shuffle = false, unsigned int seed = 0);
+
+ public:
+  int fold_num() const { return this->fold_num_; }
+  size_t setting_num() const { return this->settings_.size(); }
+  const std::string &setting(size_t i) const { return this->settings_[i]; }
+  /// \brief  training accuracy of setting i when validating on fold k
+  float train_accuracy(size_t i, int k) const {
+    return this->train_accuracies_[i * this->fold_num_ + k];
+  }
+  /// \brief  validation accuracy of setting i on fold k
+  float val_accuracy(size_t i, int k) const {
+    return this->val_accuracies_[i * this->fold_num_ + k];
+  }
+
+ protected:
+  const pario::DataArena &arena_;
+  std::string algo_;
+  int class_num_;
+  int fold_num_;
+  std::vector<std::string> settings_;
+  std::vector<float> train_accuracies_;
+  std::vector<float> val_accuracies_;
+};
+
+}  // namespace model
+}  // namespace sol
+
+#endif
@@ -0,0 +1,109 @@
+/*********************************************************************************
+*     File Name           :     evaluator.h
+*     Created By          :     yuewu
+*     Description         :     streaming evaluation of the predicted results
+**********************************************************************************/
+
+#ifndef SOL_MODEL_EVALUATOR_H__
+#define SOL_MODEL_EVALUATOR_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <sol/util/types.h>
+
+namespace sol {
+namespace model {
+
+/// \brief  how the scores are kept for AUC and ROC
+enum class AucMode {
+  // keep all the scores, sorted by radix sort on the float keys
+  Exact = 0,
+  // count the scores in a fixed number of bins on the leading bits of the
+  // float keys, the relative resolution of the scores is 2^-7
+  Approx = 1,
+};
+
+/// \brief  accumulate the error rate, log loss and ROC statistics of the
+// predicted results one by one. Each thread should use its own evaluator and
+// merge them at the end. ROC is only available for binary classification,
+// where the labels are 1 or -1.
+class SOL_EXPORTS Evaluator {
+ public:
+  /// \brief  number of points of the ROC curve in Roc
+  static const int kRocFigSize = 21;
+  /// \brief  number of false positive rates (1e-5 to 1) of the ROC table
+  static const int kRocTabSize = 6;
+
+ public:
+  Evaluator(AucMode mode = AucMode::Exact);
+
+  /// \brief  add a predicted result
+  ///
+  /// \param label true label of the data
+  /// \param predict predicted label
+  /// \param scores predicted scores of the classifiers
+  /// \param clf_num number of classifiers
+  void Add(label_t label, label_t predict, const float *scores, int clf_num);
+
+  /// \brief  merge the results of another evaluator of the same mode
+  void Merge(const Evaluator &evaluator);
+
+  /// \brief  compute the ROC statistics, the output arrays are ignored if
+  // nullptr, see kRocFigSize and kRocTabSize for their sizes
+  ///
+  /// \param tpr_fig true positive rates of the ROC curve
+  /// \param fpr_fig false positive rates of the ROC curve
+  /// \param tpr_tab true positive rates at the false positive rates fpr_tab
+  /// \param fpr_tab false positive rates 1e-5, 1e-4, ..., 1
+  ///
+  /// \return area under the ROC curve, ties are counted as half
+  float Roc(float *tpr_fig, float *fpr_fig, float *tpr_tab, float *fpr_tab);
+
+  /// \brief  area under the ROC curve
+  float AUC() { return this->Roc(nullptr, nullptr, nullptr, nullptr); }
+
+ public:
+  AucMode mode() const { return this->mode_; }
+  size_t data_num() const { return this->data_num_; }
+  size_t err_num() const { return this->err_num_; }
+  /// \brief  number of data in the ROC statistics, zero for multi-class
+  size_t roc_num() const { return this->roc_num_; }
+  float err_rate() const {
+    return this->data_num_ == 0 ? 0 : float(double(this->err_num_) /
+                                            this->data_num_);
+  }
+  /// \brief  average logistic loss (binary) or cross entropy of the softmax
+  // scores (multi-class)
+  double log_loss() const {
+    return this->data_num_ == 0 ? 0 : this->loss_sum_ / this->data_num_;
+  }
+
+ protected:
+  /// \brief  map a float to a key with the same order
+  static inline uint32_t FloatKey(float val);
+
+  /// \brief  sort the keys of the exact mode if they are updated
+  void Sort();
+
+ protected:
+  AucMode mode_;
+  size_t data_num_;
+  size_t err_num_;
+  size_t roc_num_;
+  double loss_sum_;
+
+  // exact mode: keys of the scores of the positive and negative data
+  std::vector<uint32_t> pos_keys_;
+  std::vector<uint32_t> neg_keys_;
+  bool sorted_;
+  // approx mode: counts of the positive and negative data in the bins
+  std::vector<uint64_t> pos_bins_;
+  std::vector<uint64_t> neg_bins_;
+};
+
+}  // namespace model
+}  // namespace sol
+
+#endif
@@ -0,0 +1,181 @@
+/*********************************************************************************
+*     File Name           :     feature_cross.h
+*     Created By          :     yuewu
+*     Description         :     hashed crosses of feature index ranges
+**********************************************************************************/
+
+#ifndef SOL_MODEL_FEATURE_CROSS_H__
+#define SOL_MODEL_FEATURE_CROSS_H__
+
+#include <string>
+#include <vector>
+
+#include <sol/util/types.h>
+#include <sol/util/hash.h>
+#include <sol/pario/data_point.h>
+
+namespace sol {
+namespace model {
+
+/// \brief  quadratic and cubic crosses of feature index ranges, like the -q
+// and --cubic options of vowpal wabbit. The product of the features in the
+// ranges is a crossed feature, whose index is hashed into a weight space of
+// 2^bits after the input features, i.e. after the larger one of the declared
+// input dimension (set_dim) and the largest index of the ranges. Input
+// features above the declared dimension would share the weights with the
+// crossed features, so the dimension should be declared when the data have
+// features above the crossed ranges. When a range is crossed with itself,
+// each pair (or triple) of features is generated once.
+//
+// The crosses are generated from the features on the fly, the features
+// should be sorted by indexes as the readers do.
+class SOL_EXPORTS FeatureCross {
+ public:
+  FeatureCross();
+
+  /// \brief  set the ranges to cross
+  ///
+  /// \param spec crosses separated by ',', each cross is 2 or 3 ranges
+  // separated by '*', each range is 'lo-hi' or a single index, e.g.
+  // '1-50*51-120,1-50*1-50*1-50', empty to disable crossing
+  void set_crosses(const std::string &spec);
+
+  /// \brief  set the number of bits of the hashed weight space
+  void set_bits(int bits);
+
+  /// \brief  set the largest feature index of the input data, 0 if all the
+  // input features are in the crossed ranges
+  void set_dim(index_t dim);
+
+  /// \brief  call func(index, value) for each crossed feature of x
+  ///
+  /// \param x features sorted by indexes, with size(), index(i), feature(i)
+  /// \param func function to receive the crossed features
+  template <typename Features, typename Func>
+  void ForEach(const Features &x, Func func) const;
+
+  /// \brief  append the crossed features to the data point, the feature of
+  // the largest index is moved to the end so that dim() is kept
+  ///
+  /// \return false if x has features above the input dimension, which share
+  // the weights with the crossed features
+  bool Expand(pario::DataPoint &x) const;
+
+ public:
+  bool empty() const { return this->crosses_.empty(); }
+  const std::string &crosses() const { return this->spec_; }
+  int bits() const { return this->bits_; }
+  /// \brief  declared largest feature index of the input data
+  index_t input_dim() const { return this->input_dim_; }
+  /// \brief  largest index of the input features not overlapping with the
+  // crossed features
+  index_t offset() const { return this->offset_; }
+  /// \brief  dimension to hold all the crossed features
+  index_t dim() const { return this->offset_ + this->mask_ + 2; }
+
+ protected:
+  struct Range {
+    index_t lo;
+    index_t hi;
+    bool operator==(const Range &r) const {
+      return this->lo == r.lo && this->hi == r.hi;
+    }
+  };
+  static const size_t kMaxOrder = 3;
+
+  /// \brief  position of the first feature not less than index
+  template <typename Features>
+  static size_t LowerBound(const Features &x, index_t index);
+
+  /// \brief  cross the features of a range with the previous ones
+  template <typename Features, typename Func>
+  void Enumerate(const Features &x, const Range *ranges, const size_t *begins,
+                 const size_t *ends, size_t order, size_t level,
+                 size_t prev_pos, uint32_t h, real_t val, Func &func) const;
+
+ protected:
+  std::string spec_;
+  std::vector<std::vector<Range>> crosses_;
+  int bits_;
+  uint32_t mask_;
+  // largest index of the ranges
+  index_t range_max_;
+  // declared largest feature index of the input data
+  index_t input_dim_;
+  // crossed features are hashed to (offset_, offset_ + 2^bits], offset_ is
+  // the larger one of range_max_ and input_dim_
+  index_t offset_;
+};
+
+/// \brief  features with the ones not selected as zero, the same as
+// Model::FilterFeatures, to cross the features without modifying them
+template <typename Features, typename Selector>
+struct SelectedFeatures {
+  const Features &x;
+  const Selector &selected;
+
+  inline size_t size() const { return this->x.size(); }
+  inline index_t index(size_t i) const { return this->x.index(i); }
+  inline real_t feature(size_t i) const {
+    return this->selected(this->x.index(i)) ? real_t(this->x.feature(i)) : 0;
+  }
+};
+
+template <typename Features>
+size_t FeatureCross::LowerBound(const Features &x, index_t index) {
+  size_t lo = 0, hi = x.size();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (x.index(mid) < index) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <typename Features, typename Func>
+void FeatureCross::Enumerate(const Features &x, const Range *ranges,
+                             const size_t *begins, const size_t *ends,
+                             size_t order, size_t level, size_t prev_pos,
+                             uint32_t h, real_t val, Func &func) const {
+  size_t begin = begins[level];
+  // a range crossed with itself starts from the previous feature
+  if (level > 0 && ranges[level] == ranges[level - 1]) begin = prev_pos;
+  for (size_t i = begin; i < ends[level]; ++i) {
+    real_t feat = x.feature(i);
+    // filtered features are zero
+    if (feat == 0) continue;
+    uint32_t hash = hash_combine(h, uint32_t(x.index(i)));
+    // the order is at most kMaxOrder, bounding the recursion explicitly
+    if (level + 1 == order || level + 1 == kMaxOrder) {
+      func(this->offset_ + index_t(hash & this->mask_) + 1, val * feat);
+    } else {
+      this->Enumerate(x, ranges, begins, ends, order, level + 1, i, hash,
+                      val * feat, func);
+    }
+  }
+}
+
+template <typename Features, typename Func>
+void FeatureCross::ForEach(const Features &x, Func func) const {
+  size_t begins[kMaxOrder], ends[kMaxOrder];
+  for (size_t c = 0; c < this->crosses_.size(); ++c) {
+    const std::vector<Range> &ranges = this->crosses_[c];
+    bool empty = false;
+    for (size_t k = 0; k < ranges.size() && !empty; ++k) {
+      begins[k] = LowerBound(x, ranges[k].lo);
+      ends[k] = LowerBound(x, ranges[k].hi + 1);
+      empty = begins[k] == ends[k];
+    }
+    if (empty) continue;
+    this->Enumerate(x, ranges.data(), begins, ends, ranges.size(), 0, 0,
+                    uint32_t(c + 1), real_t(1), func);
+  }
+}
+
+}  // namespace model
+}  // namespace sol
+
+#endif
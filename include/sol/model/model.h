@@ -9,21 +9,26 @@
 #ifndef SOL_MODEL_MODEL_H__
 #define SOL_MODEL_MODEL_H__
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
 
 #include <json/json.h>
 
 #include <sol/util/types.h>
 #include <sol/util/reflector.h>
 #include <sol/util/error_code.h>
+#include <sol/util/mapped_file.h>
 #include <sol/loss/loss.h>
 #include <sol/pario/data_point.h>
 #include <sol/pario/data_iter.h>
 #include <sol/math/operator.h>
 #include <sol/model/regularizer.h>
+#include <sol/model/evaluator.h>
+#include <sol/model/feature_cross.h>
 
 namespace sol {
 namespace model {
@@ -62,6 +67,16 @@ class SOL_EXPORTS Model {
   /// \return test error rate
 	 float Test(pario::DataIter &data_iter, std::ostream *os, float* tpr_fig, float*fpr_fig, float* tpr_tab, float* fpr_tab, float* auc);
 
+  /// \brief  Test a dataset
+  ///
+  /// \param data_iter data iterator
+  /// \param os output stream to store the predicted results
+  /// \param evaluator evaluator to accumulate the results, ignored if nullptr
+  ///
+  /// \return test error rate
+  float Test(pario::DataIter &data_iter, std::ostream *os,
+             Evaluator *evaluator);
+
  public:
   /// \brief  initialize the model for training
   virtual void BeginTrain();
@@ -77,21 +92,47 @@ class SOL_EXPORTS Model {
   /// \return predicted class label
   virtual label_t Predict(const pario::DataPoint &dp, float *predicts) = 0;
 
+ public:
+  /// \brief  create a replica of the model with the same settings and
+  // parameters, used by parallel training
+  ///
+  /// \return the replica, nullptr if the model can not be replicated
+  Model *Clone();
+
+  /// \brief  set the parameters of the model to the average of the replicas,
+  // the model itself should not be in the replicas
+  ///
+  /// \param replicas replicas of the model
+  ///
+  /// \return status code, Status_OK if merged successfully
+  virtual int Merge(const std::vector<Model *> &replicas) {
+    return Status_Invalid_Argument;
+  }
+
  public:
   /// \brief  Save model to file
   ///
   /// \param path path to save the model
+  /// \param binary whether to save in the binary format, which is a json
+  // header followed by the raw arrays of GetModelArrays
   ///
   /// \return status code, 0 if saved successfully
-  int Save(const std::string &path) const;
+  int Save(const std::string &path, bool binary = false) const;
   math::Vector<real_t>* Model::Get() const;
-  /// \brief  load model from file
+  /// \brief  load model from file, the format is detected automatically,
+  // arrays of binary models are mapped into memory without copying, the
+  // training states of the checkpoints are restored as well
   ///
   /// \param path file path of the model
   ///
   /// \return status code 0 if load successfully
   static Model *Load(const std::string &path);
 
+ private:
+  int SaveBinary(const std::string &path) const;
+  static Model *LoadBinary(const std::string &path);
+
+ public:
   /// \brief  get the sparsity of model
   ///
   /// \param thresh threshold below which weight is considered zero
@@ -99,6 +140,25 @@ class SOL_EXPORTS Model {
   /// \return sparsity
   virtual float model_sparsity() { return 0; }
 
+  /// \brief  memory of a named component of the model
+  struct MemoryBlock {
+    std::string name;
+    // bytes of the elements in use
+    size_t used;
+    // bytes allocated, including the slack reserved by the growth of the
+    // vectors
+    size_t allocated;
+  };
+
+  /// \brief  get the memory of the states of the model, the arrays of
+  // GetModelArrays and GetCheckpointArrays by default
+  ///
+  /// \param blocks memory of the components, appended to
+  virtual void MemoryUsage(std::vector<MemoryBlock> &blocks) const;
+
+  /// \brief  total bytes allocated by the states of the model
+  size_t memory_usage() const;
+
   /// \brief  get model info string
   std::string model_info() const;
 
@@ -118,6 +178,50 @@ class SOL_EXPORTS Model {
   /// \return status code, zero if ok
   virtual int SetModelParam(std::istream &is) = 0;
 
+  /// \brief  named parameter array of the model
+  typedef std::pair<std::string, math::Vector<real_t> *> ModelArray;
+
+  /// \brief  memory of a vector, see MemoryUsage
+  template <typename T>
+  static MemoryBlock VectorMemory(const std::string &name,
+                                  const math::Vector<T> &vec) {
+    // the storage is not allocated for empty vectors
+    size_t capacity = vec.size() > 0 ? vec.capacity() : 0;
+    MemoryBlock block = {name, vec.size() * sizeof(T), capacity * sizeof(T)};
+    return block;
+  }
+
+  /// \brief  get the parameter arrays of the model in the binary format, the
+  // arrays are the same as those in GetModelParam and of the size set by
+  // SetModelInfo, so that they can be replaced by the mapped arrays
+  ///
+  /// \param arrays arrays of the model
+  virtual void GetModelArrays(std::vector<ModelArray> &arrays) {}
+
+  /// \brief  get the arrays of the training states besides GetModelArrays,
+  // which are written to the checkpoints, the sizes may differ from the
+  // arrays of the model
+  ///
+  /// \param arrays state arrays, appended to
+  virtual void GetCheckpointArrays(std::vector<ModelArray> &arrays);
+
+  /// \brief  restore the training states of a checkpoint besides the arrays
+  ///
+  /// \param root checkpoint info
+  ///
+  /// \return status code, Status_OK if restored successfully
+  virtual int SetCheckpointInfo(const Json::Value &root) { return Status_OK; }
+
+  /// \brief  write a file in the binary format of the models
+  ///
+  /// \param path path of the file
+  /// \param root json header, the layout of the arrays is added as "arrays"
+  /// \param arrays arrays following the json header
+  ///
+  /// \return status code, Status_OK if saved successfully
+  static int WriteBinary(const std::string &path, Json::Value &root,
+                         const std::vector<ModelArray> &arrays);
+
   /// \brief  Get Model Information
   ///
   /// \param root root node of saver
@@ -155,11 +259,18 @@ class SOL_EXPORTS Model {
   /// \param x input data instance
   void FilterFeatures(pario::DataPoint &x);
 
-  /// \brief  preprocess the  data point, like normalization, filtering
+  /// \brief  preprocess the  data point, like normalization, filtering,
+  // crossing
   ///
   /// \param x input data instance
   void PreProcess(pario::DataPoint &x);
 
+  /// \brief  whether the data of a mini-batch are already preprocessed by
+  // the data iterator with PreProcessTransform of the model
+  inline bool IsPreProcessed(const pario::MiniBatch &mb) const {
+    return mb.preprocessor == this;
+  }
+
  public:
   int class_num() const { return this->class_num_; }
   int clf_num() const { return this->clf_num_; }
@@ -167,6 +278,14 @@ class SOL_EXPORTS Model {
   std::string name() const { return name_; }
   void set_name(const std::string &name) { this->name_ = name; }
   size_t update_num() const { return this->update_num_; }
+  sol::math::expr::op::OpType norm_type() const { return this->norm_type_; }
+  /// \brief  flags of the pre-selected features indexed by feature, empty if
+  // no features are pre-selected
+  const math::Vector<char> &sel_feat_flags() const {
+    return this->sel_feat_flags_;
+  }
+  /// \brief  crosses of features generated in PreProcess
+  const FeatureCross &feature_cross() const { return this->feature_cross_; }
 
  protected:
   // number of classes
@@ -185,12 +304,19 @@ class SOL_EXPORTS Model {
   index_t max_index_;
   // pre-selected features
   math::Vector<char> sel_feat_flags_;
+  // crosses of features
+  FeatureCross feature_cross_;
+  // whether the overlap of input and crossed features is reported
+  std::atomic<bool> cross_overlap_shown_;
 
   // number of updates during the training
   size_t update_num_;
 
   std::string name_;
 
+  // file of the mapped parameter arrays of the model loaded in binary format
+  MappedFile *mapped_file_;
+
  public:
   bool model_updated() const { return model_updated_; }
 
@@ -199,6 +325,25 @@ class SOL_EXPORTS Model {
   bool model_updated_;   // wheter need to call EndTrain before Test or Predict
 };
 
+/// \brief  transform to apply the PreProcess of a model on the reader
+// threads, the transformed mini-batches are skipped by the PreProcess of the
+// model in training and testing. The parameters of the model related to
+// preprocessing should not be changed while the data are read.
+class SOL_EXPORTS PreProcessTransform : public pario::Transform {
+ public:
+  PreProcessTransform(Model *model) : model_(model) {}
+
+  virtual void Apply(pario::DataPoint &x) const { this->model_->PreProcess(x); }
+
+  virtual void Apply(pario::MiniBatch &mb) const {
+    pario::Transform::Apply(mb);
+    mb.preprocessor = this->model_;
+  }
+
+ protected:
+  Model *model_;
+};
+
 #define RegisterModel(type, name, descr)                                  \
   type *type##_##CreateNewInstance(int class_num) {                       \
     type *ins = new type(class_num);                                      \
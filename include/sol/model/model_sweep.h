@@ -0,0 +1,67 @@
+/*********************************************************************************
+*     File Name           :     model_sweep.h
+*     Created By          :     yuewu
+*     Description         :     train multiple models with one pass of data
+**********************************************************************************/
+
+#ifndef SOL_MODEL_MODEL_SWEEP_H__
+#define SOL_MODEL_MODEL_SWEEP_H__
+
+#include <vector>
+
+#include <sol/util/types.h>
+#include <sol/pario/data_iter.h>
+#include <sol/model/model.h>
+
+namespace sol {
+namespace model {
+
+/// \brief  training status of a model at an iteration
+struct IterStat {
+  long long data_num;
+  long long iter_num;
+  long long update_num;
+  double err_rate;
+  // seconds since the start of training
+  double time;
+};
+
+/// \brief  train multiple models (different algorithms or parameters)
+// concurrently from one data stream. The mini-batches are parsed once and
+// dispatched to a training thread of each model, which copies the data
+// before the model pre-processes it.
+class SOL_EXPORTS ModelSweep {
+ public:
+  /// \brief  add a model to train, the model is not owned by the sweep
+  void AddModel(Model *model) { this->models_.push_back(model); }
+
+  /// \brief  train the models with the data
+  ///
+  /// \param data_iter data iterator shared by the models
+  ///
+  /// \return status code, Status_OK if succeed, Status_Error if any model
+  // stopped before the end of data, e.g. failed to init; the other models
+  // are still trained
+  int Train(pario::DataIter &data_iter);
+
+ public:
+  size_t model_num() const { return this->models_.size(); }
+  Model *model(size_t i) const { return this->models_[i]; }
+  /// \brief  training error rate of the i-th model
+  float err_rate(size_t i) const { return this->err_rates_[i]; }
+  /// \brief  training status of the i-th model at the iterations shown by
+  // the model, only available for online models
+  const std::vector<IterStat> &curve(size_t i) const {
+    return this->curves_[i];
+  }
+
+ protected:
+  std::vector<Model *> models_;
+  std::vector<float> err_rates_;
+  std::vector<std::vector<IterStat>> curves_;
+};
+
+}  // namespace model
+}  // namespace sol
+
+#endif
@@ -13,6 +13,8 @@ namespace sol {
 namespace model {
 
 class AdaFOBOS : public OnlineLinearModel {
+  friend class TrainLoop<AdaFOBOS>;
+
  public:
   AdaFOBOS(int class_num);
   virtual ~AdaFOBOS();
@@ -22,11 +24,22 @@ class AdaFOBOS : public OnlineLinearModel {
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
+  virtual bool SelectTrainLoops(TrainLoopFunc* loops);
+  virtual bool support_hogwild() const { return true; }
+  virtual void ApplyGradients(const pario::DataPoint& dp,
+                              const real_t* gradients, int t) final;
+  virtual bool support_mini_batch() const { return true; }
+  virtual void ApplyBatchGradients(const math::SVector<real_t>* grads,
+                                   const real_t* bias_grads, int t);
+  virtual bool GetStateVectors(std::vector<math::Vector<real_t>*>& states);
   virtual void update_dim(index_t dim);
+  virtual bool support_budget() const { return true; }
+  virtual void EvictFeature(index_t index);
 
   virtual void GetModelInfo(Json::Value& root) const;
   virtual void GetModelParam(std::ostream& os) const;
   virtual int SetModelParam(std::istream& is);
+  virtual void GetModelArrays(std::vector<ModelArray>& arrays);
 
  protected:
   float delta_;
@@ -43,6 +56,8 @@ class AdaFOBOS_L1 : public AdaFOBOS {
 
  protected:
   virtual label_t TrainPredict(const pario::DataPoint& dp, float* predicts);
+  virtual void FinalizeWeights(
+      std::vector<math::Vector<real_t>>& weights) const;
 
  protected:
   LazyOnlineL1Regularizer l1_;
@@ -14,6 +14,8 @@ namespace sol {
 namespace model {
 
 class AROW : public OnlineLinearModel {
+  friend class TrainLoop<AROW>;
+
  public:
   AROW(int class_num);
   virtual ~AROW();
@@ -23,11 +25,14 @@ class AROW : public OnlineLinearModel {
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
+  virtual bool SelectTrainLoops(TrainLoopFunc* loops);
   virtual void update_dim(index_t dim);
+  virtual bool GetStateVectors(std::vector<math::Vector<real_t>*>& states);
 
   virtual void GetModelInfo(Json::Value& root) const;
   virtual void GetModelParam(std::ostream& os) const;
   virtual int SetModelParam(std::istream& is);
+  virtual void GetModelArrays(std::vector<ModelArray>& arrays);
 
  protected:
   inline math::Vector<real_t>& Sigma(int cls_id) {
@@ -47,11 +52,15 @@ class SOFS : public AROW {
 
   virtual void SetParameter(const std::string& name, const std::string& value);
   virtual void BeginTrain();
+  virtual void MemoryUsage(std::vector<MemoryBlock>& blocks) const;
 
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
   virtual void update_dim(index_t dim);
+  virtual bool GetStateVectors(std::vector<math::Vector<real_t>*>& states);
+  /// \brief  select the features again after the states are averaged
+  virtual void EndMerge();
 
  protected:
   math::Vector<real_t>* Sigma_sum_;
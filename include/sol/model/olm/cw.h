@@ -26,10 +26,12 @@ class CW : public OnlineLinearModel {
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
   virtual void update_dim(index_t dim);
+  virtual bool GetStateVectors(std::vector<math::Vector<real_t>*>& states);
 
   virtual void GetModelInfo(Json::Value& root) const;
   virtual void GetModelParam(std::ostream& os) const;
   virtual int SetModelParam(std::istream& is);
+  virtual void GetModelArrays(std::vector<ModelArray>& arrays);
 
  protected:
   loss::HingeBase* hinge_base_;
@@ -20,6 +20,7 @@ class FOFS : public OnlineLinearModel {
 
   virtual void SetParameter(const std::string& name, const std::string& value);
   virtual void BeginTrain();
+  virtual void MemoryUsage(std::vector<MemoryBlock>& blocks) const;
 
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
@@ -28,11 +29,19 @@ class FOFS : public OnlineLinearModel {
 
   virtual void GetModelInfo(Json::Value& root) const;
 
+  /// \brief  check if a feature should be moved into the heap, zero the
+  /// weights of the feature moved out of the heap
+  ///
+  /// \param idx index of the feature in heap (bias excluded)
+  void TruncateWeight(index_t idx);
+
  protected:
   float lambda_;
   index_t B_;
   math::Vector<real_t> abs_weights_;
   MinHeap min_heap_;
+  // whether to check all the features in the next update
+  bool full_trunc_;
 
   float norm_coeff_;
   float momentum_;
@@ -16,6 +16,8 @@ namespace sol {
 namespace model {
 
 class OGD : public OnlineLinearModel {
+  friend class TrainLoop<OGD>;
+
  public:
   OGD(int class_num);
 
@@ -24,6 +26,17 @@ class OGD : public OnlineLinearModel {
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
+  virtual bool SelectTrainLoops(TrainLoopFunc* loops);
+  virtual bool support_hogwild() const { return true; }
+  virtual void ApplyGradients(const pario::DataPoint& dp,
+                              const real_t* gradients, int t) final;
+  virtual bool support_mini_batch() const { return true; }
+  virtual void ApplyBatchGradients(const math::SVector<real_t>* grads,
+                                   const real_t* bias_grads, int t);
+  virtual bool GetStateVectors(std::vector<math::Vector<real_t>*>& states) {
+    return this->regularizer_ == nullptr;
+  }
+  virtual bool support_budget() const { return true; }
   virtual void GetModelInfo(Json::Value& root) const;
 
  protected:
@@ -50,14 +63,21 @@ class STG : public OGD {
  protected:
   virtual label_t TrainPredict(const pario::DataPoint& dp, float* predicts);
   void update_dim(index_t dim);
+  virtual void FinalizeWeights(
+      std::vector<math::Vector<real_t>>& weights) const;
 
   virtual void GetModelInfo(Json::Value& root) const;
+  virtual void GetCheckpointArrays(std::vector<ModelArray>& arrays);
+  virtual int SetCheckpointInfo(const Json::Value& root);
 
  protected:
   // truncate every k steps
   int k_;
   OnlineL1Regularizer l1_;
   math::Vector<real_t> last_trunc_time_;
+  // whether last_trunc_time_ is restored from a checkpoint, so that it is not
+  // reset by BeginTrain
+  bool trunc_time_restored_;
 };  // class STG
 
 /// \brief  Forward Backward Splitting
@@ -69,6 +89,8 @@ class FOBOS_L1 : public OGD {
 
  protected:
   virtual label_t TrainPredict(const pario::DataPoint& dp, float* predicts);
+  virtual void FinalizeWeights(
+      std::vector<math::Vector<real_t>>& weights) const;
 
  protected:
   LazyOnlineL1Regularizer l1_;
@@ -82,16 +104,27 @@ class PET : public OGD {
 
   virtual void SetParameter(const std::string& name, const std::string& value);
   virtual void BeginTrain();
+  virtual void MemoryUsage(std::vector<MemoryBlock>& blocks) const;
 
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
   virtual void update_dim(index_t dim);
+  // the heap of the weights is not updated by evictions
+  virtual bool support_budget() const { return false; }
+
+  /// \brief  check if a feature should be moved into the heap, zero the
+  /// weights of the feature moved out of the heap
+  ///
+  /// \param idx index of the feature in heap (bias excluded)
+  void TruncateWeight(index_t idx);
 
  protected:
   math::Vector<real_t> abs_weights_;
   OnlineRegularizer l0_;
   MinHeap min_heap_;
+  // whether to check all the features in the next update
+  bool full_trunc_;
 };
 
 }  // namespace model
@@ -12,12 +12,15 @@ namespace sol {
 namespace model {
 
 class PA : public OnlineLinearModel {
+  friend class TrainLoop<PA>;
+
  public:
   PA(int class_num);
 
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
+  virtual bool SelectTrainLoops(TrainLoopFunc* loops);
 
  protected:
   // the coeffient difference between binary and multiclass classification
@@ -25,6 +28,8 @@ class PA : public OnlineLinearModel {
 };  // class PA
 
 class PAI : public PA {
+  friend class TrainLoop<PAI>;
+
  public:
   PAI(int class_num) : PA(class_num), C_(1.f) {}
 
@@ -33,6 +38,7 @@ class PAI : public PA {
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
+  virtual bool SelectTrainLoops(TrainLoopFunc* loops);
   virtual void GetModelInfo(Json::Value& root) const;
 
  protected:
@@ -40,6 +46,8 @@ class PAI : public PA {
 };  // class PAI
 
 class PAII : public PA {
+  friend class TrainLoop<PAII>;
+
  public:
   PAII(int class_num) : PA(class_num), C_(1.f) {}
 
@@ -48,6 +56,7 @@ class PAII : public PA {
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
+  virtual bool SelectTrainLoops(TrainLoopFunc* loops);
   virtual void GetModelInfo(Json::Value& root) const;
 
  protected:
@@ -12,6 +12,8 @@ namespace sol {
 namespace model {
 
 class Perceptron : public OnlineLinearModel {
+  friend class TrainLoop<Perceptron>;
+
  public:
   Perceptron(int class_num);
 
@@ -20,6 +22,7 @@ class Perceptron : public OnlineLinearModel {
  protected:
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
+  virtual bool SelectTrainLoops(TrainLoopFunc* loops);
 };  // class Perceptron
 
 }  // namespace model
@@ -26,10 +26,13 @@ class RDA : public OnlineLinearModel {
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
   virtual void update_dim(index_t dim);
+  virtual void FinalizeWeights(
+      std::vector<math::Vector<real_t>>& weights) const;
 
   virtual void GetModelInfo(Json::Value& root) const;
   virtual void GetModelParam(std::ostream& os) const;
   virtual int SetModelParam(std::istream& is);
+  virtual void GetModelArrays(std::vector<ModelArray>& arrays);
 
  protected:
   float sigma_;
@@ -46,6 +49,8 @@ class RDA_L1 : public RDA {
 
  protected:
   virtual label_t TrainPredict(const pario::DataPoint& dp, float* predicts);
+  virtual void FinalizeWeights(
+      std::vector<math::Vector<real_t>>& weights) const;
 
  protected:
   OnlineL1Regularizer l1_;
@@ -61,6 +66,8 @@ class ERDA_L1 : public RDA {
 
  protected:
   virtual label_t TrainPredict(const pario::DataPoint& dp, float* predicts);
+  virtual void FinalizeWeights(
+      std::vector<math::Vector<real_t>>& weights) const;
 
   virtual void GetModelInfo(Json::Value& root) const;
 
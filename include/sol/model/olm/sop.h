@@ -27,10 +27,13 @@ class SOP : public OnlineLinearModel {
   virtual void Update(const pario::DataPoint& dp, const float* predict,
                       float loss);
   virtual void update_dim(index_t dim);
+  virtual void FinalizeWeights(
+      std::vector<math::Vector<real_t>>& weights) const;
 
   virtual void GetModelInfo(Json::Value& root) const;
   virtual void GetModelParam(std::ostream& os) const;
   virtual int SetModelParam(std::istream& is);
+  virtual void GetModelArrays(std::vector<ModelArray>& arrays);
 
  protected:
   math::Vector<real_t>& v(int cls_id) { return this->v_[cls_id]; }
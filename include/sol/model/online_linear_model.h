@@ -9,19 +9,64 @@
 #ifndef SOL_MODEL_ONLINE_LINEAR_MODEL_H__
 #define SOL_MODEL_ONLINE_LINEAR_MODEL_H__
 
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
 #include <sol/math/vector.h>
 #include <sol/model/online_model.h>
 
 namespace sol {
+namespace dist {
+class Coordinator;
+}  // namespace dist
+
 namespace model {
 
+template <typename Algo>
+class TrainLoop;
+class Predictor;
+
 class OnlineLinearModel : public OnlineModel {
+ public:
+  /// \brief  training loop over the data, the arguments are the same as
+  // IterateData
+  typedef void (*TrainLoopFunc)(OnlineLinearModel* model,
+                                pario::DataIter& data_iter, long long* data_no,
+                                long long* iter_no, float* err_no,
+                                float* time_no, long long* update_no);
+
  public:
   OnlineLinearModel(int class_num);
   virtual ~OnlineLinearModel();
 
+  virtual void SetParameter(const std::string& name, const std::string& value);
+
  public:
-  virtual void BeginTrain() { OnlineModel::BeginTrain(); }
+  virtual void BeginTrain() {
+    if (this->budget_ > 0 && this->support_budget() == false) {
+      throw std::invalid_argument("weight budget is not supported by " +
+                                  this->name());
+    }
+    // the workers read different data
+    if (this->coordinator_ != nullptr && !this->checkpoint_path_.empty()) {
+      throw std::invalid_argument(
+          "checkpointing is not supported by distributed training");
+    }
+    OnlineModel::BeginTrain();
+    // the dimension is expanded before the data are crossed in PreProcess
+    if (!this->feature_cross_.empty()) {
+      this->update_dim(this->feature_cross_.dim());
+    }
+    if (this->SelectTrainLoops(this->train_loops_) == false) {
+      this->train_loops_[0] = this->train_loops_[1] = nullptr;
+    }
+    if (this->budget_ > 0) this->InitBudget();
+  }
+
+  virtual float Train(pario::DataIter& data_iter, long long* data_no,
+                      long long* iter_no, float* err_no, float* time_no,
+                      long long* update_no, int* table_size);
 
   virtual void EndTrain() {
     if (this->regularizer_ != nullptr) {
@@ -35,6 +80,68 @@ class OnlineLinearModel : public OnlineModel {
 
   virtual label_t Iterate(const pario::DataPoint& dp, float* predicts);
 
+  /// \brief  average the weights and the states returned by GetStateVectors
+  // over the replicas, replicas are expanded to the same dimension
+  virtual int Merge(const std::vector<Model*>& replicas);
+
+  /// \brief  train data-parallel with other workers, each worker trains on
+  // its shard of the mini-batches and the models are synchronized by the
+  // coordinator
+  ///
+  /// \param coordinator coordinator of the workers, not owned, nullptr to
+  // train locally
+  void set_coordinator(dist::Coordinator* coordinator) {
+    this->coordinator_ = coordinator;
+  }
+
+  /// \brief  C type to inspect the weight budget
+  ///
+  /// \param user_context flexible place to handle the budget status
+  /// \param iter_num number of iterations currently
+  /// \param active_num number of features with non-zero weights
+  /// \param evict_num number of features evicted so far
+  typedef void (*InspectBudgetCallback)(void* user_context, long long iter_num,
+                                        long long active_num,
+                                        long long evict_num);
+
+  /// \brief  set the callback to report the weight budget along with the
+  // iterate callback, only called when the budget is set
+  void set_budget_callback(InspectBudgetCallback callback,
+                           void* user_context) {
+    this->budget_callback_ = callback;
+    this->budget_callback_user_context_ = user_context;
+  }
+
+  /// \brief  maximum number of features with non-zero weights, 0 if the
+  // model is not bounded, the features of the current instance are always
+  // kept even if they alone exceed the budget
+  size_t budget() const { return this->budget_; }
+  /// \brief  number of features evicted by the weight budget
+  size_t evict_num() const { return this->evict_num_; }
+  /// \brief  number of features with non-zero weights on any class
+  size_t active_feature_num() const;
+
+  /// \brief  the latest snapshot of the finalized weights published by the
+  // training thread, see PublishSnapshot. Any number of threads can get the
+  // snapshot and predict with it while the model is trained, a snapshot is
+  // released when the last thread drops it.
+  ///
+  /// \return the snapshot, nullptr if no snapshot is published
+  std::shared_ptr<const Predictor> snapshot() const;
+
+  /// \brief  copy the weights and finalize the copies as EndTrain, the model
+  // is not modified, so that it can be called by many threads concurrently
+  // as long as the model is not trained
+  ///
+  /// \param weights copies of the finalized weights of each classifier
+  void CopyFinalizedWeights(std::vector<math::Vector<real_t>>& weights) const;
+
+  /// \brief  copy the weights, finalize the copies as EndTrain and publish
+  // them as the latest snapshot, called by the training loops every
+  // "snapshot_interval" iterations or "snapshot_ms" milliseconds, and at the
+  // end of Train. It must not be called concurrently with the training.
+  void PublishSnapshot();
+
  protected:
   /// \brief  update model
   ///
@@ -47,13 +154,159 @@ class OnlineLinearModel : public OnlineModel {
 
   virtual label_t TrainPredict(const pario::DataPoint& dp, float* predicts);
 
+  virtual void ShowIterInfo(long long* data_no, long long* iter_no,
+                            float* err_no, float* time_no,
+                            long long* update_no);
+
+  virtual void EndMiniBatch();
+
+  /// \brief  apply the finalization of EndTrain on copies of the weights
+  // without modifying the model, the regularizer is finalized by the caller
+  ///
+  /// \param weights copies of the weights of each classifier
+  virtual void FinalizeWeights(
+      std::vector<math::Vector<real_t>>& weights) const {}
+
+ protected:
+  /// \brief  whether the features can be evicted by the weight budget, i.e.
+  // EvictFeature resets all the per-feature states of the model
+  virtual bool support_budget() const { return false; }
+
+  /// \brief  reset the weights and the states of a feature to the initial
+  // values, called when the feature is evicted by the weight budget
+  ///
+  /// \param index index of the feature
+  virtual void EvictFeature(index_t index);
+
+  /// \brief  record the features of a training instance for the weight
+  // budget, evict features if the budget is exceeded
+  ///
+  /// \param dp training instance, the dimension is expanded already
+  /// \param t iteration number of the instance
+  void TrackFeatures(const pario::DataPoint& dp, int t);
+
+ protected:
+  /// \brief  iterate over the data with multiple threads updating the shared
+  // weights without locks (Hogwild), if the model supports it
+  virtual void IterateData(pario::DataIter& data_iter, long long* data_no,
+                           long long* iter_no, float* err_no, float* time_no,
+                           long long* update_no);
+
+  /// \brief  whether the model can be updated by multiple threads without
+  // locks, i.e. ApplyGradients is implemented and no regularizer is used
+  virtual bool support_hogwild() const { return false; }
+
+  /// \brief  update model with the given gradients, called concurrently by
+  // the training threads in hogwild mode
+  ///
+  /// \param dp training instance
+  /// \param gradients gradients on each class
+  /// \param t iteration number of the instance
+  virtual void ApplyGradients(const pario::DataPoint& dp,
+                              const real_t* gradients, int t) {}
+
+  /// \brief  get the model states besides the weights, which are averaged when
+  // merging replicas
+  ///
+  /// \param states model states
+  ///
+  /// \return whether the model can be merged by averaging the states
+  virtual bool GetStateVectors(std::vector<math::Vector<real_t>*>& states) {
+    return false;
+  }
+
+  /// \brief  called after the states are averaged by Merge or by the
+  // synchronization of workers
+  virtual void EndMerge() {}
+
+  /// \brief  whether the model can be updated once per mini-batch, i.e.
+  // ApplyBatchGradients is implemented
+  virtual bool support_mini_batch() const { return false; }
+
+  /// \brief  update model with the gradients summed over a mini-batch
+  ///
+  /// \param grads summed gradients of the features on each class
+  /// \param bias_grads summed gradients of the bias on each class
+  /// \param t iteration number after the mini-batch
+  virtual void ApplyBatchGradients(const math::SVector<real_t>* grads,
+                                   const real_t* bias_grads, int t) {}
+
+  /// \brief  select the training loops specialized for the algorithm and the
+  // loss function, see TrainLoop
+  ///
+  /// \param loops loops without and with lazy update
+  ///
+  /// \return false if no specialized loop is available
+  virtual bool SelectTrainLoops(TrainLoopFunc* loops) { return false; }
+
+ private:
+  class HogwildContext;
+  /// \brief  training thread of hogwild mode
+  void HogwildIterate(HogwildContext* ctx);
+
+  /// \brief  iterate over the data with replicas trained on their own
+  // mini-batches and averaged periodically (iterative parameter mixing)
+  ///
+  /// \return false if the model can not be replicated
+  bool MixIterate(pario::DataIter& data_iter, long long* data_no,
+                  long long* iter_no, float* err_no, float* time_no,
+                  long long* update_no);
+
+  /// \brief  iterate over the data with one update per mini-batch, the
+  // instances of a mini-batch are predicted with the same weights. The
+  // gradients are summed, not averaged, so each instance keeps its own step
+  // size; on small data, large batches lower the training accuracy as fewer
+  // and staler updates are made.
+  void MiniBatchIterate(pario::DataIter& data_iter, long long* data_no,
+                        long long* iter_no, float* err_no, float* time_no,
+                        long long* update_no);
+
+  /// \brief  iterate over the shard of the worker, synchronizing with the
+  // other workers every sync_interval instances
+  ///
+  /// \return false if the model can not be synchronized
+  bool DistIterate(pario::DataIter& data_iter, long long* data_no,
+                   long long* iter_no, float* err_no, float* time_no,
+                   long long* update_no);
+
+  /// \brief  synchronize the dimension, the states and the counters with the
+  // other workers
+  ///
+  /// \param snapshot model after the last synchronization
+  /// \param updated whether the model is updated since the last
+  // synchronization
+  /// \param finished whether the shard of the worker is finished
+  ///
+  /// \return whether all the workers finished their shards
+  bool SyncWorkers(OnlineLinearModel* snapshot, bool updated, bool finished);
+
+  /// \brief  whether a snapshot should be published
+  ///
+  /// \param iter_num current iteration number
+  bool SnapshotDue(int iter_num) const;
+
+  /// \brief  track the features with non-zero weights, e.g. of a loaded
+  // model, as seen at the current iteration
+  void InitBudget();
+
+  /// \brief  evict the stale features and the features of the smallest
+  // weights until the tracked features are 90% of the budget, so that the
+  // scans over the tracked features are amortized
+  ///
+  /// \param t iteration number of the current instance, whose features are
+  // kept
+  void EvictFeatures(int t);
+
  public:
   virtual float model_sparsity();
+  virtual void MemoryUsage(std::vector<MemoryBlock>& blocks) const;
 
  protected:
+  virtual void GetModelInfo(Json::Value& root) const;
   virtual void GetModelParam(std::ostream& os) const;
   math::Vector<real_t>* GetModelWeight() const;
   virtual int SetModelParam(std::istream& is);
+  virtual void GetModelArrays(std::vector<ModelArray>& arrays);
 
  public:
   const math::Vector<real_t>& w(int cls_id) const {
@@ -64,11 +317,48 @@ class OnlineLinearModel : public OnlineModel {
   inline real_t g(int cls_id) const { return this->gradients_[cls_id]; }
   inline real_t& g(int cls_id) { return this->gradients_[cls_id]; }
 
+ protected:
+  // maximum number of features with non-zero weights, 0 for no limit
+  size_t budget_;
+  // features not seen in the last budget_window_ iterations are evicted
+  // first, 0 to evict by the magnitude of the weights only
+  int budget_window_;
+
  private:
   // the first element is zero
   math::Vector<real_t>* weights_;
   // gradients for each class
   real_t* gradients_;
+  // number of training threads
+  int thread_num_;
+  // whether to train with replicas and parameter mixing in multi-threads
+  bool param_mixing_;
+  // number of instances between parameter mixings, 0 to mix at the end only
+  size_t mix_interval_;
+  // whether to update once per mini-batch in single-thread training
+  bool mini_batch_;
+  // coordinator of data-parallel workers
+  dist::Coordinator* coordinator_;
+  // specialized training loops without and with lazy update
+  TrainLoopFunc train_loops_[2];
+  // iteration number when each feature was seen last, 0 if not tracked
+  math::Vector<int> last_seen_;
+  // tracked features, a superset of the features with non-zero weights
+  std::vector<index_t> tracked_;
+  // number of features evicted by the budget
+  size_t evict_num_;
+  InspectBudgetCallback budget_callback_;
+  void* budget_callback_user_context_;
+  // iterations between the snapshots of the weights, 0 for no limit
+  int snapshot_interval_;
+  // milliseconds between the snapshots of the weights, 0 for no limit
+  int snapshot_ms_;
+  // iteration number and time of the last snapshot, checked by the hogwild
+  // threads concurrently
+  std::atomic<int> snapshot_iter_;
+  std::atomic<double> snapshot_time_;
+  // latest snapshot, accessed by std::atomic_load and std::atomic_store
+  std::shared_ptr<const Predictor> snapshot_;
 };  // class OnlineLinearModel
 }  // namespace model
 }  // namespace sol
@@ -10,6 +10,8 @@
 
 #include <sol/model/model.h>
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <sol/pario/data_point.h>
@@ -51,6 +53,34 @@ class OnlineModel : public Model {
   /// \return predicted label
   virtual label_t Iterate(const pario::DataPoint& dp, float* predicts);
 
+ protected:
+  /// \brief  iterate the model over all the data in the data iterator, the
+  // arguments are the same as Train
+  virtual void IterateData(pario::DataIter& data_iter, long long* data_no,
+                           long long* iter_no, float* err_no, float* time_no,
+                           long long* update_no);
+
+  /// \brief  report the current training status to the iterate callback and
+  // the user provided tables
+  virtual void ShowIterInfo(long long* data_no, long long* iter_no,
+                            float* err_no, float* time_no,
+                            long long* update_no);
+
+  /// \brief  called by the training loops after each mini-batch is trained,
+  // when the model is consistent, i.e. not updated by other threads
+  virtual void EndMiniBatch();
+
+  /// \brief  whether a checkpoint should be written
+  ///
+  /// \param data_num number of data trained currently
+  bool CheckpointDue(size_t data_num) const;
+
+  /// \brief  copy the training states and write them to the checkpoint file
+  // in the background, the model should be consistent as in EndMiniBatch
+  ///
+  /// \return false if skipped as the last checkpoint is still being written
+  bool WriteCheckpoint();
+
  protected:
   /// \brief  predict the label of data in the trainig phase
   ///
@@ -74,10 +104,18 @@ class OnlineModel : public Model {
   /// \return status code, Status_OK if load successfully
   virtual int SetModelInfo(const Json::Value& root);
 
+  virtual int SetCheckpointInfo(const Json::Value& root);
+
  protected:
   void set_initial_t(int initial_t);
   virtual void update_dim(index_t dim) { this->dim_ = dim; }
 
+  /// \brief  expand the dimension with update_dim in training, the
+  // reallocations of the model arrays are counted when the stats are enabled
+  ///
+  /// \param dim new dimension, ignored if not larger than the dimension
+  void ExpandDim(index_t dim);
+
  protected:
   inline float bias_eta() const { return this->bias_eta0_ * this->eta_; }
 
@@ -87,6 +125,10 @@ class OnlineModel : public Model {
 
  public:
   int cur_iter_num() const { return this->cur_iter_num_; }////////////////////////////////////////////////////////////////////////////////
+  size_t cur_data_num() const { return this->cur_data_num_; }
+  /// \brief  position of the training data when the checkpoint the model is
+  // loaded from is written, the reader is -1 if unknown
+  const pario::DataPos& resume_pos() const { return this->resume_pos_; }
 
  protected:
   // initial learning rate for bias
@@ -114,6 +156,24 @@ class OnlineModel : public Model {
   // cost sensitive
   bool cost_sensitive_learning_;
   float cost_margin_;
+
+  // path of the checkpoints written during training, empty if disabled
+  std::string checkpoint_path_;
+  // number of data between checkpoints
+  int checkpoint_interval_;
+  // seconds between checkpoints
+  int checkpoint_sec_;
+
+ private:
+  class CheckpointWriter;
+  std::unique_ptr<CheckpointWriter> checkpoint_writer_;
+  // data number and time of the last checkpoint
+  size_t checkpoint_data_num_;
+  double checkpoint_time_;
+  // data iterator being trained on, to record the position in checkpoints
+  pario::DataIter* train_iter_;
+  pario::DataPos resume_pos_;
+
   //////////show iteration info related settings/////////////////
  public:
   class IterDisplayer {
@@ -140,6 +200,10 @@ class OnlineModel : public Model {
     this->iter_callback_ = callback;
     this->iter_callback_user_context_ = user_context;
   }
+  InspectIterateCallback iter_callback() const { return this->iter_callback_; }
+  void* iter_callback_user_context() const {
+    return this->iter_callback_user_context_;
+  }
 
  protected:
   IterDisplayer* iter_displayer_;
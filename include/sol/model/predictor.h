@@ -0,0 +1,160 @@
+/*********************************************************************************
+*     File Name           :     predictor.h
+*     Created By          :     yuewu
+*     Description         :     read-only predictor of linear models
+**********************************************************************************/
+
+#ifndef SOL_MODEL_PREDICTOR_H__
+#define SOL_MODEL_PREDICTOR_H__
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+#include <sol/util/types.h>
+#include <sol/math/vector.h>
+#include <sol/math/operator.h>
+#include <sol/pario/data_point.h>
+#include <sol/pario/mini_batch.h>
+#include <sol/pario/data_iter.h>
+#include <sol/model/online_linear_model.h>
+#include <sol/model/evaluator.h>
+#include <sol/model/feature_cross.h>
+
+namespace sol {
+namespace model {
+
+/// \brief  read-only predictor holding the weights, the normalization and
+// the feature filter of a trained linear model. All the
+// predicting functions are const and do not modify the data, so that they
+// can be called by many threads concurrently.
+class SOL_EXPORTS Predictor {
+ public:
+  /// \brief  create the predictor from a trained model
+  ///
+  /// \param model trained model, finalized by EndTrain if needed
+  /// \param copy_weights whether to copy the weights, otherwise the weights
+  // are shared with the model, which should not be trained or released while
+  // the predictor is used
+  Predictor(OnlineLinearModel &model, bool copy_weights = true);
+
+  /// \brief  create the predictor with the weights finalized by the caller,
+  // e.g. a snapshot of a model in training, the model is not modified
+  ///
+  /// \param model model to take the settings from
+  /// \param weights finalized weights of each classifier, moved into the
+  // predictor
+  Predictor(const OnlineLinearModel &model,
+            std::vector<math::Vector<real_t>> &&weights);
+
+  /// \brief  predict the label of data, the same as Model::PreProcess and
+  // Model::Predict
+  ///
+  /// \param x input data
+  /// \param predicts predicted scores on the data
+  ///
+  /// \return predicted class label
+  label_t Predict(const pario::DataPoint &x, float *predicts) const;
+
+  /// \brief  predict the data of a mini-batch, the data preprocessed by the
+  // model of the predictor on the reader threads are not preprocessed again
+  ///
+  /// \param mb input mini-batch
+  /// \param scores predicted scores, mb.size() by clf_num
+  /// \param labels predicted labels of size mb.size(), ignored if nullptr
+  void PredictBatch(const pario::MiniBatch &mb, float *scores,
+                    label_t *labels = nullptr) const;
+
+  /// \brief  predict the rows of a CSR matrix without converting them to
+  // DataPoint, column j is feature j + 1 as in CsrMatrixReader
+  ///
+  /// \tparam IType type of the indexes, int32_t or int64_t
+  /// \tparam DType type of the values, float or double
+  /// \param indptr offsets of the rows in indices and data, of size
+  // row_num + 1
+  /// \param indices column indexes of the values
+  /// \param data values of the matrix
+  /// \param row_num number of rows
+  /// \param scores predicted scores, row_num by clf_num
+  /// \param labels predicted labels of size row_num, ignored if nullptr
+  template <typename IType, typename DType>
+  void PredictCsr(const IType *indptr, const IType *indices, const DType *data,
+                  size_t row_num, float *scores, label_t *labels) const;
+
+  /// \brief  predict the rows of a dense matrix without converting them to
+  // DataPoint, column j is feature j + 1 as in NumpyReader
+  ///
+  /// \tparam DType type of the values, float or double
+  /// \param X first element of the matrix
+  /// \param row_num number of rows
+  /// \param col_num number of columns
+  /// \param row_stride distance between the rows in bytes
+  /// \param scores predicted scores, row_num by clf_num
+  /// \param labels predicted labels of size row_num, ignored if nullptr
+  template <typename DType>
+  void PredictDense(const DType *X, size_t row_num, size_t col_num,
+                    size_t row_stride, float *scores, label_t *labels) const;
+
+  /// \brief  Test a dataset with multiple threads, see Model::Test, the
+  // results are written in the order of the data
+  ///
+  /// \param data_iter data iterator
+  /// \param os output stream to store the predicted results
+  /// \param thread_num number of threads
+  /// \param evaluator evaluator to accumulate the results, ignored if nullptr,
+  // each thread accumulates its own results which are merged at the end
+  ///
+  /// \return test error rate
+  float Test(pario::DataIter &data_iter, std::ostream *os, int thread_num = 1,
+             Evaluator *evaluator = nullptr) const;
+
+ public:
+  int class_num() const { return this->class_num_; }
+  int clf_num() const { return this->clf_num_; }
+  const math::Vector<real_t> &w(int cls_id) const {
+    return this->weights_[cls_id];
+  }
+
+ protected:
+  /// \brief  predict the features of an instance, Features provides size(),
+  // index(i) and feature(i) like DataPoint
+  template <typename Features>
+  label_t PredictFeatures(const Features &x, float *predicts) const;
+
+  /// \brief  predict an instance already preprocessed by the model, i.e.
+  // filtered, crossed and normalized
+  label_t PredictPreProcessed(const pario::DataPoint &x,
+                              float *predicts) const;
+
+  /// \brief  predicted label of the scores
+  inline label_t PredictLabel(const float *predicts) const {
+    if (this->clf_num_ == 1) {
+      return loss::Loss::Sign(*predicts);
+    } else {
+      return label_t(std::max_element(predicts, predicts + this->clf_num_) -
+                     predicts);
+    }
+  }
+
+  /// \brief  copy the flags of the pre-selected features of the model
+  void CopySelFeatFlags(const OnlineLinearModel &model);
+
+ protected:
+  int class_num_;
+  int clf_num_;
+  math::expr::op::OpType norm_type_;
+  // weights of each classifier
+  std::vector<math::Vector<real_t>> weights_;
+  // flags of the pre-selected features, empty if no features are pre-selected
+  math::Vector<char> sel_feat_flags_;
+  // crosses of the features, generated on the fly
+  FeatureCross feature_cross_;
+  // model the predictor is created from, whose preprocessed mini-batches are
+  // tagged with it
+  const void *source_;
+};
+
+}  // namespace model
+}  // namespace sol
+
+#endif
@@ -4,8 +4,13 @@
 *     Description         :     base class for sparse models
 **********************************************************************************/
 
-#ifndef SOL_MODEL_SPARSE_MODEL_H__
-#define SOL_MODEL_SPARSE_MODEL_H__
+#ifndef SOL_MODEL_REGULARIZER_H__
+#define SOL_MODEL_REGULARIZER_H__
+
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <sol/pario/data_point.h>
 #include <json/json.h>
@@ -36,6 +41,13 @@ class SOL_EXPORTS Regularizer {
   /// info
   virtual void GetRegularizerInfo(Json::Value &root) const;
 
+  /// \brief  get the arrays of the regularization states, which are written
+  // to the checkpoints besides the arrays of the model
+  ///
+  /// \param arrays named state arrays
+  virtual void GetStateArrays(
+      std::vector<std::pair<std::string, math::Vector<real_t> *>> &arrays) {}
+
  public:
   inline real_t lambda() const { return this->lambda_; }
 
@@ -62,6 +74,9 @@ class SOL_EXPORTS OnlineL1Regularizer : public OnlineRegularizer {
   real_t sparse_thresh_;
 };
 
+/// \brief  l1 (or elastic net if lambda2 is set) regularizer applied lazily:
+// the regularization on a feature is delayed until the feature appears again,
+// and then applied for all the delayed steps in closed form
 class SOL_EXPORTS LazyOnlineL1Regularizer : public OnlineL1Regularizer {
  public:
   LazyOnlineL1Regularizer();
@@ -71,14 +86,92 @@ class SOL_EXPORTS LazyOnlineL1Regularizer : public OnlineL1Regularizer {
   virtual void BeginIterate(const pario::DataPoint &dp);
   virtual void EndIterate(const pario::DataPoint &dp, int cur_iter_num);
 
+  virtual void GetRegularizerInfo(Json::Value &root) const;
+
+  virtual void GetStateArrays(
+      std::vector<std::pair<std::string, math::Vector<real_t> *>> &arrays) {
+    arrays.emplace_back("last_update_time", &this->last_update_time_);
+  }
+
+ public:
+  /// \brief  apply the regularization of several steps on a weight, each step
+  // truncates w by eta * lambda / h and then scales w by 1 / (1 + eta *
+  // lambda2 / h)
+  ///
+  /// \param w weight value
+  /// \param eta learning rate
+  /// \param steps number of steps
+  /// \param h per-feature scale of the learning rate
+  ///
+  /// \return regularized weight value
+  inline real_t CatchUp(real_t w, real_t eta, real_t steps,
+                        real_t h = 1) const {
+    if (this->lambda2_ == 0) {
+      return math::expr::truncate(w, (eta * this->lambda_) * steps / h);
+    }
+    real_t decay = powf(1.f + eta * this->lambda2_ / h, -steps);
+    return math::expr::truncate(
+        w * decay, this->lambda_ / this->lambda2_ * (1.f - decay));
+  }
+
+  /// \brief  apply the delayed regularization on the features of dp
+  ///
+  /// \param w weight vector
+  /// \param dp current instance
+  /// \param eta learning rate
+  /// \param t current time
+  /// \param h per-feature scale of the learning rate
+  template <typename EType, int etype>
+  void CatchUp(math::Vector<real_t> &w, const pario::DataPoint &dp, real_t eta,
+               real_t t, const math::expr::Exp<EType, real_t, etype> &h) const {
+    const EType &h_val = h.self();
+    size_t feat_num = dp.size();
+    for (size_t i = 0; i < feat_num; ++i) {
+      index_t idx = dp.index(i);
+      w[idx] = this->CatchUp(w[idx], eta, t - this->last_update_time_[idx],
+                             h_val[idx]);
+    }
+  }
+  void CatchUp(math::Vector<real_t> &w, const pario::DataPoint &dp, real_t eta,
+               real_t t) const {
+    this->CatchUp(w, dp, eta, t, math::expr::MakeExp<real_t>(1));
+  }
+
+  /// \brief  apply the delayed regularization on all the features, call
+  // set_last_update_time after all weight vectors are flushed
+  ///
+  /// \param w weight vector
+  /// \param eta learning rate
+  /// \param t current time
+  /// \param h per-feature scale of the learning rate
+  template <typename EType, int etype>
+  void Flush(math::Vector<real_t> &w, real_t eta, real_t t,
+             const math::expr::Exp<EType, real_t, etype> &h) const {
+    const EType &h_val = h.self();
+    size_t d = w.dim();
+    if (d > this->last_update_time_.dim()) d = this->last_update_time_.dim();
+    for (size_t idx = 0; idx < d; ++idx) {
+      w[idx] = this->CatchUp(w[idx], eta, t - this->last_update_time_[idx],
+                             h_val[idx]);
+    }
+  }
+  void Flush(math::Vector<real_t> &w, real_t eta, real_t t) const {
+    this->Flush(w, eta, t, math::expr::MakeExp<real_t>(1));
+  }
+
  public:
   inline const math::Vector<real_t> &last_update_time() const {
     return this->last_update_time_;
   };
+  /// \brief  mark all the features as updated at time t
+  void set_last_update_time(real_t t) { this->last_update_time_ = t; }
   void set_initial_t(real_t t0) { this->initial_t_ = t0; }
+  inline real_t lambda2() const { return this->lambda2_; }
 
  protected:
   real_t initial_t_;
+  // weight of l2^2 regularization
+  real_t lambda2_;
   // record the last update time of each dimension
   math::Vector<real_t> last_update_time_;
 };
@@ -0,0 +1,107 @@
+/*********************************************************************************
+*     File Name           :     sparse_model.h
+*     Created By          :     yuewu
+*     Description         :     compact read-only linear model with only the
+*                               non-zero weights
+**********************************************************************************/
+
+#ifndef SOL_MODEL_SPARSE_MODEL_H__
+#define SOL_MODEL_SPARSE_MODEL_H__
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <sol/util/types.h>
+#include <sol/math/operator.h>
+#include <sol/pario/data_point.h>
+#include <sol/pario/data_iter.h>
+#include <sol/model/online_linear_model.h>
+#include <sol/model/evaluator.h>
+#include <sol/model/feature_cross.h>
+
+namespace sol {
+namespace model {
+
+/// \brief  linear model keeping only the features with non-zero weights on
+// any classifier, exported from a trained OnlineLinearModel for inference.
+// The weights of a feature on all the classifiers are stored together, and
+// the features of an instance are looked up in the sorted feature indexes.
+class SOL_EXPORTS SparseModel {
+ public:
+  SparseModel();
+
+  /// \brief  build from the weights of a trained model
+  ///
+  /// \param model trained model, finalized by EndTrain if needed
+  ///
+  /// \return status code, Status_OK if succeed
+  int Build(OnlineLinearModel &model);
+
+  /// \brief  save the model in the sparse binary format
+  ///
+  /// \param path path to save the model
+  ///
+  /// \return status code, Status_OK if saved successfully
+  int Save(const std::string &path) const;
+
+  /// \brief  load the model saved by Save
+  ///
+  /// \param path path of the model
+  ///
+  /// \return status code, Status_OK if loaded successfully
+  int Load(const std::string &path);
+
+  /// \brief  whether the file is saved by SparseModel::Save
+  static bool IsSparseModel(const std::string &path);
+
+ public:
+  /// \brief  predict the label of data, the same as Model::PreProcess and
+  // Model::Predict but without modifying the data
+  ///
+  /// \param x input data
+  /// \param predicts predicted scores on the data
+  ///
+  /// \return predicted class label
+  label_t Predict(const pario::DataPoint &x, float *predicts) const;
+
+  /// \brief  Test a dataset, see Model::Test
+  ///
+  /// \param data_iter data iterator
+  /// \param os output stream to store the predicted results
+  /// \param evaluator evaluator to accumulate the results, ignored if nullptr
+  ///
+  /// \return test error rate
+  float Test(pario::DataIter &data_iter, std::ostream *os,
+             Evaluator *evaluator = nullptr) const;
+
+ public:
+  const std::string &name() const { return this->name_; }
+  int class_num() const { return this->class_num_; }
+  int clf_num() const { return this->clf_num_; }
+  index_t dim() const { return this->dim_; }
+  /// \brief  number of features with non-zero weights, including the bias
+  size_t feat_num() const { return this->indexes_.size(); }
+
+ protected:
+  // name of the algorithm of the model
+  std::string name_;
+  int class_num_;
+  int clf_num_;
+  math::expr::op::OpType norm_type_;
+  // dimension of the dense model
+  index_t dim_;
+  // sorted indexes of the features, the first one is the bias
+  std::vector<index_t> indexes_;
+  // weights of indexes_[i] on classifier c are at weights_[i * clf_num_ + c]
+  std::vector<real_t> weights_;
+  // sorted pre-selected features, empty if no features are pre-selected
+  std::vector<index_t> sel_feats_;
+  // crosses of the features, generated on the fly
+  FeatureCross feature_cross_;
+};
+
+}  // namespace model
+}  // namespace sol
+
+#endif
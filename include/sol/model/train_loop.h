@@ -0,0 +1,180 @@
+/*********************************************************************************
+*     File Name           :     train_loop.h
+*     Created By          :     yuewu
+*     Description         :     training loop specialized at compile time
+**********************************************************************************/
+
+#ifndef SOL_MODEL_TRAIN_LOOP_H__
+#define SOL_MODEL_TRAIN_LOOP_H__
+
+#include <algorithm>
+#include <typeinfo>
+#include <vector>
+
+#include <sol/loss/bool_loss.h>
+#include <sol/loss/hinge_loss.h>
+#include <sol/loss/logistic_loss.h>
+#include <sol/loss/square_loss.h>
+#include <sol/model/online_linear_model.h>
+#include <sol/util/stats.h>
+
+namespace sol {
+namespace model {
+
+/// \brief  training loop of the algorithm specialized for the loss function,
+// the number of classifiers and the update condition, so that the loop has no
+// virtual calls or branches on the options per instance. Algo is declared as
+// a friend of the algorithm, and the algorithm selects the loop with
+// TrainLoop<Algo>::Select in SelectTrainLoops.
+template <typename Algo>
+class TrainLoop {
+ public:
+  typedef OnlineLinearModel::TrainLoopFunc TrainLoopFunc;
+
+  /// \brief  select the loops for the loss function of the model
+  ///
+  /// \param model model to train
+  /// \param loops loops without and with lazy update
+  ///
+  /// \return false if the loss function is not specialized
+  static bool Select(Algo* model, TrainLoopFunc* loops) {
+    // derived algorithms may override the functions called in the loop
+    if (typeid(*model) != typeid(Algo)) return false;
+
+    const loss::Loss* loss = model->loss_;
+    if (model->clf_num_ == 1) {
+      return SelectLoss<loss::HingeLoss, true>(loss, loops) ||
+             SelectLoss<loss::LogisticLoss, true>(loss, loops) ||
+             SelectLoss<loss::SquareLoss, true>(loss, loops) ||
+             SelectLoss<loss::BoolLoss, true>(loss, loops);
+    } else {
+      return SelectLoss<loss::MaxScoreHingeLoss, false>(loss, loops) ||
+             SelectLoss<loss::MaxScoreLogisticLoss, false>(loss, loops) ||
+             SelectLoss<loss::MaxScoreBoolLoss, false>(loss, loops);
+    }
+  }
+
+ protected:
+  typedef void (*MiniBatchLoopFunc)(Algo* model, pario::MiniBatch& mb,
+                                    float* predicts, Stats::Local* stats,
+                                    size_t& next_show_time, long long* data_no,
+                                    long long* iter_no, float* err_no,
+                                    float* time_no, long long* update_no);
+
+  template <typename LossType, bool kBinary>
+  static bool SelectLoss(const loss::Loss* loss, TrainLoopFunc* loops) {
+    if (loss == nullptr || typeid(*loss) != typeid(LossType)) return false;
+    loops[0] = Run<LossType, kBinary, false>;
+    loops[1] = Run<LossType, kBinary, true>;
+    return true;
+  }
+
+  /// \brief  the same as OnlineModel::IterateData with the Iterate of
+  // OnlineLinearModel without regularizer, active learning or cost-sensitive
+  // learning
+  template <typename LossType, bool kBinary, bool kLazy>
+  static void Run(OnlineLinearModel* base, pario::DataIter& data_iter,
+                  long long* data_no, long long* iter_no, float* err_no,
+                  float* time_no, long long* update_no) {
+    Algo* model = static_cast<Algo*>(base);
+
+    size_t next_show_time = size_t(-1);
+    if (model->iter_displayer_ != nullptr) {
+      next_show_time = model->iter_displayer_->next_show_time();
+    }
+
+    int clf_num = kBinary ? 1 : model->clf_num_;
+    std::vector<float> predicts(clf_num);
+
+    // loops of a mini-batch indexed by whether to time the stages and
+    // whether to track the features for the budget
+    static const MiniBatchLoopFunc mini_batch_loops[2][2] = {
+        {RunMiniBatch<LossType, kBinary, kLazy, false, false>,
+         RunMiniBatch<LossType, kBinary, kLazy, false, true>},
+        {RunMiniBatch<LossType, kBinary, kLazy, true, false>,
+         RunMiniBatch<LossType, kBinary, kLazy, true, true>}};
+
+    pario::MiniBatch* mb = nullptr;
+    while (1) {
+      mb = data_iter.Next(mb);
+      if (mb == nullptr) break;
+
+      // expand the dimension once per mini-batch
+      index_t dim = 0;
+      for (int i = 0; i < mb->size(); ++i) {
+        dim = (std::max)(dim, (*mb)[i].dim());
+      }
+      model->ExpandDim(dim);
+
+      // the counters and the weight budget are selected per mini-batch, so
+      // that the loop has no branches on them
+      Stats::Local* stats = Stats::local();
+      mini_batch_loops[stats != nullptr][model->budget_ > 0](
+          model, *mb, predicts.data(), stats, next_show_time, data_no, iter_no,
+          err_no, time_no, update_no);
+      model->EndMiniBatch();
+    }
+  }
+
+  /// \brief  train the instances of a mini-batch
+  ///
+  /// \tparam kStats whether to time the stages with the pipeline counters
+  /// \tparam kBudget whether to track the features for the weight budget
+  template <typename LossType, bool kBinary, bool kLazy, bool kStats,
+            bool kBudget>
+  static void RunMiniBatch(Algo* model, pario::MiniBatch& mb, float* predicts,
+                           Stats::Local* stats, size_t& next_show_time,
+                           long long* data_no, long long* iter_no,
+                           float* err_no, float* time_no,
+                           long long* update_no) {
+    LossType* loss = static_cast<LossType*>(model->loss_);
+    int clf_num = kBinary ? 1 : model->clf_num_;
+    real_t* gradients = &model->g(0);
+    bool preprocessed = model->IsPreProcessed(mb);
+
+    for (int i = 0; i < mb.size(); ++i) {
+      pario::DataPoint& x = mb[i];
+      if (!preprocessed) model->PreProcess(x);
+      ++model->cur_iter_num_;
+      ++model->cur_data_num_;
+      if (kBudget) model->TrackFeatures(x, model->cur_iter_num_);
+
+      uint64_t start_time = kStats ? Stats::now_ns() : 0;
+      label_t label;
+      if (kBinary) {
+        const math::Vector<real_t>& w = model->w(0);
+        predicts[0] = math::expr::dotmul(w, x.data()) + w[0];
+        label = loss::Loss::Sign(predicts[0]);
+      } else {
+        for (int c = 0; c < clf_num; ++c) {
+          const math::Vector<real_t>& w = model->w(c);
+          predicts[c] = math::expr::dotmul(w, x.data()) + w[0];
+        }
+        label = label_t(std::max_element(predicts, predicts + clf_num) -
+                        predicts);
+      }
+
+      if (kStats) start_time = stats->Lap(Stats::kPredictNs, start_time);
+      float loss_val =
+          loss->LossType::gradient(x, predicts, label, gradients, clf_num);
+      if (kStats) start_time = stats->Lap(Stats::kLossNs, start_time);
+      if (kLazy ? label != x.label() : loss_val > 0) {
+        ++model->update_num_;
+        model->Algo::Update(x, predicts, loss_val);
+      }
+      if (kStats) stats->Lap(Stats::kUpdateNs, start_time);
+      if (label != x.label()) ++model->cur_err_num_;
+
+      if (model->cur_data_num_ >= next_show_time) {
+        model->ShowIterInfo(data_no, iter_no, err_no, time_no, update_no);
+        model->iter_displayer_->next();
+        next_show_time = model->iter_displayer_->next_show_time();
+      }
+    }
+  }
+};
+
+}  // namespace model
+}  // namespace sol
+
+#endif
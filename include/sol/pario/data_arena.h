@@ -0,0 +1,85 @@
+/*********************************************************************************
+*     File Name           :     data_arena.h
+*     Created By          :     yuewu
+*     Description         :     in-memory dataset in CSR layout
+**********************************************************************************/
+
+#ifndef SOL_PARIO_DATA_ARENA_H__
+#define SOL_PARIO_DATA_ARENA_H__
+
+#include <mutex>
+#include <vector>
+
+#include <sol/util/types.h>
+#include <sol/pario/data_point.h>
+#include <sol/pario/mini_batch.h>
+#include <sol/pario/data_iter.h>
+
+namespace sol {
+namespace pario {
+
+/// \brief  read-only dataset loaded in memory once, the features of all the
+// data are stored in three arrays like a CSR matrix, so that the dataset can
+// be iterated by multiple threads without parsing the data again
+class SOL_EXPORTS DataArena {
+ public:
+  DataArena() : indptr_(1, 0), dim_(0) {}
+
+  /// \brief  load all the data of a data iterator
+  ///
+  /// \param data_iter data iterator
+  ///
+  /// \return status code, Status_OK if succeed
+  int Load(DataIter &data_iter);
+
+  /// \brief  append a data point to the end of the dataset
+  void Append(const DataPoint &x);
+
+  /// \brief  copy the i-th data to a data point
+  void CopyTo(size_t i, DataPoint &dst_pt) const;
+
+ public:
+  size_t size() const { return this->labels_.size(); }
+  index_t dim() const { return this->dim_; }
+  label_t label(size_t i) const { return this->labels_[i]; }
+
+ protected:
+  std::vector<label_t> labels_;
+  // features of the i-th data are in [indptr_[i], indptr_[i + 1])
+  std::vector<size_t> indptr_;
+  std::vector<index_t> indexes_;
+  std::vector<real_t> features_;
+  index_t dim_;
+};
+
+/// \brief  data iterator over the selected data of an arena in the given
+// order, the data are copied to the mini-batches of the iterator. Next can be
+// called concurrently, e.g. by hogwild training threads, each call claims the
+// next rows of the mini-batch.
+class SOL_EXPORTS ArenaIter : public DataIter {
+ public:
+  /// \brief  create an iterator over the data of an arena
+  ///
+  /// \param arena dataset, should be alive when iterating
+  /// \param rows indexes of the data to iterate in order
+  /// \param pass_num number of passes to iterate the data
+  /// \param batch_size size of mini-batches
+  ArenaIter(const DataArena &arena, const std::vector<size_t> &rows,
+            int pass_num = 1, int batch_size = 256);
+
+  virtual MiniBatch *Next(MiniBatch *prev_batch = nullptr);
+
+ protected:
+  const DataArena &arena_;
+  std::vector<size_t> rows_;
+  int pass_num_;
+  // current pass and position in rows_, guarded by pos_mutex_
+  int pass_;
+  size_t pos_;
+  std::mutex pos_mutex_;
+};
+
+}  // namespace pario
+}  // namespace sol
+
+#endif
@@ -17,6 +17,7 @@
 #include <sol/pario/mini_batch.h>
 #include <sol/pario/data_reader.h>
 #include <sol/pario/data_read_task.h>
+#include <sol/pario/transform.h>
 #include <sol/util/block_queue.h>
 
 namespace sol {
@@ -41,6 +42,20 @@ class SOL_EXPORTS DataIter {
   int AddReader(const std::string& path, const std::string& dtype,
                 int pass_num = 1);
 
+  /// \brief  add transforms applied to the mini-batches before they are
+  // returned by Next, should be called before the first call of Next
+  ///
+  /// \param spec transforms in the format of Transform::CreateList
+  ///
+  /// \return status code, Status_OK if succeed
+  int AddTransform(const std::string& spec);
+
+  /// \brief  add a transform applied to the mini-batches before they are
+  // returned by Next, should be called before the first call of Next
+  void AddTransform(const std::shared_ptr<Transform>& trans) {
+    this->transforms_.push_back(trans);
+  }
+
   /// \brief  get the next mini-batch
   ///
   /// \param prev_batch previously used mini-batch for recycle
@@ -48,6 +63,40 @@ class SOL_EXPORTS DataIter {
   /// \return
   virtual MiniBatch* Next(MiniBatch* prev_batch = nullptr);
 
+  /// \brief  return a used mini-batch without getting the next one, so that
+  // the readers can reuse it
+  ///
+  /// \param batch used mini-batch
+  void Recycle(MiniBatch* batch) { this->mini_batch_factory_.Enqueue(batch); }
+
+  /// \brief  skip the data before a position returned by position, should be
+  // called before the first call of Next with the same readers added
+  ///
+  /// \param pos position of the data
+  ///
+  /// \return status code, Status_OK if succeed
+  int Seek(const DataPos& pos);
+
+  /// \brief  get the position after the data returned by Next
+  ///
+  /// \param pos position of the data
+  ///
+  /// \return false if the position is unknown, e.g. the data are read from
+  // stdin or the iterator is not backed by the readers
+  bool position(DataPos& pos);
+
+  /// \brief  size of the mini-batches
+  int batch_size() const { return this->batch_size_; }
+
+ protected:
+  /// \brief  apply the transforms to a mini-batch, for the iterators filling
+  // the mini-batches without readers
+  void ApplyTransforms(MiniBatch& mb) const {
+    for (const std::shared_ptr<Transform>& trans : this->transforms_) {
+      trans->Apply(mb);
+    }
+  }
+
  protected:
   // mini-batch size
   int batch_size_;
@@ -55,10 +104,15 @@ class SOL_EXPORTS DataIter {
   BlockQueue<MiniBatch*> mini_batch_factory_;
   // mini-batch number in buffer
   BlockQueue<MiniBatch*> mini_batch_buf_;
+  // transforms of the mini-batches, applied by the readers
+  std::vector<std::shared_ptr<Transform>> transforms_;
   // data reader threads
   std::vector<std::shared_ptr<DataReadTask>> readers_;
   // index of running reader
   int running_reader_idx_;
+  // position after the data returned by Next
+  DataPos pos_;
+  Mutex pos_mutex_;
 };  // class DataIter
 }  // namespace pario
 }  // namespace sol
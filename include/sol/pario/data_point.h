@@ -56,6 +56,9 @@ class SOL_EXPORTS DataPoint {
   /// \brief  Sort the features so that indexes are from small to large
   void Sort();
 
+  /// \brief  sum the features of the same index, the indexes should be sorted
+  void MergeDuplicates();
+
  public:
   inline const math::SVector<real_t>& data() const { return data_; }
   inline math::SVector<real_t>& data() { return data_; }
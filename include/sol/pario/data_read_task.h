@@ -11,6 +11,7 @@
 #include <sol/pario/data_point.h>
 #include <sol/pario/mini_batch.h>
 #include <sol/pario/data_reader.h>
+#include <sol/pario/transform.h>
 #include <sol/util/block_queue.h>
 #include <sol/util/thread_task.h>
 
@@ -27,13 +28,26 @@ class DataReadTask : public ThreadTask {
   /// \param mini_batch_factory factory of empty mini batch
   /// \param mini_batch_buf place to store the loaded mini batched
   /// \param pass_num number of passes to read the data
+  /// \param transforms transforms applied to the loaded mini batches
+  /// \param index index of the reader in the data iterator
   DataReadTask(const std::string& path, const std::string& dtype,
                BlockQueue<MiniBatch*>& mini_batch_factory,
-               BlockQueue<MiniBatch*>& mini_batch_buf, int pass_num);
+               BlockQueue<MiniBatch*>& mini_batch_buf, int pass_num,
+               const std::vector<std::shared_ptr<Transform>>& transforms,
+               int index = 0);
 
  public:
   inline bool Good() { return this->reader_ != nullptr; }
 
+  /// \brief  skip the data before a position, should be called before Start
+  ///
+  /// \param pass number of finished passes
+  /// \param offset position of the reader in the pass, -1 to start from the
+  // beginning of the pass
+  ///
+  /// \return Status code, Status_OK if succeed
+  int Seek(int pass, int64_t offset);
+
  protected:
   virtual void run();
 
@@ -42,6 +56,10 @@ class DataReadTask : public ThreadTask {
   BlockQueue<MiniBatch*>& mini_batch_factory_;
   BlockQueue<MiniBatch*>& mini_batch_buf_;
   int pass_num_;
+  // number of finished passes
+  int pass_;
+  int index_;
+  const std::vector<std::shared_ptr<Transform>>& transforms_;
 };
 
 }  // namespace pario
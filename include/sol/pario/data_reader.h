@@ -46,6 +46,29 @@ class SOL_EXPORTS DataReader {
   /// \brief  Rewind the dataset to the beginning of the file
   virtual void Rewind() = 0;
 
+  /// \brief  set parameters of the reader, called before Open, the
+  // parameters are given with the type in Create as 'type:param=val,...'
+  ///
+  /// \param name name of the parameter
+  /// \param value value of the parameter in string
+  virtual void SetParameter(const std::string& name, const std::string& value);
+
+  /// \brief  get the position of the next data point to read
+  ///
+  /// \return position of the data, -1 if the reader can not seek
+  virtual int64_t Tell() { return -1; }
+
+  /// \brief  move to the position returned by Tell
+  ///
+  /// \param pos position of the data
+  ///
+  /// \return Status code, Status_OK if succeed
+  virtual int Seek(int64_t pos) { return Status_Invalid_Argument; }
+
+  /// \brief  number of bytes read from the file since opened, zero if the
+  // data are not read from a file
+  virtual uint64_t read_bytes() const { return 0; }
+
  public:
   /// \brief  Read next data point
   ///
@@ -75,6 +98,12 @@ class SOL_EXPORTS DataFileReader : public DataReader {
   /// \brief  Rewind the dataset to the beginning of the file
   virtual void Rewind() { this->file_reader_.Rewind(); }
 
+  virtual int64_t Tell() { return this->file_reader_.Tell(); }
+  virtual int Seek(int64_t pos) { return this->file_reader_.Seek(pos); }
+  virtual uint64_t read_bytes() const {
+    return this->file_reader_.read_bytes();
+  }
+
  public:
   /// \brief  Read next data point
   ///
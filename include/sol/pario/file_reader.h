@@ -9,6 +9,7 @@
 #ifndef SOL_PARIO_FILE_READER_H__
 #define SOL_PARIO_FILE_READER_H__
 
+#include <cstdint>
 #include <cstdio>
 #include <sol/util/types.h>
 
@@ -48,6 +49,22 @@ class SOL_EXPORTS FileReader {
    */
   void Rewind();
 
+  /**
+   * \brief  Get the position of the next byte to read
+   *
+   * \return position in bytes, -1 if the file can not seek (e.g. stdin)
+   */
+  int64_t Tell();
+
+  /**
+   * \brief  Move to the position returned by Tell
+   *
+   * \param pos position in bytes
+   *
+   * \return Status code, Status_OK if succeed
+   */
+  int Seek(int64_t pos);
+
   /**
    * Good : Test if the file reader is good
    *
@@ -77,9 +94,13 @@ class SOL_EXPORTS FileReader {
    */
   int ReadLine(char*& dst, int& dst_len);
 
+  /// \brief  number of bytes read since the file is opened
+  uint64_t read_bytes() const { return this->read_bytes_; }
+
  private:
   FILE* file_;
   ReadMode mode_;
+  uint64_t read_bytes_;
 };  // class FileReader
 
 }  // namespace pario
@@ -9,6 +9,7 @@
 #ifndef SOL_PARIO_MINI_BATCH_H__
 #define SOL_PARIO_MINI_BATCH_H__
 
+#include <cstdint>
 #include <vector>
 
 #include <sol/util/types.h>
@@ -17,10 +18,24 @@
 namespace sol {
 namespace pario {
 
+/// \brief  position of the data read by a data iterator
+struct DataPos {
+  // index of the reader in the data iterator, -1 if unknown
+  int reader;
+  // number of passes finished by the reader
+  int pass;
+  // position of the reader returned by DataReader::Tell
+  int64_t offset;
+};
+
 class SOL_EXPORTS MiniBatch {
  public:
   MiniBatch(int batch_size = 0)
-      : data_num(0), points_(nullptr), capacity_(batch_size) {
+      : data_num(0),
+        preprocessor(nullptr),
+        pos{-1, 0, -1},
+        points_(nullptr),
+        capacity_(batch_size) {
     this->points_ = new DataPoint[this->capacity_];
   }
   ~MiniBatch() {
@@ -39,6 +54,11 @@ class SOL_EXPORTS MiniBatch {
   inline DataPoint& operator[](size_t index) { return this->points_[index]; }
 
   int data_num;
+  // owner of the preprocessing already applied to the data by the data
+  // iterator (e.g. the model), nullptr if the data are raw
+  const void* preprocessor;
+  // position of the reader after the data of the mini-batch
+  DataPos pos;
 
  private:
   DataPoint* points_;
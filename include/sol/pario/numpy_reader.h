@@ -35,6 +35,9 @@ class SOL_EXPORTS NumpyReader : public DataReader {
 
   virtual void Rewind();
 
+  virtual int64_t Tell() { return this->x_idx_; }
+  virtual int Seek(int64_t pos);
+
  public:
   virtual int Next(DataPoint& dst_data);
 
@@ -0,0 +1,127 @@
+/*********************************************************************************
+*     File Name           :     transform.h
+*     Created By          :     yuewu
+*     Description         :     transforms of the data in mini-batches
+**********************************************************************************/
+
+#ifndef SOL_PARIO_TRANSFORM_H__
+#define SOL_PARIO_TRANSFORM_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sol/util/reflector.h>
+#include <sol/util/types.h>
+#include <sol/pario/data_point.h>
+#include <sol/pario/mini_batch.h>
+
+namespace sol {
+namespace pario {
+
+/// \brief  transform of the data in mini-batches, applied by the data
+// iterator before the mini-batches are returned, so that the consumers get
+// ready-to-use data. The transforms are applied by the reader threads (or the
+// threads calling Next for in-memory iterators) concurrently, so Apply should
+// not modify the transform.
+class SOL_EXPORTS Transform {
+  DeclareReflectorBase(Transform);
+
+ public:
+  virtual ~Transform() {}
+
+  /// \brief  set parameters of the transform
+  ///
+  /// \param name name of the parameter
+  /// \param value value of the parameter in string
+  virtual void SetParameter(const std::string &name, const std::string &value);
+
+  /// \brief  transform a data point
+  virtual void Apply(DataPoint &x) const = 0;
+
+  /// \brief  transform the data of a mini-batch
+  virtual void Apply(MiniBatch &mb) const {
+    for (int i = 0; i < mb.size(); ++i) this->Apply(mb[i]);
+  }
+
+  /// \brief  create the transforms of a specification
+  ///
+  /// \param spec transforms separated by ';', each transform is in the format
+  // 'name' or 'name:param=val,param=val'
+  /// \param transforms created transforms in order
+  ///
+  /// \return status code, Status_OK if succeed
+  static int CreateList(const std::string &spec,
+                        std::vector<std::shared_ptr<Transform>> &transforms);
+};
+
+/// \brief  L1 or L2 normalization of the features, the same as Model
+// normalization. params: type=l1|l2
+class SOL_EXPORTS NormTransform : public Transform {
+ public:
+  NormTransform() : l2_(true) {}
+  virtual void SetParameter(const std::string &name, const std::string &value);
+  virtual void Apply(DataPoint &x) const;
+
+ protected:
+  bool l2_;
+};
+
+/// \brief  remove the features not selected. params: path=file of selected
+// feature indexes (the same format as the 'filter' option of models)
+class SOL_EXPORTS FilterTransform : public Transform {
+ public:
+  virtual void SetParameter(const std::string &name, const std::string &value);
+  virtual void Apply(DataPoint &x) const;
+
+ protected:
+  // flags of the selected features
+  std::vector<char> sel_feat_flags_;
+};
+
+/// \brief  binarize the features, the same as the converter tool.
+// params: thresh=value, features larger than thresh are 1, otherwise -1
+class SOL_EXPORTS BinarizeTransform : public Transform {
+ public:
+  BinarizeTransform() : thresh_(0) {}
+  virtual void SetParameter(const std::string &name, const std::string &value);
+  virtual void Apply(DataPoint &x) const;
+
+ protected:
+  real_t thresh_;
+};
+
+/// \brief  clip the features to a range. params: min=value, max=value
+class SOL_EXPORTS ClipTransform : public Transform {
+ public:
+  ClipTransform();
+  virtual void SetParameter(const std::string &name, const std::string &value);
+  virtual void Apply(DataPoint &x) const;
+
+ protected:
+  real_t min_;
+  real_t max_;
+};
+
+/// \brief  hash the feature indexes to [1, 2^bits], features of the same
+// hashed index are summed. params: bits=number of bits
+class SOL_EXPORTS HashTransform : public Transform {
+ public:
+  HashTransform() : bits_(18) {}
+  virtual void SetParameter(const std::string &name, const std::string &value);
+  virtual void Apply(DataPoint &x) const;
+
+ protected:
+  int bits_;
+};
+
+#define RegisterTransform(type, name, descr)                             \
+  type *type##_##CreateNewInstance() { return new type(); }              \
+  ClassInfo __kClassInfo_##type##__(std::string(name) + "_transform",    \
+                                    (void *)(type##_##CreateNewInstance), \
+                                    descr);
+
+}  // namespace pario
+}  // namespace sol
+
+#endif
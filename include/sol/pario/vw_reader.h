@@ -0,0 +1,46 @@
+/*********************************************************************************
+*     File Name           :     vw_reader.h
+*     Created By          :     yuewu
+*     Description         :     reader of vowpal wabbit format data
+**********************************************************************************/
+
+#ifndef SOL_PARIO_VW_READER_H__
+#define SOL_PARIO_VW_READER_H__
+
+#include <sol/pario/data_reader.h>
+
+namespace sol {
+namespace pario {
+
+/// \brief  reader of text data in the vowpal wabbit format:
+// 'label [importance] [tag]|namespace[:scale] name[:value] ...|namespace ...'.
+// The feature names are hashed with murmur hash 3 seeded by the namespace
+// into [1, 2^bits] without a dictionary, features of the same hashed index
+// are summed. The importance and the tag are ignored.
+// params: bits=number of bits of the hashed space, 18 by default
+class SOL_EXPORTS VWReader : public DataFileReader {
+ public:
+  VWReader();
+
+  virtual void SetParameter(const std::string& name, const std::string& value);
+
+  /// \brief  Read next data point
+  ///
+  /// \param dst_data Destination data point
+  ///
+  /// \return  Status code, Status_OK if everything ok, Status_EndOfFile if
+  /// read to file end
+  virtual int Next(DataPoint& dst_data);
+
+ public:
+  int bits() const { return this->bits_; }
+
+ protected:
+  int bits_;
+  uint32_t mask_;
+};  // class VWReader
+
+}  // namespace pario
+}  // namespace sol
+
+#endif
@@ -0,0 +1,72 @@
+/*********************************************************************************
+*     File Name           :     hash.h
+*     Created By          :     yuewu
+*     Description         :     hash functions of feature indexes
+**********************************************************************************/
+#ifndef SOL_UTIL_HASH_H__
+#define SOL_UTIL_HASH_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sol {
+
+/// \brief  finalization mix of murmur hash 3, scatters close integers
+inline uint32_t fmix32(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+/// \brief  32-bit murmur hash 3 of a byte string
+///
+/// \param key bytes to hash
+/// \param len number of bytes
+/// \param seed hash seed
+inline uint32_t murmur3_32(const char* key, size_t len, uint32_t seed) {
+  const uint32_t c1 = 0xcc9e2d51;
+  const uint32_t c2 = 0x1b873593;
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(key);
+  size_t block_num = len / 4;
+  uint32_t h = seed;
+  for (size_t i = 0; i < block_num; ++i) {
+    const unsigned char* p = data + i * 4;
+    uint32_t k = uint32_t(p[0]) | (uint32_t(p[1]) << 8) |
+                 (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    k *= c1;
+    k = (k << 15) | (k >> 17);
+    k *= c2;
+    h ^= k;
+    h = (h << 13) | (h >> 19);
+    h = h * 5 + 0xe6546b64;
+  }
+
+  const unsigned char* tail = data + block_num * 4;
+  uint32_t k = 0;
+  switch (len & 3) {
+    case 3:
+      k ^= uint32_t(tail[2]) << 16;
+    case 2:
+      k ^= uint32_t(tail[1]) << 8;
+    case 1:
+      k ^= tail[0];
+      k *= c1;
+      k = (k << 15) | (k >> 17);
+      k *= c2;
+      h ^= k;
+  }
+  h ^= uint32_t(len);
+  return fmix32(h);
+}
+
+/// \brief  combine a hash value with an integer, order dependent
+inline uint32_t hash_combine(uint32_t seed, uint32_t val) {
+  return fmix32(seed ^ (val * 0xcc9e2d51 + 0x9e3779b9));
+}
+
+}  // namespace sol
+
+#endif
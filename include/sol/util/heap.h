@@ -7,6 +7,8 @@
 #ifndef SOL_UTIL_HEAP_H__
 #define SOL_UTIL_HEAP_H__
 
+#include <algorithm>
+#include <functional>
 #include <stdexcept>
 
 #include <sol/math/vector.h>
@@ -44,6 +46,16 @@ class Heap {
   /// \brief  build the heap so that r[0,K) is a heap
   void BuildHeap();
 
+  /// \brief  mark that the value of an element has changed, the heap is
+  // repaired by the next call to AdjustMarkedHeap
+  ///
+  /// \param idx index of the changed element
+  void MarkUpdated(index_t idx);
+
+  /// \brief  repair the heap after MarkUpdated, the result is the same as
+  // BuildHeap, but only the marked positions and their ancestors are visited
+  void AdjustMarkedHeap();
+
   /// \brief  heap sort
   void HeapSort();
 
@@ -65,9 +77,31 @@ class Heap {
   /// \brief  release memory, for Init or destructor
   void Release();
 
+  /// \brief  capacity of a map, the storage is not allocated if empty
+  template <typename T>
+  static size_t capacity(const math::Vector<T>& vec) {
+    return vec.size() > 0 ? vec.capacity() : 0;
+  }
+
  public:
   inline index_t K() const { return K_; }
 
+  /// \brief  bytes of the elements of the maps in use
+  size_t used_bytes() const {
+    return this->id2pos_map_.size() * sizeof(index_t) +
+           this->pos2id_map_.size() * sizeof(index_t) +
+           this->pos_marks_.size() * sizeof(char) +
+           this->marked_pos_.size() * sizeof(index_t);
+  }
+
+  /// \brief  bytes allocated by the maps
+  size_t allocated_bytes() const {
+    return capacity(this->id2pos_map_) * sizeof(index_t) +
+           capacity(this->pos2id_map_) * sizeof(index_t) +
+           capacity(this->pos_marks_) * sizeof(char) +
+           capacity(this->marked_pos_) * sizeof(index_t);
+  }
+
   inline index_t get_pos(index_t idx) const { return this->id2pos_map_[idx]; }
 
   inline bool isTopK(index_t idx) const {
@@ -94,6 +128,11 @@ class Heap {
 
   // data index for sorted position
   math::Vector<index_t> pos2id_map_;
+
+  // whether a position in heap is marked to be adjusted
+  math::Vector<char> pos_marks_;
+  // positions marked to be adjusted
+  math::Vector<index_t> marked_pos_;
 };
 
 template <typename comparator>
@@ -111,6 +150,8 @@ void Heap<comparator>::Init(index_t N, index_t K, const real_t* values) {
   for (index_t i = 0; i != K; ++i) {
     this->pos2id_map_[i] = i;
   }
+  this->pos_marks_.resize(K);
+  this->pos_marks_ = 0;
 
   this->values_ = values;
   this->BuildHeap();
@@ -136,6 +177,8 @@ void Heap<comparator>::Init(index_t N, index_t K, const index_t* indexes,
   for (index_t i = 0; i != K; ++i) {
     this->id2pos_map_[this->pos2id_map_[i]] = i;
   }
+  this->pos_marks_.resize(K);
+  this->pos_marks_ = 0;
 
   this->values_ = values;
   this->BuildHeap();
@@ -149,6 +192,34 @@ void Heap<comparator>::BuildHeap() {
   } while (i > 0);
 }
 
+template <typename comparator>
+void Heap<comparator>::MarkUpdated(index_t idx) {
+  index_t pos = this->id2pos_map_[idx];
+  if (pos >= this->K_) return;
+  // mark the position and its ancestors, stop at a marked one as its
+  // ancestors are already marked
+  while (this->pos_marks_[pos] == 0) {
+    this->pos_marks_[pos] = 1;
+    this->marked_pos_.push_back(pos);
+    if (pos == 0) break;
+    pos = (pos - 1) / 2;
+  }
+}
+
+template <typename comparator>
+void Heap<comparator>::AdjustMarkedHeap() {
+  // BuildHeap adjusts from the bottom to the top, positions that are not
+  // marked keep valid sub-heaps and the adjustment on them takes no effect
+  std::sort(this->marked_pos_.begin(), this->marked_pos_.end(),
+            std::greater<index_t>());
+  for (const index_t* iter = this->marked_pos_.begin();
+       iter != this->marked_pos_.end(); ++iter) {
+    this->AdjustHeap(*iter, this->K_ - 1);
+    this->pos_marks_[*iter] = 0;
+  }
+  this->marked_pos_.clear();
+}
+
 template <typename comparator>
 void Heap<comparator>::HeapSort() {
   this->BuildHeap();
@@ -220,6 +291,8 @@ void Heap<comparator>::Release() {
   this->values_ = nullptr;
   this->id2pos_map_.resize(0);
   this->pos2id_map_.resize(0);
+  this->pos_marks_.resize(0);
+  this->marked_pos_.resize(0);
 }
 
 template <typename comparator>
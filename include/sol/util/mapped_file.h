@@ -0,0 +1,51 @@
+/*********************************************************************************
+*     File Name           :     mapped_file.h
+*     Created By          :     yuewu
+*     Description         :     file mapped into memory
+**********************************************************************************/
+
+#ifndef SOL_UTIL_MAPPED_FILE_H__
+#define SOL_UTIL_MAPPED_FILE_H__
+
+#include <string>
+
+#include <sol/util/types.h>
+#include <sol/util/util.h>
+
+namespace sol {
+
+/// \brief  file mapped privately into memory, the pages are loaded on demand
+// and shared with other processes mapping the same file until they are
+// written. The file is read into memory on platforms without mmap.
+class SOL_EXPORTS MappedFile {
+ public:
+  MappedFile();
+  ~MappedFile();
+
+  /// \brief  map the whole file into memory
+  ///
+  /// \param path path of the file
+  ///
+  /// \return status code, Status_OK if succeed
+  int Open(const std::string& path);
+
+  /// \brief  unmap the file, the memory of the file should not be used any more
+  void Close();
+
+ public:
+  inline char* data() { return this->data_; }
+  inline const char* data() const { return this->data_; }
+  inline size_t size() const { return this->size_; }
+
+ private:
+  char* data_;
+  size_t size_;
+  // whether data_ is mapped or allocated
+  bool mapped_;
+
+  DISABLE_COPY_AND_ASSIGN(MappedFile);
+};
+
+}  // namespace sol
+
+#endif
@@ -22,6 +22,31 @@ inline FILE* open_file(const char* path, const char* mode) {
   return file;
 }
 
+inline double get_thread_cpu_time() {
+  FILETIME create_time, exit_time, kernel_time, user_time;
+  if (GetThreadTimes(GetCurrentThread(), &create_time, &exit_time,
+                     &kernel_time, &user_time) == 0) {
+    return 0;
+  }
+  ULARGE_INTEGER kernel, user;
+  kernel.LowPart = kernel_time.dwLowDateTime;
+  kernel.HighPart = kernel_time.dwHighDateTime;
+  user.LowPart = user_time.dwLowDateTime;
+  user.HighPart = user_time.dwHighDateTime;
+  // in 100 nanoseconds
+  return double(kernel.QuadPart + user.QuadPart) * 1e-7;
+}
+
+inline int64_t tell_file(FILE* file) { return _ftelli64(file); }
+
+inline bool seek_file(FILE* file, int64_t pos) {
+  return _fseeki64(file, pos, SEEK_SET) == 0;
+}
+
+inline bool replace_file(const char* src_path, const char* dst_path) {
+  return MoveFileExA(src_path, dst_path, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
 }  // namespace sol
 
 #endif  // SOL_UTIL_PLATFORM_WIN32_H__
@@ -9,12 +9,31 @@
 #ifndef SOL_UTIL_PLATFORM_XNIX_H__
 #define SOL_UTIL_PLATFORM_XNIX_H__
 
+#include <stdio.h>
+#include <time.h>
+
 namespace sol {
 
 inline FILE* open_file(const char* path, const char* mode) {
   return fopen(path, mode);
 }
 
+inline double get_thread_cpu_time() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+  return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+}
+
+inline int64_t tell_file(FILE* file) { return int64_t(ftello(file)); }
+
+inline bool seek_file(FILE* file, int64_t pos) {
+  return fseeko(file, off_t(pos), SEEK_SET) == 0;
+}
+
+inline bool replace_file(const char* src_path, const char* dst_path) {
+  return rename(src_path, dst_path) == 0;
+}
+
 }  // namespace sol
 
 #endif
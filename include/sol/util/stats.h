@@ -0,0 +1,126 @@
+/*********************************************************************************
+*     File Name           :     stats.h
+*     Created By          :     yuewu
+*     Description         :     counters of the stages of the training pipeline
+**********************************************************************************/
+
+#ifndef SOL_UTIL_STATS_H__
+#define SOL_UTIL_STATS_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <sol/util/types.h>
+
+namespace sol {
+
+/// \brief  counters of the stages of the training pipeline summed over the
+// threads, times are in nanoseconds
+struct PipelineStats {
+  // time of the readers to parse the data
+  uint64_t parse_ns;
+  // number of data parsed
+  uint64_t parse_num;
+  // bytes read from the data files
+  uint64_t read_bytes;
+  // time of the readers waiting for free mini-batches
+  uint64_t reader_wait_ns;
+  // time of the trainers waiting for parsed mini-batches
+  uint64_t trainer_wait_ns;
+  // time to predict the data in training
+  uint64_t predict_ns;
+  // time to compute the losses and gradients
+  uint64_t loss_ns;
+  // time to update the models
+  uint64_t update_ns;
+  // number of model arrays reallocated to expand the dimension
+  uint64_t realloc_num;
+  // bytes of the reallocated model arrays
+  uint64_t realloc_bytes;
+};
+
+/// \brief  instrumentation of the training pipeline. Each thread adds to its
+// own counters returned by local(), which is nullptr when the stats are
+// disabled so that the instrumented code skips the timing, and the counters
+// of all the threads are summed by Collect.
+class SOL_EXPORTS Stats {
+ public:
+  /// \brief  counters in the order of the fields of PipelineStats
+  enum Counter {
+    kParseNs = 0,
+    kParseNum,
+    kReadBytes,
+    kReaderWaitNs,
+    kTrainerWaitNs,
+    kPredictNs,
+    kLossNs,
+    kUpdateNs,
+    kReallocNum,
+    kReallocBytes,
+    kCounterNum
+  };
+
+  /// \brief  counters of a thread, only written by the thread
+  class SOL_EXPORTS Local {
+   public:
+    Local();
+
+    inline void Add(Counter counter, uint64_t val) {
+      std::atomic<uint64_t>& c = this->counters_[counter];
+      c.store(c.load(std::memory_order_relaxed) + val,
+              std::memory_order_relaxed);
+    }
+
+    /// \brief  add the time elapsed since start to the counter
+    ///
+    /// \param counter time counter
+    /// \param start start time returned by now_ns
+    ///
+    /// \return current time, the start of the next stage
+    inline uint64_t Lap(Counter counter, uint64_t start) {
+      uint64_t now = Stats::now_ns();
+      this->Add(counter, now - start);
+      return now;
+    }
+
+   private:
+    friend class Stats;
+    std::atomic<uint64_t> counters_[kCounterNum];
+  };
+
+ public:
+  /// \brief  enable or disable the counters, the counters are kept
+  static void set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /// \brief  counters of the calling thread, nullptr if disabled
+  static Local* local() { return enabled() ? AcquireLocal() : nullptr; }
+
+  /// \brief  monotonic time in nanoseconds
+  static uint64_t now_ns() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count());
+  }
+
+  /// \brief  sum the counters of all the threads
+  ///
+  /// \param stats summed counters
+  static void Collect(PipelineStats& stats);
+
+  /// \brief  reset the counters of all the threads to zero, should not be
+  // called while training
+  static void Reset();
+
+ private:
+  static Local* AcquireLocal();
+
+  static std::atomic<bool> enabled_;
+};  // class Stats
+
+}  // namespace sol
+
+#endif
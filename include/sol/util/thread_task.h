@@ -9,6 +9,7 @@
 #ifndef SHENTU_UTIL_THREAD_TASK_H__
 #define SHENTU_UTIL_THREAD_TASK_H__
 
+#include <functional>
 #include <memory>
 #include <sol/util/thread.h>
 
@@ -36,5 +37,17 @@ class ThreadTask {
   std::unique_ptr<Thread> thread_;
 };  // class ThreadTask
 
+/// \brief  task running a function in a separate thread
+class FunctionTask : public ThreadTask {
+ public:
+  FunctionTask(const std::function<void()>& func) : func_(func) {}
+
+ protected:
+  virtual void run() { this->func_(); }
+
+ protected:
+  std::function<void()> func_;
+};  // class FunctionTask
+
 }  // namespace sol
 #endif
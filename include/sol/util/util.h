@@ -10,6 +10,7 @@
 #define SOL_UTIL_PLATFORM_H__
 
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
@@ -52,6 +53,34 @@ namespace sol {
 /// \return FILE pointer
 inline FILE* open_file(const char* path, const char* mode);
 
+/// \brief  get the cpu time consumed by the calling thread, in seconds
+///
+/// \return seconds
+inline double get_thread_cpu_time();
+
+/// \brief  get the position of a file, which may be larger than 2GB
+///
+/// \param file opened file
+///
+/// \return position in bytes, -1 if the file is not seekable (e.g. stdin)
+inline int64_t tell_file(FILE* file);
+
+/// \brief  set the position of a file, see tell_file
+///
+/// \param file opened file
+/// \param pos position in bytes from the beginning of the file
+///
+/// \return true if succeed
+inline bool seek_file(FILE* file, int64_t pos);
+
+/// \brief  rename a file, replacing the existing destination file
+///
+/// \param src_path path of the file to rename
+/// \param dst_path new path of the file
+///
+/// \return true if succeed
+inline bool replace_file(const char* src_path, const char* dst_path);
+
 /// \brief  delete a file
 ///
 /// \param path File path
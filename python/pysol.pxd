@@ -21,10 +21,22 @@ cdef extern from "sol/c_api.h":
     float sol_Test(void* model, void* data_iter,const char* output_path, float* tpr_fig, float*fpr_fig, float* tpr_tab, float* fpr_tab, float* auc);
     ctypedef void (*sol_predict_callback)(void* user_context, double label, double predict, int cls_num, float* scores)
     int sol_Predict(void* model, void* data_iter, sol_predict_callback callback, void* user_context)
+    int sol_PredictCsr(void* model, const void* indptr, const void* indices, int index_size,
+                       const void* data, int data_size, long long n_samples,
+                       float* scores, double* predicts) nogil
+    int sol_PredictDense(void* model, const void* X, int data_size, long long n_samples,
+                         long long n_features, long long row_stride,
+                         float* scores, double* predicts) nogil
+    int sol_GetClfNum(void* model)
     float sol_model_sparsity(void* model)
     ctypedef void (*inspect_iterate_callback)(void* user_context, long long data_num, long long iter_num,
                                          long long update_num, double err_rate)
     void sol_InspectOnlineIteration(void* model, inspect_iterate_callback callback, void* user_context)
+    ctypedef void (*train_curve_callback)(void* user_context, int model_id, long long data_num,
+                                          long long iter_num, long long update_num,
+                                          double err_rate, double time)
+    int sol_TrainModels(void** models, int model_num, void* data_iter, float* err_rates,
+                        train_curve_callback callback, void* user_context)
     int sol_loadArray(void* data_iter, char* X, char* Y, np.npy_intp* dims, np.npy_intp* strides, int pass_num)
     int sol_loadCsrMatrix(void* data_iter, char* indices, char* indptr, char* features, char* Y, int n_samples, int pass_num)
     int sol_analyze_data(const char* data_path, const char* data_type, const char* output_path)
@@ -42,6 +42,16 @@ cdef void inspect_iteration(void* user_context,
     if handler is not None:
         handler(data_num, iter_num, update_num, err_rate)
 
+cdef void train_curve(void* user_context,
+        int model_id,
+        long long data_num,
+        long long iter_num,
+        long long update_num,
+        double err_rate,
+        double time):
+    handler = <object>user_context
+    handler[model_id].append((update_num, data_num, iter_num, err_rate, time))
+
 cdef class SOL:
     cdef void* _c_model
     cdef void* _c_data_iter
@@ -198,6 +208,123 @@ cdef class SOL:
         if ret != 0:
             raise RuntimeError('load data failed')
 
+    def __predict_array(self, X):
+        """predict numpy.ndarray or csr_matrix directly without loading to data_iter
+
+        Parameters
+        ----------
+        X: {array-like or sparse matrix}, shape = [n_samples, n_features]
+            float32 or float64 values, int32 or int64 indices for csr_matrix
+
+        Returns
+        -------
+        scores: array, shape = [n_samples, n_classifiers]
+        predicts: array, shape = [n_samples]
+        """
+        cdef int clf_num = sol_GetClfNum(self._c_model)
+        cdef long long n_samples = X.shape[0]
+        cdef np.ndarray[np.float32_t, ndim=2, mode='c'] scores = np.empty((n_samples, clf_num), dtype=np.float32)
+        cdef np.ndarray[np.float64_t, ndim=1, mode='c'] predicts = np.empty(n_samples, dtype=np.float64)
+        cdef np.ndarray indptr, indices, data
+        cdef int index_size, data_size
+        cdef long long n_features, row_stride
+        cdef float* score_buf = NULL
+        cdef double* predict_buf = NULL
+        cdef int ret = 0
+
+        if n_samples > 0:
+            score_buf = &scores[0, 0]
+            predict_buf = &predicts[0]
+
+        if isinstance(X, csr_matrix):
+            if X.dtype != np.float32:
+                data = np.ascontiguousarray(X.data, dtype=np.float64)
+            else:
+                data = np.ascontiguousarray(X.data)
+            index_dtype = np.int64 if X.indices.dtype == np.int64 else np.int32
+            indices = np.ascontiguousarray(X.indices, dtype=index_dtype)
+            indptr = np.ascontiguousarray(X.indptr, dtype=index_dtype)
+            index_size = indices.itemsize
+            data_size = data.itemsize
+            with nogil:
+                ret = sol_PredictCsr(self._c_model, indptr.data, indices.data, index_size,
+                        data.data, data_size, n_samples, score_buf, predict_buf)
+        else:
+            if X.dtype != np.float32:
+                data = np.asarray(X, dtype=np.float64)
+            else:
+                data = np.asarray(X)
+            # rows may be strided, but the features of a row should be contiguous
+            if data.ndim != 2 or data.strides[1] != data.itemsize:
+                data = np.ascontiguousarray(data)
+            data_size = data.itemsize
+            n_features = data.shape[1]
+            row_stride = data.strides[0]
+            with nogil:
+                ret = sol_PredictDense(self._c_model, data.data, data_size, n_samples,
+                        n_features, row_stride, score_buf, predict_buf)
+
+        if ret != 0:
+            raise RuntimeError('predict data failed')
+        return scores, predicts
+
+    def __true_labels(self, param2, n_samples):
+        """calibrate the labels as the models, binary labels are 1 or -1"""
+        if param2 is None:
+            param2 = np.zeros(n_samples, dtype=np.float64)
+        y = np.asarray(param2, dtype=np.float64)
+        if sol_GetClfNum(self._c_model) == 1:
+            y = np.where(y == 1, 1.0, -1.0)
+        return y
+
+    def fit_models(self, models, param1, param2, int pass_num = 1):
+        """learn multiple models concurrently from one pass of data, the data is
+        parsed once by the data iterator of this handle and trained by all the
+        models, which is much faster than fitting the models one by one in
+        parameter search
+
+        Parameters
+        ----------
+        models: list of SOL
+            models to be trained, e.g. with different algorithms or parameters
+        param1: string, data path or {array-like or sparse matrix}, shape = [n_samples, n_features]
+            Training vector, where n_samples is the number of samples and n_features is the number of features
+        param2: string, data type or array-like, shape=[n_samples]
+            Target label vector relative to X
+        pass_num: int
+            number of passes to iterate through the data
+
+        Returns
+        -------
+        list: training accuracy and curves (update, data, iter, err, time) of
+        each model, the same as fit
+        """
+        cdef int model_num = len(models)
+        cdef void** c_models = <void**>malloc(model_num * sizeof(void*))
+        cdef np.ndarray[float, ndim=1, mode="c"] err_rates = np.zeros((max(model_num, 1),), dtype=np.float32)
+        cdef SOL m
+        for i in xrange(model_num):
+            m = models[i]
+            assert m._c_model is not NULL, "model is not initialized"
+            c_models[i] = m._c_model
+
+        self.__load_data(param1, param2, pass_num)
+        curves = [[] for i in xrange(model_num)]
+        ret = sol_TrainModels(c_models, model_num, self._c_data_iter,
+                &err_rates[0], train_curve, <void*>curves)
+        free(c_models)
+        if ret != 0:
+            raise RuntimeError('train models failed')
+
+        results = []
+        for i in xrange(model_num):
+            curve = np.array(curves[i], dtype=np.float64).reshape(-1, 5)
+            results.append((1 - err_rates[i],
+                curve[:, 0].astype(np.int64), curve[:, 1].astype(np.int64),
+                curve[:, 2].astype(np.int64), curve[:, 3].astype(np.float32),
+                curve[:, 4].astype(np.float32)))
+        return results
+
     def fit(self, param1, param2, int pass_num = 1):
         """learn data from numpy array
 
@@ -293,6 +420,15 @@ cdef class SOL:
         """
         assert self._c_model is not NULL, "model is not initialized"
 
+        if isinstance(param1, (np.ndarray, csr_matrix)):
+            scores, predicts = self.__predict_array(param1)
+            if scores.shape[1] == 1:
+                scores = scores.reshape(scores.shape[0])
+            if get_labels:
+                return scores, predicts, self.__true_labels(param2, param1.shape[0])
+            else:
+                return scores
+
         self.__load_data(param1, param2, 1)
         result = [[],[], []]
 
@@ -327,6 +463,13 @@ cdef class SOL:
         """
         assert self._c_model is not NULL, "model is not initialized"
 
+        if isinstance(param1, (np.ndarray, csr_matrix)):
+            scores, predicts = self.__predict_array(param1)
+            if get_labels:
+                return predicts, self.__true_labels(param2, param1.shape[0])
+            else:
+                return predicts
+
         self.__load_data(param1, param2, 1)
         result = [[],[]]
 
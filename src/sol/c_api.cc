@@ -8,6 +8,7 @@
 
 #include <stdexcept>
 #include <fstream>
+#include <memory>
 
 #ifdef HAS_NUMPY_DEV
 #include <numpy/arrayobject.h>
@@ -20,6 +21,12 @@
 #include "sol/sol.h"
 #include "sol/tools.h"
 #include "sol/model/online_model.h"
+#include "sol/model/online_linear_model.h"
+#include "sol/model/predictor.h"
+#include "sol/model/model_sweep.h"
+#include "sol/model/cross_validation.h"
+#include "sol/pario/data_arena.h"
+#include "sol/util/stats.h"
 
 using namespace std;
 using namespace sol;
@@ -41,6 +48,16 @@ int sol_LoadData(void* data_iter, const char* path, const char* format,
   return iter->AddReader(path, format, pass_num);
 }
 
+int sol_AddTransform(void* data_iter, const char* spec) {
+  DataIter* iter = (DataIter*)(data_iter);
+  return iter->AddTransform(spec);
+}
+
+void sol_AddPreProcess(void* data_iter, void* model) {
+  DataIter* iter = (DataIter*)(data_iter);
+  iter->AddTransform(make_shared<PreProcessTransform>((Model*)(model)));
+}
+
 void* sol_CreateModel(const char* name, int class_num) {
   return (void*)(Model::Create(name, class_num));
 }
@@ -127,6 +144,36 @@ float sol_Test(void* model, void* data_iter, const char* output_path,  float* tp
   }
 }
 
+/// \brief  predictor sharing the weights of the model if finalized already,
+// otherwise holding finalized copies of the weights, so that the model is
+// not modified by the predicting calls made concurrently without the GIL
+static unique_ptr<Predictor> CreatePredictor(OnlineLinearModel& olm) {
+  if (olm.model_updated() == false) {
+    return unique_ptr<Predictor>(new Predictor(olm, false));
+  }
+  vector<math::Vector<real_t>> weights;
+  olm.CopyFinalizedWeights(weights);
+  return unique_ptr<Predictor>(new Predictor(olm, std::move(weights)));
+}
+
+float sol_Evaluate(void* model, void* data_iter, int approx, int thread_num,
+                   float* auc, float* log_loss) {
+  Model* m = (Model*)(model);
+  DataIter* iter = (DataIter*)(data_iter);
+  Evaluator evaluator(approx ? AucMode::Approx : AucMode::Exact);
+  float err_rate = 0;
+  OnlineLinearModel* olm = dynamic_cast<OnlineLinearModel*>(m);
+  if (thread_num > 1 && olm != nullptr) {
+    unique_ptr<Predictor> predictor = CreatePredictor(*olm);
+    err_rate = predictor->Test(*iter, nullptr, thread_num, &evaluator);
+  } else {
+    err_rate = m->Test(*iter, nullptr, &evaluator);
+  }
+  if (auc != nullptr) *auc = evaluator.AUC();
+  if (log_loss != nullptr) *log_loss = float(evaluator.log_loss());
+  return err_rate;
+}
+
 int sol_Predict(void* model, void* data_iter, sol_predict_callback callback,
                 void* user_context) {
   Model* m = (Model*)(model);
@@ -140,9 +187,10 @@ int sol_Predict(void* model, void* data_iter, sol_predict_callback callback,
   while (1) {
     mb = iter->Next(mb);
     if (mb == nullptr) break;
+    bool preprocessed = m->IsPreProcessed(*mb);
     for (int i = 0; i < mb->size(); ++i) {
       DataPoint& x = (*mb)[i];
-      m->PreProcess(x);
+      if (!preprocessed) m->PreProcess(x);
       // predict
       label_t label = m->Predict(x, score_buf);
       callback(user_context, x.label(), label, m->clf_num(), score_buf);
@@ -153,11 +201,120 @@ int sol_Predict(void* model, void* data_iter, sol_predict_callback callback,
   return data_num;
 }
 
+int sol_PredictSnapshot(void* model, void* data_iter,
+                        sol_predict_callback callback, void* user_context) {
+  OnlineLinearModel* m = dynamic_cast<OnlineLinearModel*>((Model*)(model));
+  if (m == nullptr) return -1;
+  shared_ptr<const Predictor> snapshot = m->snapshot();
+  if (snapshot == nullptr) return -1;
+  DataIter* iter = (DataIter*)(data_iter);
+
+  vector<float> score_buf(snapshot->clf_num());
+  MiniBatch* mb = nullptr;
+  int data_num = 0;
+  while (1) {
+    mb = iter->Next(mb);
+    if (mb == nullptr) break;
+    for (int i = 0; i < mb->size(); ++i) {
+      const DataPoint& x = (*mb)[i];
+      label_t label = snapshot->Predict(x, score_buf.data());
+      callback(user_context, x.label(), label, snapshot->clf_num(),
+               score_buf.data());
+    }
+    data_num += mb->size();
+  }
+  return data_num;
+}
+
+/// \brief  predict with the weights of the model, and convert the labels
+template <typename PredictFunc>
+int PredictWith(void* model, long long n_samples, double* predicts,
+                PredictFunc predict_func) {
+  Model* m = (Model*)(model);
+  OnlineLinearModel* olm = dynamic_cast<OnlineLinearModel*>(m);
+  if (olm == nullptr || n_samples < 0) return Status_Invalid_Argument;
+
+  unique_ptr<Predictor> predictor = CreatePredictor(*olm);
+  vector<label_t> labels(predicts == nullptr ? 0 : size_t(n_samples));
+  predict_func(*predictor, predicts == nullptr ? nullptr : labels.data());
+  for (size_t i = 0; i < labels.size(); ++i) predicts[i] = labels[i];
+  return Status_OK;
+}
+
+int sol_PredictCsr(void* model, const void* indptr, const void* indices,
+                   int index_size, const void* data, int data_size,
+                   long long n_samples, float* scores, double* predicts) {
+  if ((index_size != 4 && index_size != 8) ||
+      (data_size != 4 && data_size != 8)) {
+    return Status_Invalid_Argument;
+  }
+  return PredictWith(
+      model, n_samples, predicts,
+      [=](const Predictor& predictor, label_t* labels) {
+        size_t row_num = size_t(n_samples);
+        if (index_size == 4 && data_size == 4) {
+          predictor.PredictCsr((const int32_t*)indptr, (const int32_t*)indices,
+                               (const float*)data, row_num, scores, labels);
+        } else if (index_size == 4) {
+          predictor.PredictCsr((const int32_t*)indptr, (const int32_t*)indices,
+                               (const double*)data, row_num, scores, labels);
+        } else if (data_size == 4) {
+          predictor.PredictCsr((const int64_t*)indptr, (const int64_t*)indices,
+                               (const float*)data, row_num, scores, labels);
+        } else {
+          predictor.PredictCsr((const int64_t*)indptr, (const int64_t*)indices,
+                               (const double*)data, row_num, scores, labels);
+        }
+      });
+}
+
+int sol_PredictDense(void* model, const void* X, int data_size,
+                     long long n_samples, long long n_features,
+                     long long row_stride, float* scores, double* predicts) {
+  if ((data_size != 4 && data_size != 8) || n_features < 0) {
+    return Status_Invalid_Argument;
+  }
+  return PredictWith(
+      model, n_samples, predicts,
+      [=](const Predictor& predictor, label_t* labels) {
+        if (data_size == 4) {
+          predictor.PredictDense((const float*)X, size_t(n_samples),
+                                 size_t(n_features), size_t(row_stride),
+                                 scores, labels);
+        } else {
+          predictor.PredictDense((const double*)X, size_t(n_samples),
+                                 size_t(n_features), size_t(row_stride),
+                                 scores, labels);
+        }
+      });
+}
+
+int sol_GetClfNum(void* model) {
+  Model* m = (Model*)(model);
+  return m->clf_num();
+}
+
 float sol_model_sparsity(void* model) {
   Model* m = (Model*)(model);
   return m->model_sparsity();
 }
 
+long long sol_MemoryUsage(void* model, sol_memory_callback callback,
+                          void* user_context) {
+  Model* m = (Model*)(model);
+  vector<Model::MemoryBlock> blocks;
+  m->MemoryUsage(blocks);
+  long long bytes = 0;
+  for (const Model::MemoryBlock& block : blocks) {
+    if (callback != nullptr) {
+      callback(user_context, block.name.c_str(), (long long)(block.used),
+               (long long)(block.allocated));
+    }
+    bytes += (long long)(block.allocated);
+  }
+  return bytes;
+}
+
 SOL_EXPORTS void sol_InspectOnlineIteration(
     void* model, sol_inspect_iterate_callback callback, void* user_context) {
   if (callback == nullptr) return;
@@ -166,6 +323,88 @@ SOL_EXPORTS void sol_InspectOnlineIteration(
   m->set_iterate_callback(callback, user_context);
 }
 
+int sol_InspectBudget(void* model, sol_inspect_budget_callback callback,
+                      void* user_context) {
+  OnlineLinearModel* m = dynamic_cast<OnlineLinearModel*>((Model*)(model));
+  if (m == nullptr) return Status_Invalid_Argument;
+  m->set_budget_callback(callback, user_context);
+  return Status_OK;
+}
+
+void sol_EnableStats(int enable) { Stats::set_enabled(enable != 0); }
+
+void sol_GetStats(sol_stats* stats) {
+  PipelineStats src;
+  Stats::Collect(src);
+  stats->parse_ns = src.parse_ns;
+  stats->parse_num = src.parse_num;
+  stats->read_bytes = src.read_bytes;
+  stats->reader_wait_ns = src.reader_wait_ns;
+  stats->trainer_wait_ns = src.trainer_wait_ns;
+  stats->predict_ns = src.predict_ns;
+  stats->loss_ns = src.loss_ns;
+  stats->update_ns = src.update_ns;
+  stats->realloc_num = src.realloc_num;
+  stats->realloc_bytes = src.realloc_bytes;
+}
+
+void sol_ResetStats() { Stats::Reset(); }
+
+int sol_TrainModels(void** models, int model_num, void* data_iter,
+                    float* err_rates, sol_train_curve_callback callback,
+                    void* user_context) {
+  ModelSweep sweep;
+  for (int i = 0; i < model_num; ++i) {
+    sweep.AddModel((Model*)(models[i]));
+  }
+  DataIter* iter = (DataIter*)(data_iter);
+  int ret = sweep.Train(*iter);
+  if (ret != Status_OK) return ret;
+
+  for (int i = 0; i < model_num; ++i) {
+    if (err_rates != nullptr) err_rates[i] = sweep.err_rate(i);
+    if (callback == nullptr) continue;
+    for (const IterStat& stat : sweep.curve(i)) {
+      callback(user_context, i, stat.data_num, stat.iter_num, stat.update_num,
+               stat.err_rate, stat.time);
+    }
+  }
+  return Status_OK;
+}
+
+int sol_CrossValidate(const char* algo, int class_num, void* data_iter,
+                      int fold_num, const char* grid, const char* params,
+                      int pass_num, int thread_num, int shuffle,
+                      sol_cv_callback callback, void* user_context) {
+  DataIter* iter = (DataIter*)(data_iter);
+  DataArena arena;
+  int ret = arena.Load(*iter);
+  if (ret != Status_OK) return ret;
+
+  try {
+    CrossValidation cv(arena, algo, class_num, fold_num);
+    for (const string& setting : CrossValidation::ExpandGrid(
+             grid == nullptr ? "" : grid, params == nullptr ? "" : params)) {
+      ret = cv.AddSetting(setting);
+      if (ret != Status_OK) return ret;
+    }
+    ret = cv.Run(thread_num, pass_num, iter->batch_size(), shuffle != 0);
+    if (ret != Status_OK) return ret;
+
+    for (size_t i = 0; i < cv.setting_num() && callback != nullptr; ++i) {
+      for (int k = 0; k < fold_num; ++k) {
+        callback(user_context, cv.setting(i).c_str(), k,
+                 cv.train_accuracy(i, k), cv.val_accuracy(i, k));
+      }
+    }
+  }
+  catch (invalid_argument& err) {
+    fprintf(stderr, "%s\n", err.what());
+    return Status_Invalid_Argument;
+  }
+  return Status_OK;
+}
+
 #ifdef HAS_NUMPY_DEV
 int sol_loadArray(void* data_iter, char* X, char* Y, npy_intp* dims,
                   npy_intp* strides, int pass_num) {
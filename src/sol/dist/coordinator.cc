@@ -0,0 +1,59 @@
+/*********************************************************************************
+*     File Name           :     coordinator.cc
+*     Created By          :     yuewu
+*     Description         :     coordinator of data-parallel training workers
+**********************************************************************************/
+#include "sol/dist/coordinator.h"
+
+#include "sol/util/util.h"
+
+using namespace std;
+using namespace sol::math;
+
+namespace sol {
+namespace dist {
+
+Coordinator::Coordinator(Transport* transport, size_t sync_interval)
+    : transport_(transport), sync_interval_(sync_interval) {
+  Check(transport != nullptr);
+  this->delta_.resize(0);
+}
+
+index_t Coordinator::MaxDim(index_t dim) {
+  double val = double(dim);
+  this->transport_->AllReduce(&val, 1, kReduceMax);
+  return index_t(val);
+}
+
+int Coordinator::AverageDeltas(const vector<Vector<real_t>*>& states,
+                               const vector<Vector<real_t>*>& snapshots,
+                               bool updated) {
+  Check(states.size() == snapshots.size());
+  double updated_num = updated ? 1 : 0;
+  this->transport_->AllReduce(&updated_num, 1, kReduceSum);
+  if (updated_num == 0) return 0;
+
+  Vector<real_t>& delta = this->delta_;
+  for (size_t k = 0; k < states.size(); ++k) {
+    Vector<real_t>& state = *states[k];
+    const Vector<real_t>& snapshot = *snapshots[k];
+    Check(state.dim() == snapshot.dim());
+    delta.resize(state.dim());
+    delta = state - snapshot;
+    this->transport_->AllReduce(delta.begin(), delta.dim(), kReduceSum);
+    if (updated_num > 1) delta /= real_t(updated_num);
+    state = snapshot + delta;
+  }
+  return int(updated_num);
+}
+
+bool Coordinator::SumProgress(vector<double>& counters, bool finished) {
+  counters.push_back(finished ? 1 : 0);
+  this->transport_->AllReduce(counters.data(), counters.size(), kReduceSum);
+  bool all_finished = int(counters.back()) == this->worker_num();
+  counters.pop_back();
+  return all_finished;
+}
+
+}  // namespace dist
+}  // namespace sol
@@ -0,0 +1,253 @@
+/*********************************************************************************
+*     File Name           :     shm_transport.cc
+*     Created By          :     yuewu
+*     Description         :     transport through posix shared memory
+**********************************************************************************/
+#include "sol/dist/shm_transport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if !_WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "sol/util/error_code.h"
+
+using namespace std;
+
+namespace sol {
+namespace dist {
+
+// seconds to wait for the segment created by rank 0
+static const double kOpenTimeout = 60;
+// milliseconds between the checks of a segment of another job
+static const int kStaleCheckInterval = 10;
+
+/// \brief  header of the segment, followed by the slots of the workers
+struct ShmTransport::Header {
+  // set by rank 0 after the header is initialized
+  std::atomic<int> ready;
+  // process id of rank 0, which identifies the job of the segment
+  int owner_pid;
+  // number of workers arrived at the barrier
+  std::atomic<int> barrier_count;
+  // increased each time all the workers arrive at the barrier
+  std::atomic<int> barrier_gen;
+  int worker_num;
+  size_t slot_size;
+};
+
+// slots start at a cache line boundary
+static const size_t kHeaderSize = 64;
+
+ShmTransport::ShmTransport()
+    : header_(nullptr),
+      slots_(nullptr),
+      slot_size_(0),
+      map_size_(0),
+      rank_(0),
+      size_(1) {}
+
+ShmTransport::~ShmTransport() { this->Close(); }
+
+#if _WIN32
+
+int ShmTransport::Open(const string& name, int rank, int size,
+                       size_t slot_size) {
+  fprintf(stderr, "shared memory transport is not supported on windows\n");
+  return Status_Invalid_Argument;
+}
+
+void ShmTransport::Close() {}
+
+#else
+
+int ShmTransport::Open(const string& name, int rank, int size,
+                       size_t slot_size) {
+  static_assert(sizeof(Header) <= kHeaderSize, "header exceeds cache line");
+  if (size <= 0 || rank < 0 || rank >= size || slot_size < sizeof(double)) {
+    fprintf(stderr, "invalid rank %d of %d workers\n", rank, size);
+    return Status_Invalid_Argument;
+  }
+  this->Close();
+  string shm_name = name[0] == '/' ? name : "/" + name;
+  // align the slots to cache lines
+  slot_size = (slot_size + kHeaderSize - 1) / kHeaderSize * kHeaderSize;
+  size_t map_size = kHeaderSize + slot_size * size;
+
+  Header* header = nullptr;
+  if (rank == 0) {
+    // remove the segment left by an aborted job
+    shm_unlink(shm_name.c_str());
+    int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd >= 0 && ftruncate(fd, off_t(map_size)) != 0) {
+      close(fd);
+      fd = -1;
+    }
+    if (fd < 0) {
+      fprintf(stderr, "open shared memory %s failed\n", shm_name.c_str());
+      return Status_IO_Error;
+    }
+    void* addr =
+        mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+      fprintf(stderr, "map shared memory %s failed\n", shm_name.c_str());
+      shm_unlink(shm_name.c_str());
+      return Status_IO_Error;
+    }
+    header = new (addr) Header;
+    header->owner_pid = int(getpid());
+    header->barrier_count = 0;
+    header->barrier_gen = 0;
+    header->worker_num = size;
+    header->slot_size = slot_size;
+    header->ready.store(1, memory_order_release);
+  } else {
+    header = this->Attach(shm_name, map_size);
+    if (header == nullptr) {
+      fprintf(stderr, "wait for shared memory %s timeout\n", shm_name.c_str());
+      return Status_IO_Error;
+    }
+  }
+  this->header_ = header;
+  this->slots_ = reinterpret_cast<char*>(header) + kHeaderSize;
+  this->map_size_ = map_size;
+  this->slot_size_ = slot_size;
+  this->rank_ = rank;
+  this->size_ = size;
+
+  if (header->worker_num != size || header->slot_size != slot_size) {
+    fprintf(stderr, "worker number mismatch with shared memory %s\n",
+            shm_name.c_str());
+    this->Close();
+    return Status_Invalid_Argument;
+  }
+
+  // wait until all the workers are attached
+  this->Barrier();
+  // all the workers are attached, the segment is released once they detach
+  if (rank == 0) shm_unlink(shm_name.c_str());
+  return Status_OK;
+}
+
+ShmTransport::Header* ShmTransport::Attach(const string& shm_name,
+                                           size_t map_size) {
+  double start_time = get_current_time();
+  while (get_current_time() - start_time < kOpenTimeout) {
+    int fd = shm_open(shm_name.c_str(), O_RDWR, 0600);
+    struct stat st;
+    // rank 0 may not have created the segment or set the size yet
+    if (fd < 0 || fstat(fd, &st) != 0 || size_t(st.st_size) < map_size) {
+      if (fd >= 0) close(fd);
+      this_thread::sleep_for(chrono::milliseconds(kStaleCheckInterval));
+      continue;
+    }
+    void* addr =
+        mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) return nullptr;
+
+    // the segment of an aborted job may be opened before rank 0 of the
+    // current job replaces it, the segment is stale if the name refers to
+    // another segment, or if the rank 0 initialized it has exited
+    Header* header = static_cast<Header*>(addr);
+    bool stale = false;
+    while (header->ready.load(memory_order_acquire) == 0 && stale == false &&
+           get_current_time() - start_time < kOpenTimeout) {
+      this_thread::sleep_for(chrono::milliseconds(kStaleCheckInterval));
+      struct stat cur_st;
+      fd = shm_open(shm_name.c_str(), O_RDONLY, 0600);
+      stale = fd >= 0 && fstat(fd, &cur_st) == 0 &&
+              (cur_st.st_dev != st.st_dev || cur_st.st_ino != st.st_ino);
+      if (fd >= 0) close(fd);
+    }
+    if (header->ready.load(memory_order_acquire) != 0 && stale == false) {
+      stale = kill(pid_t(header->owner_pid), 0) != 0 && errno == ESRCH;
+      if (stale == false) return header;
+    }
+    munmap(addr, map_size);
+    this_thread::sleep_for(chrono::milliseconds(kStaleCheckInterval));
+  }
+  return nullptr;
+}
+
+void ShmTransport::Close() {
+  if (this->header_ != nullptr) {
+    munmap(this->header_, this->map_size_);
+    this->header_ = nullptr;
+    this->slots_ = nullptr;
+  }
+}
+
+#endif
+
+void ShmTransport::Barrier() {
+  Header* header = this->header_;
+  if (header == nullptr || this->size_ == 1) return;
+
+  int gen = header->barrier_gen.load(memory_order_acquire);
+  if (header->barrier_count.fetch_add(1, memory_order_acq_rel) + 1 ==
+      this->size_) {
+    header->barrier_count.store(0, memory_order_relaxed);
+    header->barrier_gen.fetch_add(1, memory_order_release);
+    return;
+  }
+  // spin for a while as the workers usually arrive together, and sleep
+  // afterwards not to occupy the cores of the slow workers
+  for (int spin = 0; header->barrier_gen.load(memory_order_acquire) == gen;
+       ++spin) {
+    if (spin < 1024) {
+      this_thread::yield();
+    } else {
+      this_thread::sleep_for(chrono::microseconds(50));
+    }
+  }
+}
+
+void ShmTransport::AllReduce(float* data, size_t count, ReduceOp op) {
+  this->AllReduceImpl(data, count, op);
+}
+
+void ShmTransport::AllReduce(double* data, size_t count, ReduceOp op) {
+  this->AllReduceImpl(data, count, op);
+}
+
+template <typename T>
+void ShmTransport::AllReduceImpl(T* data, size_t count, ReduceOp op) {
+  if (this->header_ == nullptr || this->size_ == 1) return;
+
+  size_t chunk_size = this->slot_size_ / sizeof(T);
+  T* buf = reinterpret_cast<T*>(this->slot(this->rank_));
+  for (size_t offset = 0; offset < count; offset += chunk_size) {
+    size_t n = (std::min)(chunk_size, count - offset);
+    T* dst = data + offset;
+    memcpy(buf, dst, n * sizeof(T));
+    this->Barrier();
+
+    memcpy(dst, this->slot(0), n * sizeof(T));
+    for (int r = 1; r < this->size_; ++r) {
+      const T* src = reinterpret_cast<const T*>(this->slot(r));
+      if (op == kReduceSum) {
+        for (size_t i = 0; i < n; ++i) dst[i] += src[i];
+      } else {
+        for (size_t i = 0; i < n; ++i) dst[i] = (std::max)(dst[i], src[i]);
+      }
+    }
+    // the slots are overwritten in the next chunk
+    this->Barrier();
+  }
+}
+
+}  // namespace dist
+}  // namespace sol
@@ -28,6 +28,16 @@ float BoolLoss::gradient(const pario::DataPoint& dp, float* predict,
   return loss;
 }
 
+void BoolLoss::BatchGradient(const label_t* labels, const float* predicts,
+                             const label_t* predict_labels, float* gradients,
+                             float* losses, size_t data_num, int cls_num) {
+  for (size_t i = 0; i < data_num; ++i) {
+    float loss = predict_labels[i] == labels[i] ? 0.f : 1.f;
+    losses[i] = loss;
+    gradients[i] = loss > 0 ? -float(labels[i]) : 0.f;
+  }
+}
+
 RegisterLoss(BoolLoss, "bool", "Bool Loss");
 
 float MaxScoreBoolLoss::loss(const pario::DataPoint& dp, float* predict,
@@ -51,6 +61,25 @@ float MaxScoreBoolLoss::gradient(const pario::DataPoint& dp, float* predict,
   return loss;
 }
 
+void MaxScoreBoolLoss::BatchGradient(const label_t* labels,
+                                     const float* predicts,
+                                     const label_t* predict_labels,
+                                     float* gradients, float* losses,
+                                     size_t data_num, int cls_num) {
+  std::fill(gradients, gradients + data_num * cls_num, 0.f);
+  for (size_t i = 0; i < data_num; ++i) {
+    float* gradient = gradients + i * cls_num;
+    label_t label = labels[i];
+    if (predict_labels[i] == label) {
+      losses[i] = 0;
+    } else {
+      losses[i] = 1;
+      gradient[predict_labels[i]] = 1;
+      gradient[label] = -1;
+    }
+  }
+}
+
 RegisterLoss(MaxScoreBoolLoss, "maxscore-bool", "Max-Score Bool Loss");
 
 float UniformBoolLoss::loss(const pario::DataPoint& dp, float* predict,
@@ -37,6 +37,23 @@ float HingeLoss::gradient(const pario::DataPoint& dp, float* predict,
   return loss;
 }
 
+void HingeLoss::BatchGradient(const label_t* labels, const float* predicts,
+                              const label_t* predict_labels, float* gradients,
+                              float* losses, size_t data_num, int cls_num) {
+  if (this->margin_handler_) {
+    return Loss::BatchGradient(labels, predicts, predict_labels, gradients,
+                               losses, data_num, cls_num);
+  }
+  float margin = this->margin_;
+  for (size_t i = 0; i < data_num; ++i) {
+    float label = float(labels[i]);
+    float loss = margin - predicts[i] * label;
+    loss = loss > 0 ? loss : 0.f;
+    losses[i] = loss;
+    gradients[i] = loss > 0 ? -label : 0.f;
+  }
+}
+
 RegisterLoss(HingeLoss, "hinge", "Hinge Loss");
 
 float MaxScoreHingeLoss::loss(const pario::DataPoint& dp, float* predict,
@@ -90,6 +107,34 @@ float MaxScoreHingeLoss::gradient(const pario::DataPoint& dp, float* predict,
   return loss;
 }
 
+void MaxScoreHingeLoss::BatchGradient(const label_t* labels,
+                                      const float* predicts,
+                                      const label_t* predict_labels,
+                                      float* gradients, float* losses,
+                                      size_t data_num, int cls_num) {
+  if (this->margin_handler_) {
+    return Loss::BatchGradient(labels, predicts, predict_labels, gradients,
+                               losses, data_num, cls_num);
+  }
+  float margin = this->margin_;
+  for (size_t i = 0; i < data_num; ++i) {
+    const float* predict = predicts + i * cls_num;
+    float* gradient = gradients + i * cls_num;
+    label_t label = labels[i];
+    label_t wrong_label =
+        MaxWrongLabel(predict, label, predict_labels[i], cls_num);
+    float loss = margin - predict[label] + predict[wrong_label];
+    std::fill(gradient, gradient + cls_num, 0.f);
+    if (loss > 0) {
+      gradient[wrong_label] = 1;
+      gradient[label] = -1;
+    } else {
+      loss = 0;
+    }
+    losses[i] = loss;
+  }
+}
+
 RegisterLoss(MaxScoreHingeLoss, "maxscore-hinge", "Max-Score Hinge Loss");
 
 float UniformHingeLoss::loss(const pario::DataPoint& dp, float* predict,
@@ -8,6 +8,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
+
+#include "sol/math/fast_math.h"
 
 namespace sol {
 namespace loss {
@@ -39,6 +42,18 @@ float LogisticLoss::gradient(const pario::DataPoint& dp, float* predict,
   }
 }
 
+void LogisticLoss::BatchGradient(const label_t* labels, const float* predicts,
+                                 const label_t* predict_labels,
+                                 float* gradients, float* losses,
+                                 size_t data_num, int cls_num) {
+  for (size_t i = 0; i < data_num; ++i) {
+    float label = float(labels[i]);
+    float sigmoid;
+    losses[i] = math::fast_softplus(-predicts[i] * label, &sigmoid);
+    gradients[i] = -label * sigmoid;
+  }
+}
+
 RegisterLoss(LogisticLoss, "logistic", "Logistic Loss");
 
 float MaxScoreLogisticLoss::loss(const pario::DataPoint& dp, float* predict,
@@ -91,6 +106,31 @@ float MaxScoreLogisticLoss::gradient(const pario::DataPoint& dp, float* predict,
   }
 }
 
+void MaxScoreLogisticLoss::BatchGradient(const label_t* labels,
+                                         const float* predicts,
+                                         const label_t* predict_labels,
+                                         float* gradients, float* losses,
+                                         size_t data_num, int cls_num) {
+  std::vector<label_t> wrong_labels(data_num);
+  std::vector<float> z(data_num);
+  for (size_t i = 0; i < data_num; ++i) {
+    const float* predict = predicts + i * cls_num;
+    label_t label = labels[i];
+    wrong_labels[i] = MaxWrongLabel(predict, label, predict_labels[i], cls_num);
+    z[i] = predict[wrong_labels[i]] - predict[label];
+  }
+  // the sigmoids are stored in z
+  for (size_t i = 0; i < data_num; ++i) {
+    losses[i] = math::fast_softplus(z[i], &z[i]);
+  }
+  std::fill(gradients, gradients + data_num * cls_num, 0.f);
+  for (size_t i = 0; i < data_num; ++i) {
+    float* gradient = gradients + i * cls_num;
+    gradient[wrong_labels[i]] = z[i];
+    gradient[labels[i]] = -z[i];
+  }
+}
+
 RegisterLoss(MaxScoreLogisticLoss, "maxscore-logistic",
              "Max-Score Logistic Loss");
 
@@ -8,6 +8,9 @@
 
 #include "sol/loss/loss.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace sol {
 namespace loss {
 
@@ -16,5 +19,22 @@ Loss* Loss::Create(const std::string& type) {
   return create_func == nullptr ? nullptr : create_func();
 }
 
+void Loss::BatchGradient(const label_t* labels, const float* predicts,
+                         const label_t* predict_labels, float* gradients,
+                         float* losses, size_t data_num, int cls_num) {
+  pario::DataPoint dp;
+  // gradient may modify the predictions temporarily
+  std::vector<float> predict(cls_num);
+  for (size_t i = 0; i < data_num; ++i) {
+    dp.set_label(labels[i]);
+    std::copy(predicts + i * cls_num, predicts + (i + 1) * cls_num,
+              predict.begin());
+    float* gradient = gradients + i * cls_num;
+    std::fill(gradient, gradient + cls_num, 0.f);
+    losses[i] = this->gradient(dp, predict.data(), predict_labels[i], gradient,
+                               cls_num);
+  }
+}
+
 }  // namespace loss
 }  // namespace sol
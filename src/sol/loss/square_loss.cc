@@ -26,6 +26,16 @@ float SquareLoss::gradient(const pario::DataPoint& dp, float* predict,
   return *gradient * *gradient * 0.5f;
 }
 
+void SquareLoss::BatchGradient(const label_t* labels, const float* predicts,
+                               const label_t* predict_labels, float* gradients,
+                               float* losses, size_t data_num, int cls_num) {
+  for (size_t i = 0; i < data_num; ++i) {
+    float gradient = predicts[i] - float(labels[i]);
+    gradients[i] = gradient;
+    losses[i] = gradient * gradient * 0.5f;
+  }
+}
+
 RegisterLoss(SquareLoss, "square", "Square Loss");
 
 }  // namespace loss
@@ -0,0 +1,168 @@
+/*********************************************************************************
+*     File Name           :     cross_validation.cc
+*     Created By          :     yuewu
+*     Description         :     k-fold cross validation on in-memory data
+**********************************************************************************/
+#include "sol/model/cross_validation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include "sol/model/model.h"
+#include "sol/model/online_linear_model.h"
+#include "sol/util/error_code.h"
+#include "sol/util/str_util.h"
+#include "sol/util/thread_task.h"
+
+using namespace std;
+using namespace sol::pario;
+
+namespace sol {
+namespace model {
+
+/// \brief  create a model with the parameters in the format of AddSetting
+static Model* CreateModel(const string& algo, int class_num,
+                          const string& params) {
+  unique_ptr<Model> model(Model::Create(algo, class_num));
+  if (model == nullptr) return nullptr;
+  // the models are trained concurrently, do not show the iterations
+  OnlineModel* online_model = dynamic_cast<OnlineModel*>(model.get());
+  if (online_model != nullptr) {
+    online_model->set_iterate_callback(nullptr, nullptr);
+  }
+  OnlineLinearModel* linear_model =
+      dynamic_cast<OnlineLinearModel*>(model.get());
+  if (linear_model != nullptr) {
+    linear_model->set_budget_callback(nullptr, nullptr);
+  }
+  for (const string& opt : split(params, ';')) {
+    if (strip(opt).empty()) continue;
+    const vector<string>& opt_pair = split(opt, '=');
+    if (opt_pair.size() != 2) {
+      fprintf(stderr, "invalid params: %s\n", opt.c_str());
+      return nullptr;
+    }
+    try {
+      model->SetParameter(strip(opt_pair[0]), strip(opt_pair[1]));
+    }
+    catch (invalid_argument& err) {
+      fprintf(stderr, "%s\n", err.what());
+      return nullptr;
+    }
+  }
+  return model.release();
+}
+
+CrossValidation::CrossValidation(const DataArena& arena, const string& algo,
+                                 int class_num, int fold_num)
+    : arena_(arena), algo_(algo), class_num_(class_num), fold_num_(fold_num) {
+  if (fold_num < 2) {
+    throw invalid_argument("fold number must be larger than 1");
+  }
+}
+
+int CrossValidation::AddSetting(const string& params) {
+  unique_ptr<Model> model(CreateModel(this->algo_, this->class_num_, params));
+  if (model == nullptr) return Status_Invalid_Argument;
+  this->settings_.push_back(params);
+  return Status_OK;
+}
+
+vector<string> CrossValidation::ExpandGrid(const string& grid,
+                                           const string& params) {
+  vector<string> settings(1, "");
+  for (const string& opt : split(grid, ';')) {
+    if (strip(opt).empty()) continue;
+    const vector<string>& opt_pair = split(opt, '=');
+    if (opt_pair.size() != 2) {
+      throw invalid_argument("invalid grid: " + opt);
+    }
+    // the previous parameters change faster
+    vector<string> expanded;
+    for (const string& val : split(opt_pair[1], ',')) {
+      for (const string& setting : settings) {
+        expanded.push_back(setting + strip(opt_pair[0]) + "=" + strip(val) +
+                           ";");
+      }
+    }
+    settings.swap(expanded);
+  }
+  for (string& setting : settings) {
+    setting += params;
+    if (!setting.empty() && setting.back() == ';') setting.pop_back();
+  }
+  return settings;
+}
+
+int CrossValidation::Run(int thread_num, int pass_num, int batch_size,
+                         bool shuffle, unsigned int seed) {
+  size_t data_num = this->arena_.size();
+  if (data_num == 0 || this->settings_.empty()) {
+    fprintf(stderr, "no data or parameter settings to validate\n");
+    return Status_Invalid_Argument;
+  }
+
+  vector<size_t> order(data_num);
+  for (size_t i = 0; i < data_num; ++i) order[i] = i;
+  if (shuffle) {
+    mt19937 g(seed);
+    std::shuffle(order.begin(), order.end(), g);
+  }
+  // the same as sol::split
+  size_t split_num = size_t(ceil(data_num / float(this->fold_num_)));
+
+  size_t task_num = this->settings_.size() * this->fold_num_;
+  this->train_accuracies_.assign(task_num, 0);
+  this->val_accuracies_.assign(task_num, 0);
+  atomic<size_t> next_task(0);
+  atomic<int> ret(Status_OK);
+
+  auto cv_func = [&]() {
+    while (1) {
+      size_t task = next_task++;
+      if (task >= task_num) break;
+      size_t setting = task / this->fold_num_;
+      size_t val_fold = task % this->fold_num_;
+
+      vector<size_t> train_rows, val_rows;
+      for (size_t i = 0; i < data_num; ++i) {
+        (i / split_num == val_fold ? val_rows : train_rows).push_back(order[i]);
+      }
+      unique_ptr<Model> model(CreateModel(this->algo_, this->class_num_,
+                                          this->settings_[setting]));
+      if (model == nullptr) {
+        ret = Status_Invalid_Argument;
+        continue;
+      }
+      ArenaIter train_iter(this->arena_, train_rows, pass_num, batch_size);
+      ArenaIter val_iter(this->arena_, val_rows, 1, batch_size);
+      float train_err =
+          model->Train(train_iter, NULL, NULL, NULL, NULL, NULL, NULL);
+      float val_err = model->Test(val_iter, nullptr, nullptr);
+      this->train_accuracies_[task] = 1.f - train_err;
+      this->val_accuracies_[task] = 1.f - val_err;
+    }
+  };
+
+  if (thread_num <= 1) {
+    cv_func();
+  } else {
+    vector<unique_ptr<FunctionTask>> tasks;
+    for (int i = 0; i < thread_num; ++i) {
+      tasks.emplace_back(new FunctionTask(cv_func));
+      tasks.back()->Start();
+    }
+    for (unique_ptr<FunctionTask>& task : tasks) {
+      task->Join();
+    }
+  }
+  return ret;
+}
+
+}  // namespace model
+}  // namespace sol
@@ -0,0 +1,183 @@
+/*********************************************************************************
+*     File Name           :     evaluator.cc
+*     Created By          :     yuewu
+*     Description         :     streaming evaluation of the predicted results
+**********************************************************************************/
+#include "sol/model/evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace sol {
+namespace model {
+
+// the bins of the approx mode are the leading 16 bits of the keys: the sign,
+// the exponent and 7 bits of the mantissa
+static const int kBinShift = 16;
+static const size_t kBinNum = size_t(1) << (32 - kBinShift);
+
+/// \brief  LSD radix sort of the keys by bytes
+static void RadixSort(vector<uint32_t>& keys) {
+  vector<uint32_t> buf(keys.size());
+  for (int shift = 0; shift < 32; shift += 8) {
+    size_t offsets[257] = {0};
+    for (uint32_t key : keys) ++offsets[((key >> shift) & 0xFF) + 1];
+    for (int i = 0; i < 256; ++i) offsets[i + 1] += offsets[i];
+    for (uint32_t key : keys) buf[offsets[(key >> shift) & 0xFF]++] = key;
+    keys.swap(buf);
+  }
+}
+
+Evaluator::Evaluator(AucMode mode)
+    : mode_(mode),
+      data_num_(0),
+      err_num_(0),
+      roc_num_(0),
+      loss_sum_(0),
+      sorted_(true) {
+  if (mode == AucMode::Approx) {
+    this->pos_bins_.resize(kBinNum, 0);
+    this->neg_bins_.resize(kBinNum, 0);
+  }
+}
+
+inline uint32_t Evaluator::FloatKey(float val) {
+  // -0 and +0 are the same score
+  if (val == 0) val = 0;
+  uint32_t bits;
+  memcpy(&bits, &val, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+void Evaluator::Add(label_t label, label_t predict, const float* scores,
+                    int clf_num) {
+  ++this->data_num_;
+  if (label != predict) ++this->err_num_;
+
+  if (clf_num == 1) {
+    ++this->roc_num_;
+    // logistic loss of the margin
+    double z = label > 0 ? -scores[0] : scores[0];
+    this->loss_sum_ += (max)(z, 0.0) + log1p(exp(-fabs(z)));
+
+    uint32_t key = FloatKey(scores[0]);
+    if (this->mode_ == AucMode::Exact) {
+      (label > 0 ? this->pos_keys_ : this->neg_keys_).push_back(key);
+      this->sorted_ = false;
+    } else {
+      ++(label > 0 ? this->pos_bins_ : this->neg_bins_)[key >> kBinShift];
+    }
+  } else {
+    // cross entropy of the softmax scores
+    int cls = int(label);
+    if (cls < 0 || cls >= clf_num) return;
+    double max_score = *max_element(scores, scores + clf_num);
+    double sum = 0;
+    for (int c = 0; c < clf_num; ++c) sum += exp(scores[c] - max_score);
+    this->loss_sum_ += max_score + log(sum) - scores[cls];
+  }
+}
+
+void Evaluator::Merge(const Evaluator& evaluator) {
+  if (evaluator.mode_ != this->mode_) {
+    throw invalid_argument("merge evaluators of different modes");
+  }
+  this->data_num_ += evaluator.data_num_;
+  this->err_num_ += evaluator.err_num_;
+  this->roc_num_ += evaluator.roc_num_;
+  this->loss_sum_ += evaluator.loss_sum_;
+  if (this->mode_ == AucMode::Exact) {
+    this->pos_keys_.insert(this->pos_keys_.end(), evaluator.pos_keys_.begin(),
+                           evaluator.pos_keys_.end());
+    this->neg_keys_.insert(this->neg_keys_.end(), evaluator.neg_keys_.begin(),
+                           evaluator.neg_keys_.end());
+    this->sorted_ = false;
+  } else {
+    for (size_t i = 0; i < kBinNum; ++i) {
+      this->pos_bins_[i] += evaluator.pos_bins_[i];
+      this->neg_bins_[i] += evaluator.neg_bins_[i];
+    }
+  }
+}
+
+void Evaluator::Sort() {
+  if (this->sorted_) return;
+  RadixSort(this->pos_keys_);
+  RadixSort(this->neg_keys_);
+  this->sorted_ = true;
+}
+
+float Evaluator::Roc(float* tpr_fig, float* fpr_fig, float* tpr_tab,
+                     float* fpr_tab) {
+  double positive = 0;
+  double negative = 0;
+  if (this->mode_ == AucMode::Exact) {
+    positive = double(this->pos_keys_.size());
+    negative = double(this->neg_keys_.size());
+  } else {
+    for (size_t i = 0; i < kBinNum; ++i) {
+      positive += double(this->pos_bins_[i]);
+      negative += double(this->neg_bins_[i]);
+    }
+  }
+  if (positive == 0 || negative == 0) return 0;
+
+  double TP = 0;
+  double FP = 0;
+  // number of (positive, negative) pairs ranked correctly
+  double auc = 0;
+  float target_TP = 1;
+  float target_FPR = 1e-5f;
+  int index = 0;
+  int index2 = 0;
+  // visit the data with the same score from the highest score
+  auto visit = [&](double pos_num, double neg_num) {
+    auc += pos_num * (negative - FP - neg_num) + pos_num * neg_num * 0.5;
+    TP += pos_num;
+    FP += neg_num;
+    bool last = TP + FP == positive + negative;
+    if ((TP > target_TP || last) && index < kRocFigSize) {
+      target_TP += 0.05f * float(positive);
+      if (tpr_fig != nullptr) tpr_fig[index] = float(TP / positive);
+      if (fpr_fig != nullptr) fpr_fig[index] = float(FP / negative);
+      ++index;
+    }
+    if ((FP > target_FPR * negative || last) && index2 < kRocTabSize) {
+      if (fpr_tab != nullptr) fpr_tab[index2] = target_FPR;
+      if (tpr_tab != nullptr) tpr_tab[index2] = float(TP / positive);
+      target_FPR *= 10;
+      ++index2;
+    }
+  };
+
+  if (this->mode_ == AucMode::Exact) {
+    this->Sort();
+    const vector<uint32_t>& pos_keys = this->pos_keys_;
+    const vector<uint32_t>& neg_keys = this->neg_keys_;
+    size_t i = pos_keys.size();
+    size_t j = neg_keys.size();
+    while (i > 0 || j > 0) {
+      uint32_t key = 0;
+      if (i > 0) key = pos_keys[i - 1];
+      if (j > 0) key = (max)(key, neg_keys[j - 1]);
+      size_t pos_num = 0;
+      size_t neg_num = 0;
+      for (; i > 0 && pos_keys[i - 1] == key; --i) ++pos_num;
+      for (; j > 0 && neg_keys[j - 1] == key; --j) ++neg_num;
+      visit(double(pos_num), double(neg_num));
+    }
+  } else {
+    for (size_t i = kBinNum; i > 0; --i) {
+      if (this->pos_bins_[i - 1] == 0 && this->neg_bins_[i - 1] == 0) continue;
+      visit(double(this->pos_bins_[i - 1]), double(this->neg_bins_[i - 1]));
+    }
+  }
+  return float(auc / positive / negative);
+}
+
+}  // namespace model
+}  // namespace sol
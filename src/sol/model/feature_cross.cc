@@ -0,0 +1,106 @@
+/*********************************************************************************
+*     File Name           :     feature_cross.cc
+*     Created By          :     yuewu
+*     Description         :     hashed crosses of feature index ranges
+**********************************************************************************/
+#include "sol/model/feature_cross.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "sol/util/str_util.h"
+
+using namespace std;
+using namespace sol::pario;
+
+namespace sol {
+namespace model {
+
+FeatureCross::FeatureCross() : range_max_(0), input_dim_(0), offset_(0) {
+  this->set_bits(18);
+}
+
+void FeatureCross::set_crosses(const string& spec) {
+  vector<vector<Range>> crosses;
+  index_t offset = 0;
+  for (const string& cross_spec : split(spec, ',')) {
+    if (strip(cross_spec).empty()) continue;
+    vector<Range> ranges;
+    for (const string& range_spec : split(cross_spec, '*')) {
+      const vector<string>& bounds = split(strip(range_spec), '-');
+      Range range = {0, 0};
+      try {
+        if (bounds.size() == 1) {
+          range.lo = range.hi = index_t(stoul(bounds[0]));
+        } else if (bounds.size() == 2) {
+          range.lo = index_t(stoul(bounds[0]));
+          range.hi = index_t(stoul(bounds[1]));
+        }
+      }
+      catch (logic_error&) {
+        range.lo = 0;
+      }
+      if (range.lo == 0 || range.lo > range.hi) {
+        throw invalid_argument("invalid feature range " + range_spec);
+      }
+      if (offset < range.hi) offset = range.hi;
+      ranges.push_back(range);
+    }
+    if (ranges.size() < 2 || ranges.size() > kMaxOrder) {
+      throw invalid_argument("only 2 or 3 ranges can be crossed: " +
+                             cross_spec);
+    }
+    crosses.push_back(ranges);
+  }
+  this->crosses_.swap(crosses);
+  this->range_max_ = offset;
+  this->offset_ = (std::max)(this->range_max_, this->input_dim_);
+  this->spec_ = spec;
+}
+
+void FeatureCross::set_bits(int bits) {
+  if (bits <= 0 || bits > 30) {
+    throw invalid_argument("bits of crossed features should be in [1, 30]");
+  }
+  this->bits_ = bits;
+  this->mask_ = (uint32_t(1) << bits) - 1;
+}
+
+void FeatureCross::set_dim(index_t dim) {
+  this->input_dim_ = dim;
+  this->offset_ = (std::max)(this->range_max_, this->input_dim_);
+}
+
+/// \brief  the original features of a data point being expanded
+struct OriginalFeatures {
+  const DataPoint& x;
+  size_t feat_num;
+
+  inline size_t size() const { return this->feat_num; }
+  inline index_t index(size_t i) const { return this->x.index(i); }
+  inline real_t feature(size_t i) const { return this->x.feature(i); }
+};
+
+bool FeatureCross::Expand(DataPoint& x) const {
+  size_t feat_num = x.size();
+  if (feat_num == 0) return true;
+  bool disjoint = x.index(feat_num - 1) <= this->offset_;
+  OriginalFeatures orig_x = {x, feat_num};
+  this->ForEach(orig_x, [&x](index_t index, real_t feat) {
+    x.AddNewFeat(index, feat);
+  });
+
+  size_t max_pos = feat_num - 1;
+  for (size_t i = feat_num; i < x.size(); ++i) {
+    if (x.index(i) > x.index(max_pos)) max_pos = i;
+  }
+  size_t last = x.size() - 1;
+  if (max_pos != last) {
+    std::swap(x.index(max_pos), x.index(last));
+    std::swap(x.feature(max_pos), x.feature(last));
+  }
+  return disjoint;
+}
+
+}  // namespace model
+}  // namespace sol
@@ -9,6 +9,8 @@
 #include "sol/model/model.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -23,12 +25,6 @@ using namespace sol::pario;
 namespace sol {
 namespace model {
 
-// comparison function
-bool comp(pair<int, double> a, pair<int, double> b)
-{
-	return(a.second > b.second);
-}
-
 Model* Model::Create(const std::string& name, int class_num) {
   auto create_func = CreateObject<Model>(std::string(name) + "_model");
   Model* ins = nullptr;
@@ -49,14 +45,20 @@ Model::Model(int class_num, const std::string& type)
       type_(type),
       norm_type_(op::OpType::kNone),
       regularizer_(nullptr),
-      max_index_(0) {
+      max_index_(0),
+      cross_overlap_shown_(false),
+      mapped_file_(nullptr) {
   Check(class_num > 1);
   this->update_num_ = 0;
   this->require_reinit_ = true;
   this->model_updated_ = false;
 }
 
-Model::~Model() { DeletePointer(this->loss_); }
+Model::~Model() {
+  DeletePointer(this->loss_);
+  // the mapped arrays are released by the derived models already
+  DeletePointer(this->mapped_file_);
+}
 
 void Model::SetParameter(const std::string& name, const std::string& value) {
 
@@ -104,6 +106,15 @@ void Model::SetParameter(const std::string& name, const std::string& value) {
       oss << "unknown norm type " << value;
       throw invalid_argument(oss.str());
     }
+  } else if (name == "cross") {
+    this->feature_cross_.set_crosses(value);
+    this->require_reinit_ = true;
+  } else if (name == "cross_bits") {
+    this->feature_cross_.set_bits(stoi(value));
+    this->require_reinit_ = true;
+  } else if (name == "cross_dim") {
+    this->feature_cross_.set_dim(index_t(stoul(value)));
+    this->require_reinit_ = true;
   } else if (name == "filter") {
     if (this->LoadPreSelFeatures(value) != Status_OK) {
       ostringstream oss;
@@ -121,6 +132,17 @@ void Model::SetParameter(const std::string& name, const std::string& value) {
 }
 
 float Model::Test(DataIter& data_iter, std::ostream* os,float* tpr_fig, float*fpr_fig, float* tpr_tab, float* fpr_tab,float* auc_out) {
+  // ROC is only computed when required, only for binary classification
+  if (tpr_fig == NULL) return this->Test(data_iter, os, nullptr);
+
+  Evaluator evaluator(AucMode::Exact);
+  float err_rate = this->Test(data_iter, os, &evaluator);
+  *auc_out = evaluator.Roc(tpr_fig, fpr_fig, tpr_tab, fpr_tab);
+  return err_rate;
+}
+
+float Model::Test(DataIter& data_iter, std::ostream* os,
+                  Evaluator* evaluator) {
   if (this->model_updated_) this->EndTrain();
 
   size_t err_num = 0;
@@ -130,27 +152,21 @@ float Model::Test(DataIter& data_iter, std::ostream* os,float* tpr_fig, float*fp
     (*os) << "label\tpredict\tscores\n";
   }
 
-  vector<pair<int, double>> prediction;//by Jing
-
-
   float* predicts = new float[this->clf_num()];
   MiniBatch* mb = nullptr;
   while (1) {
     mb = data_iter.Next(mb);
     if (mb == nullptr) break;
     // data_num += mb->size();
+    bool preprocessed = this->IsPreProcessed(*mb);
     for (int i = 0; i < mb->size(); ++i) {
       DataPoint& x = (*mb)[i];
-      this->PreProcess(x);
+      if (!preprocessed) this->PreProcess(x);
       // predict
       label_t label = this->Predict(x, predicts);
-
-	  //by Jing for auc calculation, only for binary classification
-	  if (tpr_fig != NULL)
-	  {
-		  prediction.push_back(pair<int, double>(x.label(), predicts[0]));
-	  }
-
+      if (evaluator != nullptr) {
+        evaluator->Add(x.label(), label, predicts, this->clf_num_);
+      }
 
       if (label != x.label()) err_num++;
       if (os != nullptr) {
@@ -165,73 +181,6 @@ float Model::Test(DataIter& data_iter, std::ostream* os,float* tpr_fig, float*fp
   }
   delete[] predicts;
 
-
-  //by Jing
-
-  if (tpr_fig != NULL)
-  {
-	  int positive = 0;
-	  int negative = 0;
-
-	  for (int i = 0; i < prediction.size(); i++)
-	  {
-		  if (prediction[i].first > 0)
-			  positive++;
-		  else
-			  negative++;
-	  }
-
-	  sort(prediction.begin(), prediction.end(), comp);
-
-	  int TP = 0;
-	  int FP = 0;
-
-
-	  long long AUC = 0;
-
-	  float target_TP = 1;
-	  float target_FPR = 1e-5;
-
-	  int index = 0;
-	  int index2 = 0;
-	  for (int i = 0; i < prediction.size(); i++)
-	  {
-		  if (prediction[i].first > 0)
-		  {
-			  TP++;
-			  //calculate the AUC
-			  AUC = AUC + FP;
-		  }
-		  else
-		  {
-			  FP++;
-		  }
-
-		  float frequence = 0.05;
-		  if ((TP > target_TP) || (i == prediction.size() - 1))
-		  {
-			  target_TP = target_TP + frequence*positive;
-
-			  tpr_fig[index] = (float)TP / positive;
-			  fpr_fig[index]= (float)FP / negative;
-			  index++;
-		  }
-
-		  if ((FP > target_FPR*negative) || (i == prediction.size() - 1))
-		  {
-			  fpr_tab[index2]=target_FPR;
-			  tpr_tab[index2]=(float)TP / positive;
-			  target_FPR = target_FPR * 10;
-			  index2++;
-		  }
-	  }
-
-	  *auc_out = 1 - ((float)AUC / positive) / negative;
-  }
-
-
-
-
   return float(double(err_num) / data_num);
 }
 
@@ -242,7 +191,55 @@ void Model::BeginTrain() {
   this->require_reinit_ = false;
 }
 
-int Model::Save(const string& path) const {
+Model* Model::Clone() {
+  Model* model = Model::Create(this->name(), this->class_num_);
+  if (model == nullptr) return nullptr;
+
+  int ret = Status_OK;
+  Json::Value root;
+  this->GetModelInfo(root);
+  try {
+    ret = model->SetModelInfo(root);
+    if (ret == Status_OK) {
+      model->max_index_ = this->max_index_;
+      model->sel_feat_flags_ = this->sel_feat_flags_;
+      model->BeginTrain();
+      ret = model->Merge(vector<Model*>(1, this));
+    }
+  }
+  catch (invalid_argument& err) {
+    cerr << "clone model failed: " << err.what() << "\n";
+    ret = Status_Invalid_Argument;
+  }
+  if (ret != Status_OK) DeletePointer(model);
+  return model;
+}
+
+// binary format: BinaryHeader, json header of the model info and the arrays,
+// and the arrays aligned to kArrayAlign bytes in the native byte order
+static const char kBinaryMagic[8] = {'S', 'O', 'L', 'M', 'O', 'D', 'E', 'L'};
+static const uint32_t kBinaryVersion = 1;
+static const uint64_t kArrayAlign = 64;
+
+struct BinaryHeader {
+  char magic[sizeof(kBinaryMagic)];
+  uint32_t version;
+  // size of real_t
+  uint32_t real_size;
+  // size of the json header
+  uint64_t info_size;
+  // offset of the first array, the offsets of the arrays in the json header
+  // are relative to it
+  uint64_t data_offset;
+};
+
+inline uint64_t AlignArray(uint64_t offset) {
+  return (offset + kArrayAlign - 1) / kArrayAlign * kArrayAlign;
+}
+
+int Model::Save(const string& path, bool binary) const {
+  if (binary) return this->SaveBinary(path);
+
   ofstream out_file(path.c_str(), ios::out);
   if (!out_file) {
     cerr << "open file " << path << " failed\n";
@@ -260,6 +257,66 @@ int Model::Save(const string& path) const {
   out_file.close();
   return Status_OK;
 }
+int Model::SaveBinary(const string& path) const {
+  vector<ModelArray> arrays;
+  // the arrays are only read
+  const_cast<Model*>(this)->GetModelArrays(arrays);
+  if (arrays.empty()) {
+    cerr << "binary format is not supported by model " << this->name() << "\n";
+    return Status_Invalid_Argument;
+  }
+
+  Json::Value root;
+  this->GetModelInfo(root["info"]);
+  return Model::WriteBinary(path, root, arrays);
+}
+
+int Model::WriteBinary(const string& path, Json::Value& root,
+                       const vector<ModelArray>& arrays) {
+  uint64_t offset = 0;
+  for (const ModelArray& array : arrays) {
+    Json::Value array_info;
+    array_info["name"] = array.first;
+    array_info["offset"] = Json::UInt64(offset);
+    array_info["size"] = Json::UInt64(array.second->size());
+    root["arrays"].append(array_info);
+    offset = AlignArray(offset + array.second->size() * sizeof(real_t));
+  }
+  Json::FastWriter writer;
+  const string& info = writer.write(root);
+
+  BinaryHeader header;
+  memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+  header.version = kBinaryVersion;
+  header.real_size = uint32_t(sizeof(real_t));
+  header.info_size = info.size();
+  header.data_offset = AlignArray(sizeof(header) + info.size());
+
+  ofstream out_file(path.c_str(), ios::out | ios::binary);
+  if (!out_file) {
+    cerr << "open file " << path << " failed\n";
+    return Status_IO_Error;
+  }
+  const char padding[kArrayAlign] = {0};
+  out_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out_file.write(info.data(), info.size());
+  uint64_t pos = sizeof(header) + info.size();
+  offset = header.data_offset;
+  for (const ModelArray& array : arrays) {
+    out_file.write(padding, offset - pos);
+    size_t bytes = array.second->size() * sizeof(real_t);
+    out_file.write(reinterpret_cast<const char*>(array.second->data()), bytes);
+    pos = offset + bytes;
+    offset = AlignArray(pos);
+  }
+  out_file.close();
+  if (!out_file) {
+    cerr << "write file " << path << " failed\n";
+    return Status_IO_Error;
+  }
+  return Status_OK;
+}
+
 //added by jing
 math::Vector<real_t>* Model::Get() const
 {
@@ -274,6 +331,16 @@ Model* Model::Load(const string& path) {
     cerr << "open file " << path << " failed\n";
     return nullptr;
   }
+  // binary models start with the magic
+  char magic[sizeof(kBinaryMagic)] = {0};
+  in_file.read(magic, sizeof(magic));
+  if (in_file && memcmp(magic, kBinaryMagic, sizeof(magic)) == 0) {
+    in_file.close();
+    return Model::LoadBinary(path);
+  }
+  in_file.clear();
+  in_file.seekg(0, ios::beg);
+
   string line;
   getline(in_file, line);
   if (line != "model info:") {
@@ -323,12 +390,138 @@ Model* Model::Load(const string& path) {
   return model;
 }
 
+Model* Model::LoadBinary(const string& path) {
+  MappedFile* file = new MappedFile;
+  if (file->Open(path) != Status_OK) {
+    delete file;
+    return nullptr;
+  }
+
+  int ret = Status_OK;
+  BinaryHeader header;
+  Json::Value root;
+  if (file->size() < sizeof(header)) {
+    ret = Status_Invalid_Format;
+  } else {
+    memcpy(&header, file->data(), sizeof(header));
+    if (header.version != kBinaryVersion ||
+        header.real_size != sizeof(real_t) ||
+        header.data_offset < sizeof(header) + header.info_size ||
+        header.data_offset > file->size()) {
+      ret = Status_Invalid_Format;
+    } else {
+      Json::Reader reader;
+      const char* info = file->data() + sizeof(header);
+      if (reader.parse(info, info + header.info_size, root) == false) {
+        ret = Status_Invalid_Format;
+      }
+    }
+  }
+  if (ret != Status_OK) {
+    cerr << "invalid binary model file " << path << "\n";
+    delete file;
+    return nullptr;
+  }
+
+  const Json::Value& info = root["info"];
+  const Json::Value& checkpoint = root["checkpoint"];
+  string cls_name = info.get("model", "").asString();
+  int cls_num = info.get("cls_num", "0").asInt();
+  Model* model = Model::Create(cls_name, cls_num);
+  if (model == nullptr) {
+    cerr << "create model failed: no model named " << cls_name << "\n";
+    delete file;
+    return nullptr;
+  }
+  try {
+    ret = model->SetModelInfo(info);
+  }
+  catch (invalid_argument& err) {
+    cerr << "set model parameter failed: " << err.what() << "\n";
+    ret = Status_Invalid_Argument;
+  }
+
+  // replace the arrays allocated by SetModelInfo with the mapped ones
+  if (ret == Status_OK) {
+    vector<ModelArray> arrays;
+    model->GetModelArrays(arrays);
+    size_t model_array_num = arrays.size();
+    if (!checkpoint.isNull()) model->GetCheckpointArrays(arrays);
+    const Json::Value& arrays_info = root["arrays"];
+    if (model_array_num == 0 || arrays_info.size() != arrays.size()) {
+      ret = Status_Invalid_Format;
+    }
+    char* data = file->data() + header.data_offset;
+    size_t data_size = file->size() - header.data_offset;
+    for (size_t i = 0; ret == Status_OK && i < arrays.size(); ++i) {
+      const Json::Value& array_info = arrays_info[Json::ArrayIndex(i)];
+      uint64_t offset = array_info["offset"].asUInt64();
+      uint64_t size = array_info["size"].asUInt64();
+      // the sizes of the state arrays are not set by SetModelInfo
+      if (array_info["name"].asString() != arrays[i].first ||
+          (i < model_array_num && size != arrays[i].second->size()) ||
+          offset % kArrayAlign != 0 ||
+          offset > data_size || size > (data_size - offset) / sizeof(real_t)) {
+        cerr << "invalid array " << arrays[i].first << " in " << path << "\n";
+        ret = Status_Invalid_Format;
+      } else {
+        arrays[i].second->attach(reinterpret_cast<real_t*>(data + offset),
+                                 size_t(size));
+      }
+    }
+  }
+
+  if (ret == Status_OK && !checkpoint.isNull()) {
+    ret = model->SetCheckpointInfo(checkpoint);
+  }
+
+  if (ret != Status_OK) {
+    DeletePointer(model);
+    delete file;
+  } else {
+    model->mapped_file_ = file;
+  }
+  return model;
+}
+
+void Model::GetCheckpointArrays(vector<ModelArray>& arrays) {
+  if (this->regularizer_ != nullptr) {
+    this->regularizer_->GetStateArrays(arrays);
+  }
+}
+
+void Model::MemoryUsage(vector<MemoryBlock>& blocks) const {
+  vector<ModelArray> arrays;
+  // the arrays are only read
+  const_cast<Model*>(this)->GetModelArrays(arrays);
+  const_cast<Model*>(this)->GetCheckpointArrays(arrays);
+  for (const ModelArray& arr : arrays) {
+    blocks.push_back(VectorMemory(arr.first, *arr.second));
+  }
+  if (this->sel_feat_flags_.size() > 0) {
+    blocks.push_back(VectorMemory("sel_feat_flags", this->sel_feat_flags_));
+  }
+}
+
+size_t Model::memory_usage() const {
+  vector<MemoryBlock> blocks;
+  this->MemoryUsage(blocks);
+  size_t bytes = 0;
+  for (const MemoryBlock& block : blocks) bytes += block.allocated;
+  return bytes;
+}
+
 void Model::GetModelInfo(Json::Value& root) const {
   root["model"] = this->name();
   root["cls_num"] = this->class_num();
   root["clf_num"] = this->clf_num();
   root["loss"] = this->loss_ == nullptr ? "" : this->loss_->name();
   root["norm"] = int(this->norm_type_);
+  if (!this->feature_cross_.empty()) {
+    root["cross"] = this->feature_cross_.crosses();
+    root["cross_bits"] = this->feature_cross_.bits();
+    root["cross_dim"] = Json::UInt64(this->feature_cross_.input_dim());
+  }
 
   // regularizer
   if (this->regularizer_ != nullptr) {
@@ -353,6 +546,18 @@ int Model::SetModelInfo(const Json::Value& root) {
   }
   // norm
   this->SetParameter("norm", root["norm"].asString());
+  // crosses
+  if (root.isMember("cross")) {
+    try {
+      this->SetParameter("cross_bits", root["cross_bits"].asString());
+      this->SetParameter("cross_dim", root.get("cross_dim", 0).asString());
+      this->SetParameter("cross", root["cross"].asString());
+    }
+    catch (invalid_argument& err) {
+      cerr << "set model info failed: " << err.what() << "\n";
+      return Status_Invalid_Argument;
+    }
+  }
 
   // regularizer
   const Json::Value& relu_settings = root["regularizer"];
@@ -373,6 +578,12 @@ int Model::SetModelInfo(const Json::Value& root) {
 string Model::model_info() const {
   Json::Value root;
   this->GetModelInfo(root);
+  // allocated bytes of the components, not saved with the model
+  vector<MemoryBlock> blocks;
+  this->MemoryUsage(blocks);
+  for (const MemoryBlock& block : blocks) {
+    root["memory"][block.name] = Json::UInt64(block.allocated);
+  }
 
   Json::StyledWriter writer;
   return writer.write(root);
@@ -385,6 +596,14 @@ void Model::PreProcess(DataPoint& x) {
   x.set_label(this->CalibrateLabel(x.label()));
   // filter features
   this->FilterFeatures(x);
+  // cross features
+  if (!this->feature_cross_.empty() && !this->feature_cross_.Expand(x) &&
+      !this->cross_overlap_shown_.exchange(true)) {
+    fprintf(stderr,
+            "features above index %u share the weights with the crossed "
+            "features, set cross_dim to the largest feature index\n",
+            unsigned(this->feature_cross_.offset()));
+  }
 
   // normalize
   if (this->norm_type_ != op::OpType::kNone) {
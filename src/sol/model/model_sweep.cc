@@ -0,0 +1,190 @@
+/*********************************************************************************
+*     File Name           :     model_sweep.cc
+*     Created By          :     yuewu
+*     Description         :     train multiple models with one pass of data
+**********************************************************************************/
+#include "sol/model/model_sweep.h"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+
+#include "sol/model/online_model.h"
+#include "sol/util/block_queue.h"
+#include "sol/util/error_code.h"
+#include "sol/util/thread_task.h"
+#include "sol/util/util.h"
+
+using namespace std;
+using namespace sol::pario;
+
+namespace sol {
+namespace model {
+
+/// \brief  mini-batch of the shared data iterator, recycled after all the
+// models copied it
+struct SharedBatch {
+  MiniBatch* mb;
+  atomic<size_t> ref_num;
+};
+
+/// \brief  data iterator of a model in the sweep, returning copies of the
+// shared mini-batches, as the models modify the data in PreProcess
+class BranchIter : public DataIter {
+ public:
+  BranchIter(DataIter& source, int queue_size)
+      : DataIter(source.batch_size(), 2),
+        source_(source),
+        queue_(queue_size),
+        finished_(false) {}
+
+  /// \brief  dispatch a shared mini-batch, nullptr for the end of data
+  void Push(SharedBatch* batch) { this->queue_.Enqueue(batch); }
+
+  virtual MiniBatch* Next(MiniBatch* prev_batch = nullptr) {
+    if (prev_batch != nullptr) {
+      this->mini_batch_factory_.Enqueue(prev_batch);
+    }
+    SharedBatch* shared = this->queue_.Dequeue();
+    if (shared == nullptr) {
+      // keep the end signal for the following calls
+      this->queue_.Enqueue(nullptr);
+      this->finished_ = true;
+      return nullptr;
+    }
+
+    MiniBatch* mb = this->mini_batch_factory_.Dequeue();
+    const MiniBatch& src = *shared->mb;
+    mb->data_num = src.size();
+    mb->preprocessor = src.preprocessor;
+    for (int i = 0; i < src.size(); ++i) {
+      src[i].Clone((*mb)[i]);
+    }
+    this->ApplyTransforms(*mb);
+    this->Release(shared);
+    return mb;
+  }
+
+  /// \brief  drop the remaining mini-batches if the model stopped before the
+  // end of data, so that the dispatching and the other models are not blocked
+  ///
+  /// \return whether the model stopped before the end of data
+  bool Drain() {
+    if (this->finished_) return false;
+    SharedBatch* shared = nullptr;
+    while ((shared = this->queue_.Dequeue()) != nullptr) {
+      this->Release(shared);
+    }
+    this->queue_.Enqueue(nullptr);
+    this->finished_ = true;
+    return true;
+  }
+
+ protected:
+  void Release(SharedBatch* shared) {
+    if (--shared->ref_num == 0) {
+      this->source_.Recycle(shared->mb);
+      delete shared;
+    }
+  }
+
+ protected:
+  DataIter& source_;
+  BlockQueue<SharedBatch*> queue_;
+  // whether the end of data is reached, only accessed by the training thread
+  bool finished_;
+};
+
+/// \brief  context of CollectIterStat
+struct CurveContext {
+  vector<IterStat>* curve;
+  double start_time;
+};
+
+/// \brief  iteration callback of online models to record the curves
+static void CollectIterStat(void* user_context, long long data_num,
+                            long long iter_num, long long update_num,
+                            double err_rate) {
+  CurveContext* context = static_cast<CurveContext*>(user_context);
+  IterStat stat = {data_num, iter_num, update_num, err_rate,
+                   get_current_time() - context->start_time};
+  context->curve->push_back(stat);
+}
+
+int ModelSweep::Train(DataIter& data_iter) {
+  size_t model_num = this->models_.size();
+  if (model_num == 0) {
+    fprintf(stderr, "no model to train\n");
+    return Status_Invalid_Argument;
+  }
+
+  this->err_rates_.assign(model_num, 0);
+  this->curves_.assign(model_num, vector<IterStat>());
+  vector<unique_ptr<BranchIter>> branches;
+  vector<unique_ptr<FunctionTask>> tasks;
+  // models stopped before the end of data, e.g. failed to init
+  vector<char> failed(model_num, 0);
+  for (size_t i = 0; i < model_num; ++i) {
+    branches.emplace_back(new BranchIter(data_iter, 4));
+    BranchIter* branch = branches.back().get();
+    Model* model = this->models_[i];
+    float* err_rate = &this->err_rates_[i];
+    vector<IterStat>* curve = &this->curves_[i];
+    char* model_failed = &failed[i];
+    tasks.emplace_back(new FunctionTask([branch, model, err_rate, curve,
+                                         model_failed]() {
+      CurveContext context = {curve, get_current_time()};
+      OnlineModel* online_model = dynamic_cast<OnlineModel*>(model);
+      OnlineModel::InspectIterateCallback callback = nullptr;
+      void* user_context = nullptr;
+      if (online_model != nullptr) {
+        callback = online_model->iter_callback();
+        user_context = online_model->iter_callback_user_context();
+        online_model->set_iterate_callback(CollectIterStat, &context);
+      }
+      try {
+        *err_rate = model->Train(*branch, NULL, NULL, NULL, NULL, NULL, NULL);
+      }
+      catch (exception& err) {
+        fprintf(stderr, "%s\n", err.what());
+      }
+      if (online_model != nullptr) {
+        online_model->set_iterate_callback(callback, user_context);
+      }
+      *model_failed = branch->Drain() ? 1 : 0;
+    }));
+    tasks.back()->Start();
+  }
+
+  // parse once and dispatch the mini-batches to all the models
+  while (1) {
+    MiniBatch* mb = data_iter.Next(nullptr);
+    if (mb == nullptr) break;
+    SharedBatch* shared = new SharedBatch;
+    shared->mb = mb;
+    shared->ref_num = model_num;
+    for (unique_ptr<BranchIter>& branch : branches) {
+      branch->Push(shared);
+    }
+  }
+  for (unique_ptr<BranchIter>& branch : branches) {
+    branch->Push(nullptr);
+  }
+
+  for (unique_ptr<FunctionTask>& task : tasks) {
+    task->Join();
+  }
+  int ret = Status_OK;
+  for (size_t i = 0; i < model_num; ++i) {
+    if (failed[i] != 0) {
+      fprintf(stderr, "training of model %d stopped before the end of data\n",
+              int(i));
+      ret = Status_Error;
+    }
+  }
+  return ret;
+}
+
+}  // namespace model
+}  // namespace sol
@@ -8,6 +8,7 @@
 #include <cmath>
 
 #include "sol/loss/hinge_loss.h"
+#include "sol/model/train_loop.h"
 
 using namespace std;
 using namespace sol;
@@ -41,20 +42,54 @@ void AdaFOBOS::SetParameter(const std::string& name, const std::string& value) {
 }
 
 void AdaFOBOS::Update(const pario::DataPoint& dp, const float*, float loss) {
+  this->ApplyGradients(dp, &g(0), this->cur_iter_num_);
+}
+
+bool AdaFOBOS::SelectTrainLoops(TrainLoopFunc* loops) {
+  return TrainLoop<AdaFOBOS>::Select(this, loops);
+}
+
+void AdaFOBOS::ApplyGradients(const pario::DataPoint& dp,
+                              const real_t* gradients, int) {
   const auto& x = dp.data();
   for (int c = 0; c < this->clf_num_; ++c) {
-    if (g(c) == 0) continue;
+    real_t grad = gradients[c];
+    if (grad == 0) continue;
 
-    H_[c] = Sqrt(L2(H_[c] - delta_) + L2(g(c) * x)) + delta_;
+    H_[c] = Sqrt(L2(H_[c] - delta_) + L2(grad * x)) + delta_;
     H_[c][0] =
-        sqrtf((H_[c][0] - delta_) * (H_[c][0] - delta_) + g(c) * g(c)) + delta_;
+        sqrtf((H_[c][0] - delta_) * (H_[c][0] - delta_) + grad * grad) +
+        delta_;
 
-    w(c) -= eta_ * g(c) * x / H_[c];
+    w(c) -= eta_ * grad * x / H_[c];
     // update bias
-    w(c)[0] -= bias_eta() * g(c) / H_[c][0];
+    w(c)[0] -= bias_eta() * grad / H_[c][0];
   }
 }
 
+void AdaFOBOS::ApplyBatchGradients(const math::SVector<real_t>* grads,
+                                   const real_t* bias_grads, int) {
+  for (int c = 0; c < this->clf_num_; ++c) {
+    const SVector<real_t>& grad = grads[c];
+    real_t bias_grad = bias_grads[c];
+    if (grad.size() == 0 && bias_grad == 0) continue;
+
+    H_[c] = Sqrt(L2(H_[c] - delta_) + L2(grad)) + delta_;
+    H_[c][0] = sqrtf((H_[c][0] - delta_) * (H_[c][0] - delta_) +
+                     bias_grad * bias_grad) +
+               delta_;
+
+    w(c) -= eta_ * grad / H_[c];
+    // update bias
+    w(c)[0] -= bias_eta() * bias_grad / H_[c][0];
+  }
+}
+
+bool AdaFOBOS::GetStateVectors(std::vector<math::Vector<real_t>*>& states) {
+  for (int c = 0; c < this->clf_num_; ++c) states.push_back(&this->H_[c]);
+  return this->regularizer_ == nullptr;
+}
+
 void AdaFOBOS::update_dim(index_t dim) {
   if (dim > this->dim_) {
     real_t delta = real_t(this->delta_);
@@ -67,6 +102,11 @@ void AdaFOBOS::update_dim(index_t dim) {
   }
 }
 
+void AdaFOBOS::EvictFeature(index_t index) {
+  OnlineLinearModel::EvictFeature(index);
+  for (int c = 0; c < this->clf_num_; ++c) this->H_[c][index] = this->delta_;
+}
+
 void AdaFOBOS::GetModelInfo(Json::Value& root) const {
   OnlineLinearModel::GetModelInfo(root);
   root["online"]["delta"] = this->delta_;
@@ -91,6 +131,13 @@ int AdaFOBOS::SetModelParam(std::istream& is) {
   return Status_OK;
 }
 
+void AdaFOBOS::GetModelArrays(std::vector<ModelArray>& arrays) {
+  OnlineLinearModel::GetModelArrays(arrays);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(ModelArray("H[" + to_string(c) + "]", &this->H_[c]));
+  }
+}
+
 RegisterModel(AdaFOBOS, "ada-fobos", "Adaptive Subgradient FOBOS");
 
 AdaFOBOS_L1::AdaFOBOS_L1(int class_num) : AdaFOBOS(class_num) {
@@ -98,15 +145,12 @@ AdaFOBOS_L1::AdaFOBOS_L1(int class_num) : AdaFOBOS(class_num) {
 }
 
 label_t AdaFOBOS_L1::TrainPredict(const pario::DataPoint& dp, float* predicts) {
-  const auto& x = dp.data();
   real_t t = real_t(cur_iter_num_ - 1);
   for (int c = 0; c < this->clf_num_; ++c) {
     // trucate weights
-    w(c) =
-        expr::truncate(w(c).slice(x), (eta_ * l1_.lambda()) *
-                                          (t - l1_.last_update_time()) / H_[c]);
+    l1_.CatchUp(w(c), dp, eta_, t, H_[c]);
     // truncate bias
-    w(c)[0] = expr::truncate(w(c)[0], bias_eta() * l1_.lambda() / H_[c][0]);
+    w(c)[0] = l1_.CatchUp(w(c)[0], bias_eta(), 1, H_[c][0]);
   }
 
   return OnlineLinearModel::TrainPredict(dp, predicts);
@@ -116,14 +160,22 @@ void AdaFOBOS_L1::EndTrain() {
   real_t t = real_t(cur_iter_num_);
   for (int c = 0; c < this->clf_num_; ++c) {
     // trucate weights
-    w(c) = expr::truncate(
-        w(c), (eta_ * l1_.lambda()) * (t - l1_.last_update_time()) / H_[c]);
+    l1_.Flush(w(c), eta_, t, H_[c]);
     // truncate bias
-    w(c)[0] = expr::truncate(w(c)[0], bias_eta() * l1_.lambda() / H_[c][0]);
+    w(c)[0] = l1_.CatchUp(w(c)[0], bias_eta(), 1, H_[c][0]);
   }
+  l1_.set_last_update_time(t);
   AdaFOBOS::EndTrain();
 }
 
+void AdaFOBOS_L1::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  real_t t = real_t(cur_iter_num_);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    l1_.Flush(weights[c], eta_, t, H_[c]);
+    weights[c][0] = l1_.CatchUp(weights[c][0], bias_eta(), 1, H_[c][0]);
+  }
+}
+
 RegisterModel(AdaFOBOS_L1, "ada-fobos-l1",
               "Adaptive Subgradient FOBOS with l1 regularization");
 
@@ -8,6 +8,8 @@
 #include <cmath>
 #include <iostream>
 
+#include "sol/model/train_loop.h"
+
 using namespace std;
 using namespace sol;
 using namespace sol::math;
@@ -48,16 +50,27 @@ void AdaRDA::SetParameter(const std::string& name, const std::string& value) {
 }
 
 void AdaRDA::Update(const pario::DataPoint& dp, const float*, float loss) {
+  this->ApplyGradients(dp, &g(0), this->cur_iter_num_);
+}
+
+bool AdaRDA::SelectTrainLoops(TrainLoopFunc* loops) {
+  return TrainLoop<AdaRDA>::Select(this, loops);
+}
+
+void AdaRDA::ApplyGradients(const pario::DataPoint& dp, const real_t* gradients,
+                            int) {
   const auto& x = dp.data();
   for (int c = 0; c < this->clf_num_; ++c) {
-    if (g(c) == 0) continue;
+    real_t grad = gradients[c];
+    if (grad == 0) continue;
 
-    H_[c] = Sqrt(L2(H_[c] - delta_) + L2(g(c) * x)) + delta_;
+    H_[c] = Sqrt(L2(H_[c] - delta_) + L2(grad * x)) + delta_;
     H_[c][0] =
-        sqrtf((H_[c][0] - delta_) * (H_[c][0] - delta_) + g(c) * g(c)) + delta_;
+        sqrtf((H_[c][0] - delta_) * (H_[c][0] - delta_) + grad * grad) +
+        delta_;
 
-    ut_[c] += g(c) * x;
-    ut_[c][0] += g(c);
+    ut_[c] += grad * x;
+    ut_[c][0] += grad;
 
     w(c) = -eta_ * ut_[c].slice(x) / H_[c];
     // update bias
@@ -65,6 +78,27 @@ void AdaRDA::Update(const pario::DataPoint& dp, const float*, float loss) {
   }
 }
 
+void AdaRDA::ApplyBatchGradients(const math::SVector<real_t>* grads,
+                                 const real_t* bias_grads, int) {
+  for (int c = 0; c < this->clf_num_; ++c) {
+    const SVector<real_t>& grad = grads[c];
+    real_t bias_grad = bias_grads[c];
+    if (grad.size() == 0 && bias_grad == 0) continue;
+
+    H_[c] = Sqrt(L2(H_[c] - delta_) + L2(grad)) + delta_;
+    H_[c][0] = sqrtf((H_[c][0] - delta_) * (H_[c][0] - delta_) +
+                     bias_grad * bias_grad) +
+               delta_;
+
+    ut_[c] += grad;
+    ut_[c][0] += bias_grad;
+
+    w(c) = -eta_ * ut_[c].slice(grad) / H_[c];
+    // update bias
+    w(c)[0] *= bias_eta0_;
+  }
+}
+
 void AdaRDA::EndTrain() {
   for (int c = 0; c < this->clf_num_; ++c) {
     w(c) = -eta_ * ut_[c] / H_[c];
@@ -74,6 +108,13 @@ void AdaRDA::EndTrain() {
   OnlineLinearModel::EndTrain();
 }
 
+void AdaRDA::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  for (int c = 0; c < this->clf_num_; ++c) {
+    weights[c] = -eta_ * ut_[c] / H_[c];
+    weights[c][0] *= bias_eta0_;
+  }
+}
+
 void AdaRDA::update_dim(index_t dim) {
   if (dim > this->dim_) {
     real_t delta = real_t(this->delta_);
@@ -89,6 +130,14 @@ void AdaRDA::update_dim(index_t dim) {
   }
 }
 
+void AdaRDA::EvictFeature(index_t index) {
+  OnlineLinearModel::EvictFeature(index);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    this->H_[c][index] = this->delta_;
+    this->ut_[c][index] = 0;
+  }
+}
+
 void AdaRDA::GetModelInfo(Json::Value& root) const {
   OnlineLinearModel::GetModelInfo(root);
   root["online"]["delta"] = this->delta_;
@@ -121,6 +170,16 @@ int AdaRDA::SetModelParam(std::istream& is) {
   return Status_OK;
 }
 
+void AdaRDA::GetModelArrays(std::vector<ModelArray>& arrays) {
+  OnlineLinearModel::GetModelArrays(arrays);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(ModelArray("H[" + to_string(c) + "]", &this->H_[c]));
+  }
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(ModelArray("ut[" + to_string(c) + "]", &this->ut_[c]));
+  }
+}
+
 RegisterModel(AdaRDA, "ada-rda", "Adaptive Subgradient RDA");
 
 AdaRDA_L1::AdaRDA_L1(int class_num) : AdaRDA(class_num) {
@@ -149,6 +208,14 @@ void AdaRDA_L1::EndTrain() {
   OnlineLinearModel::EndTrain();
 }
 
+void AdaRDA_L1::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  real_t trunc_thresh = real_t(l1_.lambda() * cur_iter_num_);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    weights[c] = -eta_ * expr::truncate(ut_[c], trunc_thresh) / H_[c];
+    weights[c][0] *= bias_eta0_;
+  }
+}
+
 RegisterModel(AdaRDA_L1, "ada-rda-l1",
               "Adaptive Subgradient RDA with l1 regularization");
 
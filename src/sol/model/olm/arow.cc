@@ -6,6 +6,7 @@
 
 #include "sol/model/olm/arow.h"
 #include "sol/loss/hinge_loss.h"
+#include "sol/model/train_loop.h"
 
 using namespace std;
 using namespace sol;
@@ -74,6 +75,10 @@ void AROW::Update(const pario::DataPoint& dp, const float*, float loss) {
   }
 }
 
+bool AROW::SelectTrainLoops(TrainLoopFunc* loops) {
+  return TrainLoop<AROW>::Select(this, loops);
+}
+
 void AROW::update_dim(index_t dim) {
   if (dim > this->dim_) {
     for (int c = 0; c < this->clf_num_; ++c) {
@@ -86,6 +91,11 @@ void AROW::update_dim(index_t dim) {
   }
 }
 
+bool AROW::GetStateVectors(std::vector<math::Vector<real_t>*>& states) {
+  for (int c = 0; c < this->clf_num_; ++c) states.push_back(&Sigma(c));
+  return this->regularizer_ == nullptr;
+}
+
 void AROW::GetModelInfo(Json::Value& root) const {
   OnlineLinearModel::GetModelInfo(root);
   root["online"]["r"] = this->r_;
@@ -110,6 +120,14 @@ int AROW::SetModelParam(std::istream& is) {
   return Status_OK;
 }
 
+void AROW::GetModelArrays(std::vector<ModelArray>& arrays) {
+  OnlineLinearModel::GetModelArrays(arrays);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(
+        ModelArray("Sigma[" + to_string(c) + "]", &this->Sigmas_[c]));
+  }
+}
+
 RegisterModel(AROW, "arow", "Adaptive Regularization of Weight Vectors");
 
 SOFS::SOFS(int class_num) : AROW(class_num) {
@@ -250,6 +268,47 @@ void SOFS::update_dim(index_t dim) {
   }
 }
 
+bool SOFS::GetStateVectors(std::vector<math::Vector<real_t>*>& states) {
+  AROW::GetStateVectors(states);
+  return true;
+}
+
+void SOFS::MemoryUsage(vector<MemoryBlock>& blocks) const {
+  AROW::MemoryUsage(blocks);
+  // Sigma_sum_ is the Sigma of the only classifier in binary classification
+  if (this->clf_num_ > 1) {
+    blocks.push_back(VectorMemory("Sigma_sum", *this->Sigma_sum_));
+  }
+  MemoryBlock heap = {"max_heap", this->max_heap_.used_bytes(),
+                      this->max_heap_.allocated_bytes()};
+  blocks.push_back(heap);
+}
+
+void SOFS::EndMerge() {
+  AROW::EndMerge();
+  index_t B = static_cast<index_t>(this->l0_.lambda());
+  if (B == 0) return;
+
+  if (this->clf_num_ > 1) {
+    (*this->Sigma_sum_) = 0;
+    for (int i = 0; i < this->clf_num_; ++i) {
+      (*this->Sigma_sum_) += Sigma(i);
+    }
+  }
+  // select the top B features again
+  this->max_heap_.BuildHeap();
+  for (index_t idx = 0; idx + 1 < this->dim_; ++idx) {
+    this->max_heap_.UpdateHeap(idx);
+  }
+  for (index_t idx = 0; idx + 1 < this->dim_; ++idx) {
+    if (this->max_heap_.get_pos(idx) >= B) {
+      for (int c = 0; c < this->clf_num_; ++c) {
+        w(c)[idx + 1] = 0;
+      }
+    }
+  }
+}
+
 RegisterModel(SOFS, "sofs", "Second Order Online Feature Selection");
 
 }  // namespace model
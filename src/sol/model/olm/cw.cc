@@ -116,6 +116,11 @@ void CW::update_dim(index_t dim) {
   }
 }
 
+bool CW::GetStateVectors(std::vector<math::Vector<real_t>*>& states) {
+  for (int c = 0; c < this->clf_num_; ++c) states.push_back(&this->Sigmas_[c]);
+  return this->regularizer_ == nullptr;
+}
+
 void CW::GetModelInfo(Json::Value& root) const {
   OnlineLinearModel::GetModelInfo(root);
   root["online"]["a"] = this->a_;
@@ -141,6 +146,14 @@ int CW::SetModelParam(std::istream& is) {
   return Status_OK;
 }
 
+void CW::GetModelArrays(std::vector<ModelArray>& arrays) {
+  OnlineLinearModel::GetModelArrays(arrays);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(
+        ModelArray("Sigma[" + to_string(c) + "]", &this->Sigmas_[c]));
+  }
+}
+
 RegisterModel(CW, "cw", "confidence weighted online learning");
 
 }  // namespace model
@@ -126,6 +126,11 @@ void ECCW::set_phi(float phi) {
   this->xi_ = 1 + phi * phi;
 }
 
+bool ECCW::GetStateVectors(std::vector<math::Vector<real_t>*>& states) {
+  for (int c = 0; c < this->clf_num_; ++c) states.push_back(&this->Sigmas_[c]);
+  return this->regularizer_ == nullptr;
+}
+
 void ECCW::GetModelInfo(Json::Value& root) const {
   OnlineLinearModel::GetModelInfo(root);
   root["online"]["a"] = this->a_;
@@ -151,6 +156,14 @@ int ECCW::SetModelParam(std::istream& is) {
   return Status_OK;
 }
 
+void ECCW::GetModelArrays(std::vector<ModelArray>& arrays) {
+  OnlineLinearModel::GetModelArrays(arrays);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(
+        ModelArray("Sigma[" + to_string(c) + "]", &this->Sigmas_[c]));
+  }
+}
+
 RegisterModel(ECCW, "eccw", "exact convex confidence weighted online learning");
 
 }  // namespace model
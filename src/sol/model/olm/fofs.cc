@@ -12,7 +12,9 @@ using namespace sol::math;
 namespace sol {
 namespace model {
 
-FOFS::FOFS(int class_num) : OnlineLinearModel(class_num), lambda_(0.f), B_(0) {}
+FOFS::FOFS(int class_num)
+    : OnlineLinearModel(class_num), lambda_(0.f), B_(0), full_trunc_(false) {
+}
 
 FOFS::~FOFS() {}
 
@@ -49,6 +51,7 @@ void FOFS::BeginTrain() {
       abs_w += L1(w(i));
     }
     this->min_heap_.Init(this->dim_ - 1, this->B_, abs_w.data() + 1);
+    this->full_trunc_ = true;
   }
 }
 
@@ -79,20 +82,41 @@ void FOFS::Update(const pario::DataPoint& dp, const float* predict,
     }
 
     // update heap
-    this->min_heap_.BuildHeap();
-    index_t valid_dim = this->dim_ - 1;  // ignore bias
-    for (index_t i = 0; i < valid_dim; ++i) {
-      index_t ret_idx = this->min_heap_.UpdateHeap(i);
-      if (ret_idx != invalid_index) {
-        ++ret_idx;
-        for (int c = 0; c < this->clf_num_; ++c) {
-          w(c)[ret_idx] = 0;
-        }
-        abs_w[ret_idx] = 0;
+    if (this->full_trunc_) {
+      // weights out of the heap may be non-zero after BeginTrain
+      this->min_heap_.BuildHeap();
+      index_t valid_dim = this->dim_ - 1;  // ignore bias
+      for (index_t i = 0; i < valid_dim; ++i) {
+        this->TruncateWeight(i);
+      }
+      this->full_trunc_ = false;
+    } else {
+      // weights out of the heap are all zero, only features of the current
+      // instance may change the heap
+      const auto& indexes = dp.indexes();
+      for (const index_t* iter = indexes.begin(); iter != indexes.end();
+           ++iter) {
+        if (*iter > 0) this->min_heap_.MarkUpdated(*iter - 1);
+      }
+      this->min_heap_.AdjustMarkedHeap();
+      for (const index_t* iter = indexes.begin(); iter != indexes.end();
+           ++iter) {
+        if (*iter > 0) this->TruncateWeight(*iter - 1);
       }
     }
   }
 }
+
+void FOFS::TruncateWeight(index_t idx) {
+  index_t ret_idx = this->min_heap_.UpdateHeap(idx);
+  if (ret_idx != invalid_index) {
+    ++ret_idx;
+    for (int c = 0; c < this->clf_num_; ++c) {
+      w(c)[ret_idx] = 0;
+    }
+    this->abs_weights_[ret_idx] = 0;
+  }
+}
 void FOFS::update_dim(index_t dim) {
   if (dim > this->dim_) {
     math::Vector<real_t>& abs_w = this->abs_weights_;
@@ -104,6 +128,14 @@ void FOFS::update_dim(index_t dim) {
   }
 }
 
+void FOFS::MemoryUsage(vector<MemoryBlock>& blocks) const {
+  OnlineLinearModel::MemoryUsage(blocks);
+  blocks.push_back(VectorMemory("abs_weights", this->abs_weights_));
+  MemoryBlock heap = {"min_heap", this->min_heap_.used_bytes(),
+                      this->min_heap_.allocated_bytes()};
+  blocks.push_back(heap);
+}
+
 void FOFS::GetModelInfo(Json::Value& root) const {
   OnlineLinearModel::GetModelInfo(root);
   root["online"]["eta"] = this->eta_;
@@ -10,6 +10,8 @@
 
 #include <cmath>
 
+#include "sol/model/train_loop.h"
+
 using namespace std;
 using namespace sol::math;
 using namespace sol::math::expr;
@@ -31,14 +33,36 @@ void OGD::SetParameter(const std::string& name, const std::string& value) {
   }
 }
 void OGD::Update(const pario::DataPoint& dp, const float*, float) {
-  const auto& x = dp.data();
   eta_ = eta0_ / this->pow_(this->cur_iter_num_, this->power_t_);
+  this->ApplyGradients(dp, &g(0), this->cur_iter_num_);
+}
+
+bool OGD::SelectTrainLoops(TrainLoopFunc* loops) {
+  return TrainLoop<OGD>::Select(this, loops);
+}
+
+void OGD::ApplyGradients(const pario::DataPoint& dp, const real_t* gradients,
+                         int t) {
+  const auto& x = dp.data();
+  float eta = eta0_ / this->pow_(t, this->power_t_);
+
+  for (int c = 0; c < this->clf_num_; ++c) {
+    if (gradients[c] == 0) continue;
+    w(c) -= eta * gradients[c] * x;
+    // update bias
+    w(c)[0] -= this->bias_eta0_ * eta * gradients[c];
+  }
+}
+
+void OGD::ApplyBatchGradients(const math::SVector<real_t>* grads,
+                              const real_t* bias_grads, int t) {
+  float eta = eta0_ / this->pow_(t, this->power_t_);
 
   for (int c = 0; c < this->clf_num_; ++c) {
-    if (g(c) == 0) continue;
-    w(c) -= this->eta_ * g(c) * x;
+    if (grads[c].size() == 0 && bias_grads[c] == 0) continue;
+    w(c) -= eta * grads[c];
     // update bias
-    w(c)[0] -= bias_eta() * g(c);
+    w(c)[0] -= this->bias_eta0_ * eta * bias_grads[c];
   }
 }
 
@@ -71,7 +95,10 @@ void OGD::set_power_t(float power_t) {
 
 RegisterModel(OGD, "ogd", "Online Gradient Descent");
 
-STG::STG(int class_num) : OGD(class_num), k_(1) { this->regularizer_ = &l1_; }
+STG::STG(int class_num)
+    : OGD(class_num), k_(1), trunc_time_restored_(false) {
+  this->regularizer_ = &l1_;
+}
 
 void STG::SetParameter(const std::string& name, const std::string& value) {
   if (name == "k") {
@@ -84,8 +111,11 @@ void STG::SetParameter(const std::string& name, const std::string& value) {
 
 void STG::BeginTrain() {
   OGD::BeginTrain();
-  this->last_trunc_time_.resize(this->dim_);
-  this->last_trunc_time_ = real_t(this->initial_t_);
+  if (this->trunc_time_restored_ == false) {
+    this->last_trunc_time_.resize(this->dim_);
+    this->last_trunc_time_ = real_t(this->initial_t_);
+  }
+  this->trunc_time_restored_ = false;
 }
 
 label_t STG::TrainPredict(const pario::DataPoint& dp, float* predicts) {
@@ -120,6 +150,14 @@ void STG::EndTrain() {
   OGD::EndTrain();
 }
 
+void STG::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  real_t t = real_t(cur_iter_num_);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    weights[c] =
+        truncate(weights[c], (eta_ * l1_.lambda()) * (t - last_trunc_time_));
+  }
+}
+
 void STG::update_dim(index_t dim) {
   if (dim > this->dim_) {
     this->last_trunc_time_.resize(dim);
@@ -135,6 +173,16 @@ void STG::GetModelInfo(Json::Value& root) const {
   root["online"]["k"] = this->k_;
 }
 
+void STG::GetCheckpointArrays(std::vector<ModelArray>& arrays) {
+  OGD::GetCheckpointArrays(arrays);
+  arrays.push_back(ModelArray("last_trunc_time", &this->last_trunc_time_));
+}
+
+int STG::SetCheckpointInfo(const Json::Value& root) {
+  this->trunc_time_restored_ = true;
+  return OGD::SetCheckpointInfo(root);
+}
+
 RegisterModel(STG, "stg", "Sparse Online Learning via Truncated Gradient");
 
 FOBOS_L1::FOBOS_L1(int class_num) : OGD(class_num) {
@@ -142,14 +190,12 @@ FOBOS_L1::FOBOS_L1(int class_num) : OGD(class_num) {
 }
 
 label_t FOBOS_L1::TrainPredict(const pario::DataPoint& dp, float* predicts) {
-  const auto& x = dp.data();
   real_t t = real_t(cur_iter_num_ - 1);
   for (int c = 0; c < this->clf_num_; ++c) {
     // trucate weights
-    w(c) = truncate(w(c).slice(x),
-                    (eta_ * l1_.lambda()) * (t - l1_.last_update_time()));
+    l1_.CatchUp(w(c), dp, eta_, t);
     // truncate bias
-    w(c)[0] = truncate(w(c)[0], bias_eta() * l1_.lambda());
+    w(c)[0] = l1_.CatchUp(w(c)[0], bias_eta(), 1);
   }
 
   return OnlineLinearModel::TrainPredict(dp, predicts);
@@ -159,17 +205,28 @@ void FOBOS_L1::EndTrain() {
   real_t t = real_t(cur_iter_num_);
   for (int c = 0; c < this->clf_num_; ++c) {
     // trucate weights
-    w(c) = truncate(w(c), (eta_ * l1_.lambda()) * (t - l1_.last_update_time()));
+    l1_.Flush(w(c), eta_, t);
     // truncate bias
-    w(c)[0] = truncate(w(c)[0], bias_eta() * l1_.lambda());
+    w(c)[0] = l1_.CatchUp(w(c)[0], bias_eta(), 1);
   }
+  l1_.set_last_update_time(t);
   OGD::EndTrain();
 }
 
+void FOBOS_L1::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  real_t t = real_t(cur_iter_num_);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    l1_.Flush(weights[c], eta_, t);
+    weights[c][0] = l1_.CatchUp(weights[c][0], bias_eta(), 1);
+  }
+}
+
 RegisterModel(FOBOS_L1, "fobos-l1",
               "Forward Backward Splitting l1 regularization");
 
-PET::PET(int class_num) : OGD(class_num) { this->regularizer_ = &(this->l0_); }
+PET::PET(int class_num) : OGD(class_num), full_trunc_(false) {
+  this->regularizer_ = &(this->l0_);
+}
 
 PET::~PET() {}
 
@@ -197,6 +254,7 @@ void PET::BeginTrain() {
       abs_w += L1(w(i));
     }
     this->min_heap_.Init(this->dim_ - 1, B, abs_w.data() + 1);
+    this->full_trunc_ = true;
   }
 }
 
@@ -214,18 +272,39 @@ void PET::Update(const pario::DataPoint& dp, const float* predict, float loss) {
     }
 
     // update heap
-    this->min_heap_.BuildHeap();
-    index_t valid_dim = this->dim_ - 1;  // ignore bias
-    for (index_t i = 0; i < valid_dim; ++i) {
-      index_t ret_idx = this->min_heap_.UpdateHeap(i);
-      if (ret_idx != invalid_index) {
-        ++ret_idx;
-        for (int c = 0; c < this->clf_num_; ++c) {
-          w(c)[ret_idx] = 0;
-        }
-        abs_w[ret_idx] = 0;
+    if (this->full_trunc_) {
+      // weights out of the heap may be non-zero after BeginTrain
+      this->min_heap_.BuildHeap();
+      index_t valid_dim = this->dim_ - 1;  // ignore bias
+      for (index_t i = 0; i < valid_dim; ++i) {
+        this->TruncateWeight(i);
+      }
+      this->full_trunc_ = false;
+    } else {
+      // weights out of the heap are all zero, only features of the current
+      // instance may change the heap
+      const auto& indexes = dp.indexes();
+      for (const index_t* iter = indexes.begin(); iter != indexes.end();
+           ++iter) {
+        if (*iter > 0) this->min_heap_.MarkUpdated(*iter - 1);
       }
+      this->min_heap_.AdjustMarkedHeap();
+      for (const index_t* iter = indexes.begin(); iter != indexes.end();
+           ++iter) {
+        if (*iter > 0) this->TruncateWeight(*iter - 1);
+      }
+    }
+  }
+}
+
+void PET::TruncateWeight(index_t idx) {
+  index_t ret_idx = this->min_heap_.UpdateHeap(idx);
+  if (ret_idx != invalid_index) {
+    ++ret_idx;
+    for (int c = 0; c < this->clf_num_; ++c) {
+      w(c)[ret_idx] = 0;
     }
+    this->abs_weights_[ret_idx] = 0;
   }
 }
 
@@ -240,6 +319,14 @@ void PET::update_dim(index_t dim) {
   }
 }
 
+void PET::MemoryUsage(vector<MemoryBlock>& blocks) const {
+  OGD::MemoryUsage(blocks);
+  blocks.push_back(VectorMemory("abs_weights", this->abs_weights_));
+  MemoryBlock heap = {"min_heap", this->min_heap_.used_bytes(),
+                      this->min_heap_.allocated_bytes()};
+  blocks.push_back(heap);
+}
+
 RegisterModel(PET, "pet", "Perceptron with Truncation");
 }  // namespace model
 }  // namespace sol
@@ -7,6 +7,8 @@
 #include "sol/model/olm/pa.h"
 #include <algorithm>
 
+#include "sol/model/train_loop.h"
+
 using namespace std;
 using namespace sol::math::expr;
 
@@ -29,6 +31,10 @@ void PA::Update(const pario::DataPoint& dp, const float*, float loss) {
   }
 }
 
+bool PA::SelectTrainLoops(TrainLoopFunc* loops) {
+  return TrainLoop<PA>::Select(this, loops);
+}
+
 RegisterModel(PA, "pa", "Online Passive Aggressive");
 
 void PAI::SetParameter(const std::string& name, const std::string& value) {
@@ -50,6 +56,10 @@ void PAI::Update(const pario::DataPoint& dp, const float*, float loss) {
     w(c)[0] -= bias_eta() * g(c);
   }
 }
+
+bool PAI::SelectTrainLoops(TrainLoopFunc* loops) {
+  return TrainLoop<PAI>::Select(this, loops);
+}
 void PAI::GetModelInfo(Json::Value& root) const {
   PA::GetModelInfo(root);
   root["online"]["C"] = this->C_;
@@ -76,6 +86,10 @@ void PAII::Update(const pario::DataPoint& dp, const float*, float loss) {
   }
 }
 
+bool PAII::SelectTrainLoops(TrainLoopFunc* loops) {
+  return TrainLoop<PAII>::Select(this, loops);
+}
+
 void PAII::GetModelInfo(Json::Value& root) const {
   PA::GetModelInfo(root);
   root["online"]["C"] = this->C_;
@@ -6,6 +6,7 @@
 
 #include "sol/model/olm/perceptron.h"
 #include "sol/loss/bool_loss.h"
+#include "sol/model/train_loop.h"
 
 using namespace std;
 using namespace sol;
@@ -46,6 +47,10 @@ void Perceptron::Update(const pario::DataPoint& dp, const float*, float) {
   }
 }
 
+bool Perceptron::SelectTrainLoops(TrainLoopFunc* loops) {
+  return TrainLoop<Perceptron>::Select(this, loops);
+}
+
 RegisterModel(Perceptron, "perceptron", "perceptron algorithm");
 
 }  // namespace model
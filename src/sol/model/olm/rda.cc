@@ -67,6 +67,15 @@ void RDA::EndTrain() {
   OnlineLinearModel::EndTrain();
 }
 
+void RDA::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  real_t t = real_t(cur_iter_num_ + 1e-20);
+  real_t eta = 1.f / (t * sigma_);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    weights[c] = -eta * ut_[c];
+    weights[c][0] = -bias_eta0_ * eta * ut_[c][0];
+  }
+}
+
 void RDA::update_dim(index_t dim) {
   if (dim > this->dim_) {
     for (int c = 0; c < this->clf_num_; ++c) {
@@ -102,6 +111,13 @@ int RDA::SetModelParam(std::istream& is) {
   return Status_OK;
 }
 
+void RDA::GetModelArrays(std::vector<ModelArray>& arrays) {
+  OnlineLinearModel::GetModelArrays(arrays);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(ModelArray("ut[" + to_string(c) + "]", &this->ut_[c]));
+  }
+}
+
 RegisterModel(RDA, "rda", "l2^2 regularized dual averaging");
 
 RDA_L1::RDA_L1(int class_num) : RDA(class_num) { this->regularizer_ = &l1_; }
@@ -131,6 +147,17 @@ void RDA_L1::EndTrain() {
   OnlineLinearModel::EndTrain();
 }
 
+void RDA_L1::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  real_t t = real_t(cur_iter_num_ + 1e-20);
+  real_t trunc_thresh = l1_.lambda() * t;
+  real_t eta = 1.f / (t * sigma_);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    weights[c] = -eta * expr::truncate(ut_[c], trunc_thresh);
+    weights[c][0] =
+        -bias_eta0_ * eta * expr::truncate(ut_[c][0], trunc_thresh);
+  }
+}
+
 RegisterModel(RDA_L1, "rda-l1", "mixed l1-l2^2 regularized dual averaging");
 
 ERDA_L1::ERDA_L1(int class_num) : RDA(class_num), rou_(0.f) {
@@ -173,6 +200,17 @@ void ERDA_L1::EndTrain() {
   OnlineLinearModel::EndTrain();
 }
 
+void ERDA_L1::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  real_t t = real_t(cur_iter_num_ + 1e-20);
+  real_t eta = 1.f / (sqrtf(t) * sigma_);
+  real_t trunc_thresh = l1_.lambda() * t + sigma_ * rou_ * sqrtf(t);
+  for (int c = 0; c < this->clf_num_; ++c) {
+    weights[c] = -eta * expr::truncate(ut_[c], trunc_thresh);
+    weights[c][0] =
+        -bias_eta0_ * eta * expr::truncate(ut_[c][0], trunc_thresh);
+  }
+}
+
 void ERDA_L1::GetModelInfo(Json::Value& root) const {
   RDA::GetModelInfo(root);
   root["online"]["rou"] = this->rou_;
@@ -4,6 +4,9 @@
 *     Description         :     second order perceptron
 **********************************************************************************/
 #include "sol/model/olm/sop.h"
+
+#include <algorithm>
+
 #include "sol/loss/bool_loss.h"
 
 using namespace std;
@@ -52,12 +55,30 @@ void SOP::EndTrain() {
   OnlineLinearModel::EndTrain();
 }
 
+void SOP::FinalizeWeights(vector<math::Vector<real_t>>& weights) const {
+  for (int c = 0; c < this->clf_num_; ++c) weights[c] = v(c) / (a_ + X_);
+}
+
 label_t SOP::TrainPredict(const pario::DataPoint& dp, float* predicts) {
+  // the weights on features of x are v / (a + X + x^2), predict from v
+  // directly and materialize w only in EndTrain
   const auto& x = dp.data();
+  size_t feat_num = x.size();
   for (int c = 0; c < this->clf_num_; ++c) {
-    w(c) = v(c) / (a_ + X_ + L2(x));
+    const math::Vector<real_t>& vc = v(c);
+    real_t val = 0;
+    for (size_t i = 0; i < feat_num; ++i) {
+      index_t idx = x.index(i);
+      real_t xi = x.value(i);
+      val += vc[idx] / (a_ + X_[idx] + xi * xi) * xi;
+    }
+    predicts[c] = val + w(c)[0];
+  }
+  if (this->clf_num_ == 1) {
+    return loss::Loss::Sign(*predicts);
+  } else {
+    return label_t(max_element(predicts, predicts + this->clf_num_) - predicts);
   }
-  return OnlineLinearModel::TrainPredict(dp, predicts);
 }
 
 void SOP::Update(const pario::DataPoint& dp, const float*, float) {
@@ -92,7 +113,15 @@ void SOP::GetModelInfo(Json::Value& root) const {
 }
 
 void SOP::GetModelParam(std::ostream& os) const {
-  OnlineLinearModel::GetModelParam(os);
+  if (this->model_updated_) {
+    // weights are not materialized until EndTrain
+    for (int c = 0; c < this->clf_num_; ++c) {
+      os << "weight[" << c << "]:" << math::Vector<real_t>(v(c) / (a_ + X_))
+         << "\n";
+    }
+  } else {
+    OnlineLinearModel::GetModelParam(os);
+  }
   os << "X: " << this->X_ << "\n";
 
   for (int c = 0; c < this->clf_num_; ++c) {
@@ -112,6 +141,18 @@ int SOP::SetModelParam(std::istream& is) {
   return Status_OK;
 }
 
+void SOP::GetModelArrays(std::vector<ModelArray>& arrays) {
+  if (this->model_updated_) {
+    // weights are not used until EndTrain, materialize them for saving
+    for (int c = 0; c < this->clf_num_; ++c) w(c) = v(c) / (a_ + X_);
+  }
+  OnlineLinearModel::GetModelArrays(arrays);
+  arrays.push_back(ModelArray("X", &this->X_));
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(ModelArray("v[" + to_string(c) + "]", &v(c)));
+  }
+}
+
 RegisterModel(SOP, "sop", "second order perceptron");
 
 }  // namespace model
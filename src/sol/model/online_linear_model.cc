@@ -8,10 +8,21 @@
 #include "sol/model/online_linear_model.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <functional>
 #include <random>
 #include <limits>
+#include <memory>
+#include <vector>
 
+#include "sol/dist/coordinator.h"
 #include "sol/loss/hinge_loss.h"
+#include "sol/model/predictor.h"
+#include "sol/util/monitor.h"
+#include "sol/util/stats.h"
+#include "sol/util/thread_task.h"
 #include "sol/util/util.h"
 
 using namespace std;
@@ -21,10 +32,31 @@ using namespace sol::pario;
 namespace sol {
 namespace model {
 
+void DefaultBudgetFunction(void* user_context, long long iter_num,
+                           long long active_num, long long evict_num) {
+  cout << "budget: " << active_num << " active features, " << evict_num
+       << " evicted\n";
+}
+
 OnlineLinearModel::OnlineLinearModel(int class_num)
     : OnlineModel(class_num, "online_linear"),
+      budget_(0),
+      budget_window_(0),
       weights_(nullptr),
-      gradients_(nullptr) {
+      gradients_(nullptr),
+      thread_num_(1),
+      param_mixing_(false),
+      mix_interval_(0),
+      mini_batch_(false),
+      coordinator_(nullptr),
+      evict_num_(0),
+      budget_callback_(DefaultBudgetFunction),
+      budget_callback_user_context_(nullptr),
+      snapshot_interval_(0),
+      snapshot_ms_(0),
+      snapshot_iter_(0),
+      snapshot_time_(0) {
+  this->train_loops_[0] = this->train_loops_[1] = nullptr;
   this->weights_ = new Vector<real_t>[this->clf_num_];
   this->gradients_ = new real_t[this->clf_num_];
 
@@ -46,13 +78,46 @@ OnlineLinearModel::~OnlineLinearModel() {
   DeleteArray(this->gradients_);
 }
 
+void OnlineLinearModel::SetParameter(const std::string& name,
+                                     const std::string& value) {
+  if (name == "threads") {
+    this->thread_num_ = stoi(value);
+    Check(thread_num_ > 0);
+  } else if (name == "parallel") {
+    Check(value == "hogwild" || value == "mix");
+    this->param_mixing_ = value == "mix";
+  } else if (name == "mix_interval") {
+    this->mix_interval_ = stoul(value);
+  } else if (name == "mini_batch") {
+    this->mini_batch_ = value == "true" ? true : false;
+  } else if (name == "budget") {
+    this->budget_ = stoul(value);
+    this->require_reinit_ = true;
+  } else if (name == "budget_window") {
+    this->budget_window_ = stoi(value);
+    Check(budget_window_ >= 0);
+  } else if (name == "snapshot_interval") {
+    this->snapshot_interval_ = stoi(value);
+    Check(snapshot_interval_ >= 0);
+  } else if (name == "snapshot_ms") {
+    this->snapshot_ms_ = stoi(value);
+    Check(snapshot_ms_ >= 0);
+  } else {
+    OnlineModel::SetParameter(name, value);
+  }
+}
+
 label_t OnlineLinearModel::Iterate(const DataPoint& dp, float* predicts) {
   OnlineModel::Iterate(dp, predicts);
+  if (this->budget_ > 0) this->TrackFeatures(dp, this->cur_iter_num_);
   if (this->regularizer_ != nullptr) {
     this->online_regularizer()->BeginIterate(dp);
   }
 
+  Stats::Local* stats = Stats::local();
+  uint64_t start_time = stats != nullptr ? Stats::now_ns() : 0;
   label_t label = this->TrainPredict(dp, predicts);
+  if (stats != nullptr) start_time = stats->Lap(Stats::kPredictNs, start_time);
   // active learning
   if (this->active_smoothness_ > 0) {
     static random_device rd;
@@ -84,6 +149,7 @@ label_t OnlineLinearModel::Iterate(const DataPoint& dp, float* predicts) {
   }
   float loss = this->loss_->gradient(dp, predicts, label, this->gradients_,
                                      this->clf_num_);
+  if (stats != nullptr) start_time = stats->Lap(Stats::kLossNs, start_time);
   if (this->lazy_update_) {
     if (label != dp.label()) {
       ++this->update_num_;
@@ -93,6 +159,7 @@ label_t OnlineLinearModel::Iterate(const DataPoint& dp, float* predicts) {
     ++this->update_num_;
     this->Update(dp, predicts, loss);
   }
+  if (stats != nullptr) stats->Lap(Stats::kUpdateNs, start_time);
 
   if (this->regularizer_ != nullptr) {
     this->online_regularizer()->EndIterate(dp, this->cur_iter_num_);
@@ -126,6 +193,710 @@ label_t OnlineLinearModel::Predict(const pario::DataPoint& dp,
   }
 }
 
+float OnlineLinearModel::Train(DataIter& data_iter, long long* data_no,
+                               long long* iter_no, float* err_no,
+                               float* time_no, long long* update_no,
+                               int* table_size) {
+  this->snapshot_iter_ = this->cur_iter_num_;
+  this->snapshot_time_ = get_current_time();
+  float err_rate = OnlineModel::Train(data_iter, data_no, iter_no, err_no,
+                                      time_no, update_no, table_size);
+  // the model is not trained if failed to re-init
+  if (this->require_reinit_) return err_rate;
+  if (this->snapshot_interval_ > 0 || this->snapshot_ms_ > 0) {
+    this->PublishSnapshot();
+  }
+  if (this->iter_displayer_ != nullptr && this->budget_ > 0 &&
+      this->budget_callback_ != nullptr) {
+    this->budget_callback_(this->budget_callback_user_context_,
+                           this->cur_iter_num_, this->active_feature_num(),
+                           this->evict_num_);
+  }
+  return err_rate;
+}
+
+void OnlineLinearModel::ShowIterInfo(long long* data_no, long long* iter_no,
+                                     float* err_no, float* time_no,
+                                     long long* update_no) {
+  OnlineModel::ShowIterInfo(data_no, iter_no, err_no, time_no, update_no);
+  if (this->budget_ > 0 && this->budget_callback_ != nullptr) {
+    this->budget_callback_(this->budget_callback_user_context_,
+                           this->cur_iter_num_, this->active_feature_num(),
+                           this->evict_num_);
+  }
+}
+
+void OnlineLinearModel::EndMiniBatch() {
+  if (this->SnapshotDue(this->cur_iter_num_)) this->PublishSnapshot();
+  OnlineModel::EndMiniBatch();
+}
+
+bool OnlineLinearModel::SnapshotDue(int iter_num) const {
+  if (this->snapshot_interval_ > 0 &&
+      iter_num - this->snapshot_iter_ >= this->snapshot_interval_) {
+    return true;
+  }
+  return this->snapshot_ms_ > 0 &&
+         (get_current_time() - this->snapshot_time_) * 1000 >=
+             this->snapshot_ms_;
+}
+
+shared_ptr<const Predictor> OnlineLinearModel::snapshot() const {
+  return atomic_load(&this->snapshot_);
+}
+
+void OnlineLinearModel::CopyFinalizedWeights(
+    vector<Vector<real_t>>& weights) const {
+  weights.resize(this->clf_num_);
+  for (int c = 0; c < this->clf_num_; ++c) w(c).copyto(weights[c]);
+  this->FinalizeWeights(weights);
+  if (this->regularizer_ != nullptr) {
+    for (int c = 0; c < this->clf_num_; ++c) {
+      this->regularizer_->FinalizeRegularization(weights[c]);
+    }
+  }
+}
+
+void OnlineLinearModel::PublishSnapshot() {
+  vector<Vector<real_t>> weights;
+  this->CopyFinalizedWeights(weights);
+  shared_ptr<const Predictor> snapshot =
+      make_shared<Predictor>(*this, std::move(weights));
+  atomic_store(&this->snapshot_, snapshot);
+  this->snapshot_iter_ = this->cur_iter_num_;
+  this->snapshot_time_ = get_current_time();
+}
+
+/// \brief  shared status of the training threads in hogwild mode
+class OnlineLinearModel::HogwildContext {
+ public:
+  HogwildContext(DataIter& iter) : data_iter(iter), writing(false) {
+    reader_num = 0;
+  }
+
+  /// \brief  fetch the next mini-batch, note that the mini-batch queues are
+  // thread-safe and only the thread getting the end signal of a reader starts
+  // the next reader, so DataIter::Next can be called concurrently. It must not
+  // be serialized by a lock, as the reader may wait for the mini-batch
+  // returned by another thread.
+  MiniBatch* Next(MiniBatch* prev) { return this->data_iter.Next(prev); }
+
+  /// \brief  threads hold the shared access to the weights while training,
+  // and the exclusive access while expanding the dimension
+  void LockShared() {
+    this->dim_monitor.lock();
+    while (this->writing) this->dim_monitor.wait();
+    ++this->reader_num;
+    this->dim_monitor.unlock();
+  }
+  void UnlockShared() {
+    this->dim_monitor.lock();
+    if (--this->reader_num == 0) this->dim_monitor.notify_all();
+    this->dim_monitor.unlock();
+  }
+  void LockExclusive() {
+    this->dim_monitor.lock();
+    while (this->writing || this->reader_num > 0) this->dim_monitor.wait();
+    this->writing = true;
+    this->dim_monitor.unlock();
+  }
+  void UnlockExclusive() {
+    this->dim_monitor.lock();
+    this->writing = false;
+    this->dim_monitor.notify_all();
+    this->dim_monitor.unlock();
+  }
+
+ public:
+  DataIter& data_iter;
+
+  Monitor dim_monitor;
+  bool writing;
+  int reader_num;
+
+  std::atomic<int> iter_num;
+  std::atomic<size_t> data_num;
+  std::atomic<size_t> err_num;
+  std::atomic<size_t> update_num;
+
+  // iterate info display
+  Mutex show_mutex;
+  std::atomic<size_t> next_show_time;
+  long long* data_no;
+  long long* iter_no;
+  float* err_no;
+  float* time_no;
+  long long* update_no;
+};
+
+void OnlineLinearModel::IterateData(DataIter& data_iter, long long* data_no,
+                                    long long* iter_no, float* err_no,
+                                    float* time_no, long long* update_no) {
+  // whether the update only depends on the gradients of the loss
+  bool plain_update = this->regularizer_ == nullptr &&
+                      this->active_smoothness_ <= 0 &&
+                      this->cost_sensitive_learning_ == false;
+  if (this->coordinator_ != nullptr) {
+    if (this->DistIterate(data_iter, data_no, iter_no, err_no, time_no,
+                          update_no)) {
+      return;
+    }
+    // all the workers fail here as they train the same kind of model
+    fprintf(stderr,
+            "distributed training is not supported by the model or the "
+            "settings, train on the whole data locally\n");
+  }
+  if (this->thread_num_ <= 1) {
+    if (this->mini_batch_) {
+      if (this->support_mini_batch() && plain_update) {
+        return this->MiniBatchIterate(data_iter, data_no, iter_no, err_no,
+                                      time_no, update_no);
+      }
+      fprintf(stderr,
+              "mini-batch training is not supported by the model or the "
+              "settings, update on each instance\n");
+    }
+    TrainLoopFunc train_loop = this->train_loops_[this->lazy_update_ ? 1 : 0];
+    if (train_loop != nullptr && plain_update) {
+      return train_loop(this, data_iter, data_no, iter_no, err_no, time_no,
+                        update_no);
+    }
+    return OnlineModel::IterateData(data_iter, data_no, iter_no, err_no,
+                                    time_no, update_no);
+  }
+  if (this->param_mixing_ || this->support_hogwild() == false ||
+      plain_update == false || this->budget_ > 0) {
+    if (this->MixIterate(data_iter, data_no, iter_no, err_no, time_no,
+                         update_no)) {
+      return;
+    }
+    fprintf(stderr,
+            "multi-thread training is not supported by the model or the "
+            "settings, train with single thread\n");
+    return OnlineModel::IterateData(data_iter, data_no, iter_no, err_no,
+                                    time_no, update_no);
+  }
+
+  HogwildContext ctx(data_iter);
+  ctx.iter_num = this->cur_iter_num_;
+  ctx.data_num = this->cur_data_num_;
+  ctx.err_num = this->cur_err_num_;
+  ctx.update_num = this->update_num_;
+  ctx.next_show_time = this->iter_displayer_ == nullptr
+                           ? size_t(-1)
+                           : this->iter_displayer_->next_show_time();
+  ctx.data_no = data_no;
+  ctx.iter_no = iter_no;
+  ctx.err_no = err_no;
+  ctx.time_no = time_no;
+  ctx.update_no = update_no;
+
+  vector<unique_ptr<FunctionTask>> tasks;
+  for (int i = 0; i < this->thread_num_; ++i) {
+    tasks.emplace_back(
+        new FunctionTask([this, &ctx]() { this->HogwildIterate(&ctx); }));
+    tasks.back()->Start();
+  }
+  for (unique_ptr<FunctionTask>& task : tasks) {
+    task->Join();
+  }
+
+  this->cur_iter_num_ = ctx.iter_num;
+  this->cur_data_num_ = ctx.data_num;
+  this->cur_err_num_ = ctx.err_num;
+  this->update_num_ = ctx.update_num;
+}
+
+void OnlineLinearModel::HogwildIterate(HogwildContext* ctx) {
+  // thread-local predictions and gradients
+  vector<float> predicts(this->clf_num_);
+  vector<real_t> gradients(this->clf_num_);
+
+  MiniBatch* mb = nullptr;
+  while (1) {
+    mb = ctx->Next(mb);
+    if (mb == nullptr) break;
+
+    index_t dim = 0;
+    for (int i = 0; i < mb->size(); ++i) {
+      dim = (std::max)(dim, (*mb)[i].dim());
+    }
+    ctx->LockShared();
+    if (dim > this->dim_) {
+      ctx->UnlockShared();
+      ctx->LockExclusive();
+      this->ExpandDim(dim);
+      ctx->UnlockExclusive();
+      ctx->LockShared();
+    }
+
+    Stats::Local* stats = Stats::local();
+    bool preprocessed = this->IsPreProcessed(*mb);
+    for (int i = 0; i < mb->size(); ++i) {
+      DataPoint& x = (*mb)[i];
+      if (!preprocessed) this->PreProcess(x);
+      int t = ++ctx->iter_num;
+
+      uint64_t start_time = stats != nullptr ? Stats::now_ns() : 0;
+      label_t label = this->TrainPredict(x, predicts.data());
+      if (stats != nullptr) {
+        start_time = stats->Lap(Stats::kPredictNs, start_time);
+      }
+      float loss = this->loss_->gradient(x, predicts.data(), label,
+                                         gradients.data(), this->clf_num_);
+      if (stats != nullptr) start_time = stats->Lap(Stats::kLossNs, start_time);
+      if (this->lazy_update_ ? label != x.label() : loss > 0) {
+        ++ctx->update_num;
+        this->ApplyGradients(x, gradients.data(), t);
+      }
+      if (stats != nullptr) stats->Lap(Stats::kUpdateNs, start_time);
+      if (label != x.label()) ++ctx->err_num;
+
+      size_t data_num = ++ctx->data_num;
+      if (data_num >= ctx->next_show_time) {
+        ctx->show_mutex.lock();
+        if (data_num >= ctx->next_show_time) {
+          this->cur_iter_num_ = ctx->iter_num;
+          this->cur_data_num_ = data_num;
+          this->cur_err_num_ = ctx->err_num;
+          this->update_num_ = ctx->update_num;
+          this->ShowIterInfo(ctx->data_no, ctx->iter_no, ctx->err_no,
+                             ctx->time_no, ctx->update_no);
+          this->iter_displayer_->next();
+          ctx->next_show_time = this->iter_displayer_->next_show_time();
+        }
+        ctx->show_mutex.unlock();
+      }
+    }
+    ctx->UnlockShared();
+
+    // the other threads do not update the weights while publishing or
+    // checkpointing
+    if (this->SnapshotDue(ctx->iter_num) ||
+        this->CheckpointDue(ctx->data_num)) {
+      ctx->LockExclusive();
+      this->cur_iter_num_ = ctx->iter_num;
+      if (this->SnapshotDue(ctx->iter_num)) this->PublishSnapshot();
+      if (this->CheckpointDue(ctx->data_num)) {
+        this->cur_data_num_ = ctx->data_num;
+        this->cur_err_num_ = ctx->err_num;
+        this->update_num_ = ctx->update_num;
+        this->WriteCheckpoint();
+      }
+      ctx->UnlockExclusive();
+    }
+  }
+}
+
+bool OnlineLinearModel::MixIterate(DataIter& data_iter, long long* data_no,
+                                   long long* iter_no, float* err_no,
+                                   float* time_no, long long* update_no) {
+  // the random generator of active learning is shared, and the features
+  // tracked by the weight budget are not merged
+  if (this->active_smoothness_ > 0 || this->budget_ > 0) return false;
+
+  int replica_num = this->thread_num_;
+  vector<unique_ptr<Model>> replica_holder;
+  vector<Model*> replicas;
+  for (int i = 0; i < replica_num; ++i) {
+    Model* replica = this->Clone();
+    if (replica == nullptr) return false;
+    replica_holder.emplace_back(replica);
+    replicas.push_back(replica);
+  }
+
+  size_t next_show_time = size_t(-1);
+  if (this->iter_displayer_ != nullptr) {
+    next_show_time = this->iter_displayer_->next_show_time();
+  }
+  // number of instances of each replica between parameter mixings
+  size_t quota = size_t(-1);
+  if (this->mix_interval_ > 0) {
+    quota = (std::max)(this->mix_interval_ / replica_num, size_t(1));
+  }
+
+  // whether the replica gets the end of data
+  vector<char> data_ends(replica_num, 0);
+  // cpu time of the replicas in training
+  vector<double> train_times(replica_num, 0);
+  int mix_num = 0;
+  // wall time of training and of mixing
+  double start_time = get_current_time();
+  double mix_time = 0;
+  bool finished = false;
+  while (finished == false) {
+    vector<unique_ptr<FunctionTask>> tasks;
+    for (int i = 0; i < replica_num; ++i) {
+      OnlineLinearModel* replica = static_cast<OnlineLinearModel*>(replicas[i]);
+      tasks.emplace_back(new FunctionTask([&, i, replica]() {
+        double task_start_time = get_thread_cpu_time();
+        vector<float> predicts(replica->clf_num_);
+        size_t data_num = 0;
+        MiniBatch* mb = nullptr;
+        while (data_num < quota) {
+          mb = data_iter.Next(mb);
+          if (mb == nullptr) {
+            data_ends[i] = 1;
+            break;
+          }
+          // the data are tagged with the model replicated
+          bool preprocessed = this->IsPreProcessed(*mb);
+          for (int k = 0; k < mb->size(); ++k) {
+            DataPoint& x = (*mb)[k];
+            if (!preprocessed) replica->PreProcess(x);
+            if (replica->Iterate(x, predicts.data()) != x.label()) {
+              ++replica->cur_err_num_;
+            }
+          }
+          data_num += mb->size();
+        }
+        // other replicas may wait for the mini-batch
+        if (mb != nullptr) data_iter.Recycle(mb);
+        train_times[i] += get_thread_cpu_time() - task_start_time;
+      }));
+    }
+
+    // counters before this round
+    vector<size_t> data_nums, err_nums, update_nums;
+    vector<int> iter_nums;
+    for (Model* model : replicas) {
+      OnlineLinearModel* replica = static_cast<OnlineLinearModel*>(model);
+      data_nums.push_back(replica->cur_data_num_);
+      err_nums.push_back(replica->cur_err_num_);
+      update_nums.push_back(replica->update_num_);
+      iter_nums.push_back(replica->cur_iter_num_);
+    }
+
+    for (unique_ptr<FunctionTask>& task : tasks) task->Start();
+    for (unique_ptr<FunctionTask>& task : tasks) task->Join();
+
+    // the data is exhausted once a replica gets the end of data
+    for (int i = 0; i < replica_num; ++i) {
+      if (data_ends[i] != 0) finished = true;
+    }
+
+    // mix
+    double mix_start_time = get_current_time();
+    Check(this->Merge(replicas) == Status_OK);
+    ++mix_num;
+    for (int i = 0; i < replica_num; ++i) {
+      OnlineLinearModel* replica = static_cast<OnlineLinearModel*>(replicas[i]);
+      this->cur_data_num_ += replica->cur_data_num_ - data_nums[i];
+      this->cur_err_num_ += replica->cur_err_num_ - err_nums[i];
+      this->update_num_ += replica->update_num_ - update_nums[i];
+      this->cur_iter_num_ += replica->cur_iter_num_ - iter_nums[i];
+    }
+    this->EndMiniBatch();
+    if (finished == false) {
+      vector<Model*> master(1, this);
+      for (Model* model : replicas) {
+        OnlineLinearModel* replica = static_cast<OnlineLinearModel*>(model);
+        Check(replica->Merge(master) == Status_OK);
+        replica->cur_iter_num_ = this->cur_iter_num_;
+      }
+    }
+    mix_time += get_current_time() - mix_start_time;
+
+    if (this->cur_data_num_ >= next_show_time) {
+      this->ShowIterInfo(data_no, iter_no, err_no, time_no, update_no);
+      while (next_show_time <= this->cur_data_num_) {
+        this->iter_displayer_->next();
+        next_show_time = this->iter_displayer_->next_show_time();
+      }
+    }
+  }
+
+  // the ratio of the cpu time of the replicas to the wall time shows how busy
+  // the replicas are, i.e. the parallel utilization, the speedup over a single
+  // thread is measured by the model/*/train_threads benchmarks of sol_bench
+  if (this->iter_displayer_ != nullptr && this->iter_callback_ != nullptr) {
+    double train_time = 0;
+    for (double t : train_times) train_time += t;
+    double elapsed = get_current_time() - start_time;
+    cout << "parameter mixing: " << replica_num << " replicas, " << mix_num
+         << " mixings, wall time: " << elapsed
+         << " seconds (mixing: " << mix_time
+         << "), replica cpu time / wall time: "
+         << (elapsed > 0 ? train_time / elapsed : 1.0) << "\n";
+  }
+  return true;
+}
+
+void OnlineLinearModel::MiniBatchIterate(DataIter& data_iter,
+                                         long long* data_no, long long* iter_no,
+                                         float* err_no, float* time_no,
+                                         long long* update_no) {
+  size_t next_show_time = size_t(-1);
+  if (this->iter_displayer_ != nullptr) {
+    next_show_time = this->iter_displayer_->next_show_time();
+  }
+
+  // predictions, gradients of the instances on each class
+  vector<float> predicts;
+  vector<real_t> gradients;
+  vector<label_t> labels, predict_labels;
+  vector<float> losses;
+  // summed gradients of the mini-batch
+  vector<SVector<real_t>> batch_grads(this->clf_num_);
+  vector<real_t> bias_grads(this->clf_num_);
+  // position of each feature in the summed gradients plus one, zero if the
+  // feature is not in the mini-batch yet
+  Vector<index_t> grad_pos;
+  index_t pos_dim = 0;
+
+  MiniBatch* mb = nullptr;
+  while (1) {
+    mb = data_iter.Next(mb);
+    if (mb == nullptr) break;
+
+    // predict with the same weights
+    Stats::Local* stats = Stats::local();
+    uint64_t start_time = stats != nullptr ? Stats::now_ns() : 0;
+    int data_num = mb->size();
+    predicts.resize(data_num * this->clf_num_);
+    gradients.resize(data_num * this->clf_num_);
+    labels.resize(data_num);
+    predict_labels.resize(data_num);
+    losses.resize(data_num);
+    bool preprocessed = this->IsPreProcessed(*mb);
+    for (int i = 0; i < data_num; ++i) {
+      DataPoint& x = (*mb)[i];
+      if (!preprocessed) this->PreProcess(x);
+      this->ExpandDim(x.dim());
+      if (this->budget_ > 0) this->TrackFeatures(x, this->cur_iter_num_ + 1);
+      labels[i] = x.label();
+      predict_labels[i] =
+          this->TrainPredict(x, predicts.data() + i * this->clf_num_);
+    }
+    if (stats != nullptr) {
+      start_time = stats->Lap(Stats::kPredictNs, start_time);
+    }
+    this->loss_->BatchGradient(labels.data(), predicts.data(),
+                               predict_labels.data(), gradients.data(),
+                               losses.data(), data_num, this->clf_num_);
+    if (stats != nullptr) start_time = stats->Lap(Stats::kLossNs, start_time);
+
+    for (int i = 0; i < data_num; ++i) {
+      ++this->cur_iter_num_;
+      ++this->cur_data_num_;
+      if (this->lazy_update_ ? predict_labels[i] != labels[i]
+                             : losses[i] > 0) {
+        ++this->update_num_;
+      } else {
+        real_t* g = gradients.data() + i * this->clf_num_;
+        std::fill(g, g + this->clf_num_, real_t(0));
+      }
+      if (predict_labels[i] != labels[i]) ++this->cur_err_num_;
+
+      if (this->cur_data_num_ >= next_show_time) {
+        this->ShowIterInfo(data_no, iter_no, err_no, time_no, update_no);
+        this->iter_displayer_->next();
+        next_show_time = this->iter_displayer_->next_show_time();
+      }
+    }
+
+    // merge the sparse gradients
+    if (pos_dim < this->dim_) {
+      grad_pos.resize(this->dim_);
+      grad_pos.slice_op([](index_t& val) { val = 0; }, pos_dim);
+      pos_dim = this->dim_;
+    }
+    bool updated = false;
+    for (int c = 0; c < this->clf_num_; ++c) {
+      SVector<real_t>& grad = batch_grads[c];
+      grad.clear();
+      bias_grads[c] = 0;
+      for (int i = 0; i < data_num; ++i) {
+        real_t g = gradients[i * this->clf_num_ + c];
+        if (g == 0) continue;
+        bias_grads[c] += g;
+        const SVector<real_t>& x = (*mb)[i].data();
+        size_t feat_num = x.size();
+        for (size_t k = 0; k < feat_num; ++k) {
+          index_t& pos = grad_pos[x.index(k)];
+          if (pos == 0) {
+            grad.push_back(x.index(k), g * x.value(k));
+            pos = index_t(grad.size());
+          } else {
+            grad.value(pos - 1) += g * x.value(k);
+          }
+        }
+      }
+
+      size_t feat_num = grad.size();
+      for (size_t k = 0; k < feat_num; ++k) {
+        grad_pos[grad.index(k)] = 0;
+      }
+      if (bias_grads[c] != 0 || feat_num > 0) updated = true;
+    }
+    if (updated) {
+      this->ApplyBatchGradients(batch_grads.data(), bias_grads.data(),
+                                this->cur_iter_num_);
+    }
+    if (stats != nullptr) stats->Lap(Stats::kUpdateNs, start_time);
+    this->EndMiniBatch();
+  }
+}
+
+bool OnlineLinearModel::DistIterate(DataIter& data_iter, long long* data_no,
+                                    long long* iter_no, float* err_no,
+                                    float* time_no, long long* update_no) {
+  // workers would evict different features
+  if (this->budget_ > 0) return false;
+  // the snapshot is a replica so that it is expanded with the same initial
+  // states as the model
+  unique_ptr<Model> snapshot_holder(this->Clone());
+  if (snapshot_holder == nullptr) return false;
+  OnlineLinearModel* snapshot =
+      static_cast<OnlineLinearModel*>(snapshot_holder.get());
+  snapshot->cur_data_num_ = this->cur_data_num_;
+  snapshot->cur_err_num_ = this->cur_err_num_;
+  snapshot->update_num_ = this->update_num_;
+  snapshot->cur_iter_num_ = this->cur_iter_num_;
+
+  dist::Coordinator* coordinator = this->coordinator_;
+  size_t quota = coordinator->sync_interval();
+  if (quota == 0) quota = size_t(-1);
+  size_t next_show_time = size_t(-1);
+  if (this->iter_displayer_ != nullptr) {
+    next_show_time = this->iter_displayer_->next_show_time();
+  }
+
+  vector<float> predicts(this->clf_num_);
+  size_t batch_no = 0;
+  bool finished = false;
+  int sync_num = 0;
+  MiniBatch* mb = nullptr;
+  while (1) {
+    size_t data_num = 0;
+    while (finished == false && data_num < quota) {
+      mb = data_iter.Next(mb);
+      if (mb == nullptr) {
+        finished = true;
+        break;
+      }
+      if (coordinator->Owns(batch_no++) == false) continue;
+      bool preprocessed = this->IsPreProcessed(*mb);
+      for (int i = 0; i < mb->size(); ++i) {
+        DataPoint& x = (*mb)[i];
+        if (!preprocessed) this->PreProcess(x);
+        if (this->Iterate(x, predicts.data()) != x.label()) {
+          ++this->cur_err_num_;
+        }
+      }
+      data_num += mb->size();
+    }
+
+    // the finished workers keep synchronizing until all the workers finish
+    bool all_finished = this->SyncWorkers(snapshot, data_num > 0, finished);
+    ++sync_num;
+    this->EndMiniBatch();
+    if (this->cur_data_num_ >= next_show_time) {
+      this->ShowIterInfo(data_no, iter_no, err_no, time_no, update_no);
+      while (next_show_time <= this->cur_data_num_) {
+        this->iter_displayer_->next();
+        next_show_time = this->iter_displayer_->next_show_time();
+      }
+    }
+    if (all_finished) break;
+  }
+
+  if (this->iter_displayer_ != nullptr) {
+    cout << "distributed training: worker " << coordinator->rank() << " of "
+         << coordinator->worker_num() << ", " << sync_num
+         << " synchronizations\n";
+  }
+  return true;
+}
+
+bool OnlineLinearModel::SyncWorkers(OnlineLinearModel* snapshot, bool updated,
+                                    bool finished) {
+  dist::Coordinator* coordinator = this->coordinator_;
+  index_t dim = coordinator->MaxDim(this->dim_);
+  this->update_dim(dim);
+  snapshot->update_dim(dim);
+
+  vector<Vector<real_t>*> states, snapshots;
+  for (int c = 0; c < this->clf_num_; ++c) {
+    states.push_back(&w(c));
+    snapshots.push_back(&snapshot->w(c));
+  }
+  this->GetStateVectors(states);
+  snapshot->GetStateVectors(snapshots);
+  if (coordinator->AverageDeltas(states, snapshots, updated) > 0) {
+    this->EndMerge();
+    for (size_t k = 0; k < states.size(); ++k) {
+      states[k]->copyto(*snapshots[k]);
+    }
+  }
+
+  // sum the counters since the last synchronization
+  vector<double> counters;
+  counters.push_back(double(this->cur_data_num_ - snapshot->cur_data_num_));
+  counters.push_back(double(this->cur_err_num_ - snapshot->cur_err_num_));
+  counters.push_back(double(this->update_num_ - snapshot->update_num_));
+  counters.push_back(double(this->cur_iter_num_ - snapshot->cur_iter_num_));
+  bool all_finished = coordinator->SumProgress(counters, finished);
+  snapshot->cur_data_num_ += size_t(counters[0]);
+  snapshot->cur_err_num_ += size_t(counters[1]);
+  snapshot->update_num_ += size_t(counters[2]);
+  snapshot->cur_iter_num_ += int(counters[3]);
+  this->cur_data_num_ = snapshot->cur_data_num_;
+  this->cur_err_num_ = snapshot->cur_err_num_;
+  this->update_num_ = snapshot->update_num_;
+  this->cur_iter_num_ = snapshot->cur_iter_num_;
+  return all_finished;
+}
+
+int OnlineLinearModel::Merge(const std::vector<Model*>& replicas) {
+  if (replicas.size() == 0) return Status_Invalid_Argument;
+  vector<OnlineLinearModel*> models;
+  for (Model* model : replicas) {
+    OnlineLinearModel* replica = dynamic_cast<OnlineLinearModel*>(model);
+    if (replica == nullptr || replica == this ||
+        replica->name() != this->name() ||
+        replica->clf_num() != this->clf_num()) {
+      return Status_Invalid_Argument;
+    }
+    models.push_back(replica);
+  }
+
+  // expand to the same dimension
+  index_t dim = this->dim_;
+  for (OnlineLinearModel* replica : models) {
+    dim = (std::max)(dim, replica->dim_);
+  }
+  this->ExpandDim(dim);
+  for (OnlineLinearModel* replica : models) replica->ExpandDim(dim);
+
+  vector<Vector<real_t>*> states;
+  for (int c = 0; c < this->clf_num_; ++c) states.push_back(&w(c));
+  if (this->GetStateVectors(states) == false) return Status_Invalid_Argument;
+  vector<vector<Vector<real_t>*>> replica_states(models.size());
+  for (size_t i = 0; i < models.size(); ++i) {
+    OnlineLinearModel* replica = models[i];
+    for (int c = 0; c < this->clf_num_; ++c) {
+      replica_states[i].push_back(&replica->w(c));
+    }
+    if (replica->GetStateVectors(replica_states[i]) == false ||
+        replica_states[i].size() != states.size()) {
+      return Status_Invalid_Argument;
+    }
+  }
+
+  real_t replica_num = real_t(models.size());
+  for (size_t k = 0; k < states.size(); ++k) {
+    Vector<real_t>& state = *states[k];
+    replica_states[0][k]->copyto(state);
+    for (size_t i = 1; i < models.size(); ++i) {
+      state += *replica_states[i][k];
+    }
+    if (models.size() > 1) state /= replica_num;
+  }
+  this->EndMerge();
+  return Status_OK;
+}
+
 void OnlineLinearModel::update_dim(index_t dim) {
   if (dim > this->dim_) {
     for (int i = 0; i < this->clf_num_; ++i) {
@@ -137,6 +908,104 @@ void OnlineLinearModel::update_dim(index_t dim) {
   }
 }
 
+size_t OnlineLinearModel::active_feature_num() const {
+  size_t active_num = 0;
+  for (index_t i = 1; i < this->dim_; ++i) {
+    for (int c = 0; c < this->clf_num_; ++c) {
+      if (w(c)[i] != 0) {
+        ++active_num;
+        break;
+      }
+    }
+  }
+  return active_num;
+}
+
+void OnlineLinearModel::EvictFeature(index_t index) {
+  for (int c = 0; c < this->clf_num_; ++c) w(c)[index] = 0;
+}
+
+void OnlineLinearModel::InitBudget() {
+  this->tracked_.clear();
+  this->last_seen_.resize(this->dim_);
+  this->last_seen_ = 0;
+  int t = (std::max)(this->cur_iter_num_, 1);
+  for (index_t i = 1; i < this->dim_; ++i) {
+    for (int c = 0; c < this->clf_num_; ++c) {
+      if (w(c)[i] != 0) {
+        this->last_seen_[i] = t;
+        this->tracked_.push_back(i);
+        break;
+      }
+    }
+  }
+}
+
+void OnlineLinearModel::TrackFeatures(const DataPoint& dp, int t) {
+  index_t d = index_t(this->last_seen_.dim());
+  if (d < this->dim_) {
+    this->last_seen_.resize(this->dim_);
+    this->last_seen_.slice_op([](int& val) { val = 0; }, d);
+  }
+  size_t feat_num = dp.size();
+  for (size_t k = 0; k < feat_num; ++k) {
+    index_t index = dp.index(k);
+    int& last_seen = this->last_seen_[index];
+    if (last_seen == 0) this->tracked_.push_back(index);
+    last_seen = t;
+  }
+  if (this->tracked_.size() > this->budget_) this->EvictFeatures(t);
+}
+
+void OnlineLinearModel::EvictFeatures(int t) {
+  // eviction order: stale features by the time seen last, then the other
+  // features by the largest absolute weight over the classes
+  typedef pair<pair<int, real_t>, index_t> Candidate;
+  vector<Candidate> candidates;
+  vector<index_t> reserved;
+  for (index_t index : this->tracked_) {
+    int& last_seen = this->last_seen_[index];
+    // features of the current instance are about to be updated, evicting
+    // them would only make them non-zero again without being tracked
+    if (last_seen == t) {
+      reserved.push_back(index);
+      continue;
+    }
+    real_t abs_w = 0;
+    for (int c = 0; c < this->clf_num_; ++c) {
+      abs_w = (std::max)(abs_w, std::abs(w(c)[index]));
+    }
+    if (abs_w == 0) {
+      last_seen = 0;
+    } else if (this->budget_window_ > 0 &&
+               t - last_seen > this->budget_window_) {
+      candidates.push_back(Candidate(make_pair(0, real_t(last_seen)), index));
+    } else {
+      candidates.push_back(Candidate(make_pair(1, abs_w), index));
+    }
+  }
+
+  size_t keep_num = this->budget_ - this->budget_ / 10;
+  size_t total_num = candidates.size() + reserved.size();
+  size_t evict_num = total_num > keep_num ? total_num - keep_num : 0;
+  if (evict_num > candidates.size()) evict_num = candidates.size();
+  if (evict_num < candidates.size()) {
+    nth_element(candidates.begin(), candidates.begin() + evict_num,
+                candidates.end());
+  }
+  for (size_t k = 0; k < evict_num; ++k) {
+    index_t index = candidates[k].second;
+    this->EvictFeature(index);
+    this->last_seen_[index] = 0;
+  }
+  this->evict_num_ += evict_num;
+
+  this->tracked_.swap(reserved);
+  for (size_t k = evict_num; k < candidates.size(); ++k) {
+    this->tracked_.push_back(candidates[k].second);
+  }
+}
+
 float OnlineLinearModel::model_sparsity() {
   if (this->model_updated_) this->EndTrain();
   size_t non_zero_num = 0;
@@ -149,6 +1018,33 @@ float OnlineLinearModel::model_sparsity() {
   return 1.f - float(non_zero_num / double(this->clf_num_ * (this->dim_ - 1)));
 }
 
+void OnlineLinearModel::MemoryUsage(vector<MemoryBlock>& blocks) const {
+  OnlineModel::MemoryUsage(blocks);
+  if (this->last_seen_.size() > 0) {
+    blocks.push_back(VectorMemory("last_seen", this->last_seen_));
+  }
+  if (this->tracked_.capacity() > 0) {
+    MemoryBlock block = {"tracked", this->tracked_.size() * sizeof(index_t),
+                         this->tracked_.capacity() * sizeof(index_t)};
+    blocks.push_back(block);
+  }
+  shared_ptr<const Predictor> snapshot = this->snapshot();
+  if (snapshot != nullptr) {
+    for (int c = 0; c < snapshot->clf_num(); ++c) {
+      blocks.push_back(
+          VectorMemory("snapshot[" + to_string(c) + "]", snapshot->w(c)));
+    }
+  }
+}
+
+void OnlineLinearModel::GetModelInfo(Json::Value& root) const {
+  OnlineModel::GetModelInfo(root);
+  if (this->budget_ > 0) {
+    root["online"]["budget"] = Json::UInt64(this->budget_);
+    root["online"]["budget_window"] = this->budget_window_;
+  }
+}
+
 void OnlineLinearModel::GetModelParam(std::ostream& os) const {
   for (int c = 0; c < this->clf_num_; ++c) {
     os << "weight[" << c << "]:" << w(c) << "\n";
@@ -168,5 +1064,11 @@ int OnlineLinearModel::SetModelParam(std::istream& is) {
   return Status_OK;
 }
 
+void OnlineLinearModel::GetModelArrays(std::vector<ModelArray>& arrays) {
+  for (int c = 0; c < this->clf_num_; ++c) {
+    arrays.push_back(ModelArray("weight[" + to_string(c) + "]", &w(c)));
+  }
+}
+
 }  // namespace model
 }  // namespace sol
@@ -7,7 +7,10 @@
 **********************************************************************************/
 
 #include "sol/model/online_model.h"
+#include "sol/util/monitor.h"
+#include "sol/util/stats.h"
 #include "sol/util/str_util.h"
+#include "sol/util/thread_task.h"
 #include "sol/util/util.h"
 
 #include <sstream>
@@ -50,6 +53,100 @@ class StepIterDisplayer : public OnlineModel::IterDisplayer {
   size_t step_;
 };
 
+/// \brief  background thread writing the checkpoints. The training thread
+// copies the states into the buffer only when the writer is idle, so that the
+// training is never blocked by the writing.
+class OnlineModel::CheckpointWriter : public ThreadTask {
+ public:
+  CheckpointWriter() : busy_(false), exit_(false) { this->Start(); }
+
+  virtual ~CheckpointWriter() {
+    this->monitor_.lock();
+    this->exit_ = true;
+    this->monitor_.notify_all();
+    this->monitor_.unlock();
+    this->Join();
+  }
+
+  /// \brief  whether the last checkpoint is still being written
+  bool busy() {
+    this->monitor_.lock();
+    bool busy = this->busy_;
+    this->monitor_.unlock();
+    return busy;
+  }
+
+  /// \brief  wait until the last checkpoint is written
+  void Wait() {
+    this->monitor_.lock();
+    while (this->busy_) this->monitor_.wait();
+    this->monitor_.unlock();
+  }
+
+  /// \brief  copy the states into the buffer, the writer should be idle
+  ///
+  /// \param root json header of the checkpoint
+  /// \param arrays arrays of the states
+  void Copy(const Json::Value& root, const std::vector<ModelArray>& arrays) {
+    this->root_ = root;
+    this->buffers_.resize(arrays.size());
+    this->arrays_.resize(arrays.size());
+    for (size_t i = 0; i < arrays.size(); ++i) {
+      arrays[i].second->copyto(this->buffers_[i]);
+      this->arrays_[i] = ModelArray(arrays[i].first, &this->buffers_[i]);
+    }
+  }
+
+  /// \brief  write the copied states to path in the background
+  void Submit(const std::string& path) {
+    this->monitor_.lock();
+    this->path_ = path;
+    this->busy_ = true;
+    this->monitor_.notify_all();
+    this->monitor_.unlock();
+  }
+
+ protected:
+  virtual void run() {
+    while (1) {
+      this->monitor_.lock();
+      while (this->busy_ == false && this->exit_ == false) {
+        this->monitor_.wait();
+      }
+      // the pending checkpoint is written before exit
+      bool busy = this->busy_;
+      this->monitor_.unlock();
+      if (busy == false) break;
+
+      // the last checkpoint is kept until the new one is complete
+      string tmp_path = this->path_ + ".tmp";
+      int ret = Model::WriteBinary(tmp_path, this->root_, this->arrays_);
+      if (ret == Status_OK &&
+          !replace_file(tmp_path.c_str(), this->path_.c_str())) {
+        ret = Status_IO_Error;
+      }
+      if (ret != Status_OK) {
+        fprintf(stderr, "write checkpoint %s failed\n", this->path_.c_str());
+      }
+
+      this->monitor_.lock();
+      this->busy_ = false;
+      this->monitor_.notify_all();
+      this->monitor_.unlock();
+    }
+  }
+
+ protected:
+  Monitor monitor_;
+  bool busy_;
+  bool exit_;
+
+  string path_;
+  Json::Value root_;
+  vector<math::Vector<real_t>> buffers_;
+  vector<ModelArray> arrays_;
+};
+
 void DefaultIterateFunction(void* user_context, long long data_num,
                             long long iter_num, long long update_num,
                             double err_rate) {
@@ -62,6 +159,11 @@ OnlineModel::OnlineModel(int class_num, const std::string& type)
       bias_eta0_(0),
       dim_(1),
       eta_(1.f),
+      checkpoint_interval_(0),
+      checkpoint_sec_(0),
+      checkpoint_data_num_(0),
+      checkpoint_time_(0),
+      train_iter_(nullptr),
       iter_displayer_(nullptr),
       iter_callback_(nullptr) {
   this->cur_data_num_ = 0;
@@ -76,6 +178,9 @@ OnlineModel::OnlineModel(int class_num, const std::string& type)
   this->active_smoothness_ = 0;
   // cost sensitive learning
   this->cost_sensitive_learning_ = false;
+  this->resume_pos_.reader = -1;
+  this->resume_pos_.pass = 0;
+  this->resume_pos_.offset = -1;
 }
 
 OnlineModel::~OnlineModel() { DeletePointer(this->iter_displayer_); }
@@ -107,6 +212,14 @@ void OnlineModel::SetParameter(const std::string& name,
     Check(cost_margin_ > 0);
     this->cost_sensitive_learning_ = true;
     this->require_reinit_ = true;
+  } else if (name == "checkpoint") {
+    this->checkpoint_path_ = value;
+  } else if (name == "checkpoint_interval") {
+    this->checkpoint_interval_ = stoi(value);
+    Check(checkpoint_interval_ >= 0);
+  } else if (name == "checkpoint_sec") {
+    this->checkpoint_sec_ = stoi(value);
+    Check(checkpoint_sec_ >= 0);
   } else if (name == "exp_show") {
     DeletePointer(this->iter_displayer_);
     this->iter_displayer_ = new ExpIterDisplayer(stoi(value));
@@ -127,6 +240,14 @@ void OnlineModel::BeginTrain() {
           "allowed in cost sensitive learning");
     }
   }
+  if (!this->checkpoint_path_.empty()) {
+    vector<ModelArray> arrays;
+    this->GetModelArrays(arrays);
+    if (arrays.empty()) {
+      throw invalid_argument("checkpointing is not supported by " +
+                             this->name());
+    }
+  }
 
   Model::BeginTrain();
 }
@@ -143,56 +264,32 @@ float OnlineModel::Train(DataIter& data_iter, long long* data_no,long long* iter
     }
   }
 
-  size_t next_show_time = size_t(-1);
   this->table_index = 0;//modified by Jing
   this->start_time = sol::get_current_time();//modified by Jing
   if (this->iter_displayer_ != nullptr) {
-    next_show_time = this->iter_displayer_->next_show_time();
     if (this->iter_callback_ == DefaultIterateFunction &&
         this->cur_data_num_ == 0) {
       cout << "Training Process....\nData No.\tIterate No.\tError Rate\tUpdate "
               "No.\n";
     }
+    // the data trained before, e.g. restored from a checkpoint, are not
+    // shown again
+    while (this->iter_displayer_->next_show_time() <= this->cur_data_num_) {
+      this->iter_displayer_->next();
+    }
   }
 
-  float* predicts = new float[this->clf_num()];
-  MiniBatch* mb = nullptr;
-  while (1) {
-    mb = data_iter.Next(mb);
-    if (mb == nullptr) break;
-    // data_num += mb->size();
-    for (int i = 0; i < mb->size(); ++i) {
-      DataPoint& x = (*mb)[i];
-      this->PreProcess(x);
-      // predict
-      if (this->Iterate(x, predicts) != x.label()) ++this->cur_err_num_;
-
-      if (this->cur_data_num_ >= next_show_time) {
-        float err_rate = float(this->cur_err_num_) / this->cur_data_num_;
-        if (this->iter_callback_ != nullptr) {
-          this->iter_callback_(this->iter_callback_user_context_,
-                               this->cur_data_num_, this->cur_iter_num(),
-                               this->update_num(), err_rate);
-        }
-
-
-		if (data_no != NULL)//modified by Jing
-		{
-			data_no[table_index] = cur_data_num_;
-			iter_no[table_index] = cur_iter_num();
-			err_no[table_index] = err_rate;
-			
-			update_no[table_index] =  update_num();
-			time_no[table_index] = float(sol::get_current_time()-this->start_time);
-		}
-		table_index++;
-
-
-        this->iter_displayer_->next();
-        next_show_time = this->iter_displayer_->next_show_time();
-      }
-    }
+  this->train_iter_ = &data_iter;
+  this->checkpoint_data_num_ = this->cur_data_num_;
+  this->checkpoint_time_ = get_current_time();
+  this->IterateData(data_iter, data_no, iter_no, err_no, time_no, update_no);
+  // the final checkpoint is complete when the training returns
+  if (!this->checkpoint_path_.empty()) {
+    if (this->checkpoint_writer_) this->checkpoint_writer_->Wait();
+    this->WriteCheckpoint();
+    this->checkpoint_writer_->Wait();
   }
+  this->train_iter_ = nullptr;
 
   float err_rate = float(this->cur_err_num_) / this->cur_data_num_;
   if (this->iter_displayer_ != nullptr) {
@@ -214,19 +311,151 @@ float OnlineModel::Train(DataIter& data_iter, long long* data_no,long long* iter
 	  *table_size = table_index;
   }
 
-  delete[] predicts;
   this->model_updated_ = true;
 
   return err_rate;
 }
 
+void OnlineModel::IterateData(DataIter& data_iter, long long* data_no,
+                              long long* iter_no, float* err_no,
+                              float* time_no, long long* update_no) {
+  size_t next_show_time = size_t(-1);
+  if (this->iter_displayer_ != nullptr) {
+    next_show_time = this->iter_displayer_->next_show_time();
+  }
+
+  float* predicts = new float[this->clf_num()];
+  MiniBatch* mb = nullptr;
+  while (1) {
+    mb = data_iter.Next(mb);
+    if (mb == nullptr) break;
+    // data_num += mb->size();
+    bool preprocessed = this->IsPreProcessed(*mb);
+    for (int i = 0; i < mb->size(); ++i) {
+      DataPoint& x = (*mb)[i];
+      if (!preprocessed) this->PreProcess(x);
+      // predict
+      if (this->Iterate(x, predicts) != x.label()) ++this->cur_err_num_;
+
+      if (this->cur_data_num_ >= next_show_time) {
+        this->ShowIterInfo(data_no, iter_no, err_no, time_no, update_no);
+        this->iter_displayer_->next();
+        next_show_time = this->iter_displayer_->next_show_time();
+      }
+    }
+    this->EndMiniBatch();
+  }
+  delete[] predicts;
+}
+
+void OnlineModel::EndMiniBatch() {
+  if (this->CheckpointDue(this->cur_data_num_)) this->WriteCheckpoint();
+}
+
+bool OnlineModel::CheckpointDue(size_t data_num) const {
+  if (this->checkpoint_path_.empty()) return false;
+  if (this->checkpoint_interval_ > 0 &&
+      data_num - this->checkpoint_data_num_ >=
+          size_t(this->checkpoint_interval_)) {
+    return true;
+  }
+  return this->checkpoint_sec_ > 0 &&
+         get_current_time() - this->checkpoint_time_ >= this->checkpoint_sec_;
+}
+
+bool OnlineModel::WriteCheckpoint() {
+  if (!this->checkpoint_writer_) {
+    this->checkpoint_writer_.reset(new CheckpointWriter);
+  }
+  CheckpointWriter* writer = this->checkpoint_writer_.get();
+  if (writer->busy()) return false;
+
+  Json::Value root;
+  this->GetModelInfo(root["info"]);
+  Json::Value& state = root["checkpoint"];
+  state["data_num"] = Json::UInt64(this->cur_data_num_);
+  state["err_num"] = Json::UInt64(this->cur_err_num_);
+  state["update_num"] = Json::UInt64(this->update_num_);
+  // the learning rate of the last update, in full precision as the json
+  // writer keeps 6 significant digits
+  ostringstream eta;
+  eta << setprecision(9) << this->eta_;
+  state["eta"] = eta.str();
+  state["interval"] = this->checkpoint_interval_;
+  state["sec"] = this->checkpoint_sec_;
+  DataPos pos;
+  if (this->train_iter_ != nullptr && this->train_iter_->position(pos)) {
+    state["data"]["reader"] = pos.reader;
+    state["data"]["pass"] = pos.pass;
+    state["data"]["offset"] = Json::Int64(pos.offset);
+  }
+  vector<ModelArray> arrays;
+  this->GetModelArrays(arrays);
+  this->GetCheckpointArrays(arrays);
+  writer->Copy(root, arrays);
+  writer->Submit(this->checkpoint_path_);
+
+  this->checkpoint_data_num_ = this->cur_data_num_;
+  this->checkpoint_time_ = get_current_time();
+  return true;
+}
+
+void OnlineModel::ShowIterInfo(long long* data_no, long long* iter_no,
+                               float* err_no, float* time_no,
+                               long long* update_no) {
+  float err_rate = float(this->cur_err_num_) / this->cur_data_num_;
+  if (this->iter_callback_ != nullptr) {
+    this->iter_callback_(this->iter_callback_user_context_,
+                         this->cur_data_num_, this->cur_iter_num(),
+                         this->update_num(), err_rate);
+  }
+
+  if (data_no != NULL)  // modified by Jing
+  {
+    data_no[table_index] = cur_data_num_;
+    iter_no[table_index] = cur_iter_num();
+    err_no[table_index] = err_rate;
+    update_no[table_index] = update_num();
+    time_no[table_index] = float(sol::get_current_time() - this->start_time);
+  }
+  table_index++;
+}
+
 label_t OnlineModel::Iterate(const pario::DataPoint& x, float* predict) {
-  this->update_dim(x.dim());
+  this->ExpandDim(x.dim());
   ++this->cur_iter_num_;
   ++this->cur_data_num_;
   return 0;
 }
 
+void OnlineModel::ExpandDim(index_t dim) {
+  if (dim <= this->dim_) return;
+  Stats::Local* stats = Stats::local();
+  if (stats == nullptr) {
+    this->update_dim(dim);
+    return;
+  }
+
+  // the arrays are reallocated if the capacities change
+  vector<ModelArray> arrays;
+  this->GetModelArrays(arrays);
+  this->GetCheckpointArrays(arrays);
+  vector<size_t> capacities(arrays.size());
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    const math::Vector<real_t>* arr = arrays[i].second;
+    capacities[i] = arr->size() > 0 ? arr->capacity() : 0;
+  }
+  this->update_dim(dim);
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    const math::Vector<real_t>* arr = arrays[i].second;
+    size_t capacity = arr->size() > 0 ? arr->capacity() : 0;
+    if (capacity != capacities[i]) {
+      stats->Add(Stats::kReallocNum, 1);
+      stats->Add(Stats::kReallocBytes, capacity * sizeof(real_t));
+    }
+  }
+}
+
 void OnlineModel::GetModelInfo(Json::Value& root) const {
   Model::GetModelInfo(root);
   root["online"]["bias_eta"] = this->bias_eta0_;
@@ -261,6 +490,22 @@ int OnlineModel::SetModelInfo(const Json::Value& root) {
   return Status_OK;
 }
 
+int OnlineModel::SetCheckpointInfo(const Json::Value& root) {
+  this->cur_data_num_ = size_t(root["data_num"].asUInt64());
+  this->cur_err_num_ = size_t(root["err_num"].asUInt64());
+  this->update_num_ = size_t(root["update_num"].asUInt64());
+  if (root.isMember("eta")) this->eta_ = stof(root["eta"].asString());
+  this->checkpoint_interval_ = root.get("interval", 0).asInt();
+  this->checkpoint_sec_ = root.get("sec", 0).asInt();
+  const Json::Value& data = root["data"];
+  if (!data.isNull()) {
+    this->resume_pos_.reader = data["reader"].asInt();
+    this->resume_pos_.pass = data["pass"].asInt();
+    this->resume_pos_.offset = data["offset"].asInt64();
+  }
+  return Status_OK;
+}
+
 void OnlineModel::set_initial_t(int initial_t) {
   Check(initial_t >= 0);
   this->initial_t_ = initial_t;
@@ -0,0 +1,315 @@
+/*********************************************************************************
+*     File Name           :     predictor.cc
+*     Created By          :     yuewu
+*     Description         :     read-only predictor of linear models
+**********************************************************************************/
+#include "sol/model/predictor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+#include "sol/loss/loss.h"
+#include "sol/util/monitor.h"
+#include "sol/util/thread_task.h"
+
+using namespace std;
+using namespace sol::math::expr;
+using namespace sol::pario;
+
+namespace sol {
+namespace model {
+
+/// \brief  features of a row of a CSR matrix
+template <typename IType, typename DType>
+struct CsrRow {
+  const IType* indices;
+  const DType* values;
+  size_t feat_num;
+
+  inline size_t size() const { return this->feat_num; }
+  inline index_t index(size_t i) const { return index_t(this->indices[i] + 1); }
+  inline real_t feature(size_t i) const { return real_t(this->values[i]); }
+};
+
+/// \brief  features of a row of a dense matrix
+template <typename DType>
+struct DenseRow {
+  const DType* values;
+  size_t feat_num;
+
+  inline size_t size() const { return this->feat_num; }
+  inline index_t index(size_t i) const { return index_t(i + 1); }
+  inline real_t feature(size_t i) const { return real_t(this->values[i]); }
+};
+
+Predictor::Predictor(OnlineLinearModel& model, bool copy_weights)
+    : class_num_(model.class_num()),
+      clf_num_(model.clf_num()),
+      norm_type_(model.norm_type()),
+      weights_(model.clf_num()),
+      feature_cross_(model.feature_cross()),
+      source_(static_cast<const Model*>(&model)) {
+  if (model.model_updated()) model.EndTrain();
+  for (int c = 0; c < this->clf_num_; ++c) {
+    if (copy_weights) {
+      model.w(c).copyto(this->weights_[c]);
+    } else {
+      this->weights_[c] = model.w(c);
+    }
+  }
+  this->CopySelFeatFlags(model);
+}
+
+Predictor::Predictor(const OnlineLinearModel& model,
+                     vector<math::Vector<real_t>>&& weights)
+    : class_num_(model.class_num()),
+      clf_num_(model.clf_num()),
+      norm_type_(model.norm_type()),
+      weights_(std::move(weights)),
+      feature_cross_(model.feature_cross()),
+      source_(static_cast<const Model*>(&model)) {
+  this->CopySelFeatFlags(model);
+}
+
+void Predictor::CopySelFeatFlags(const OnlineLinearModel& model) {
+  const math::Vector<char>& sel_feat_flags = model.sel_feat_flags();
+  if (sel_feat_flags.size() > 0) {
+    this->sel_feat_flags_.resize(sel_feat_flags.size());
+    memcpy(this->sel_feat_flags_.data(), sel_feat_flags.data(),
+           sel_feat_flags.size());
+  }
+}
+
+label_t Predictor::Predict(const DataPoint& x, float* predicts) const {
+  return this->PredictFeatures(x, predicts);
+}
+
+template <typename Features>
+label_t Predictor::PredictFeatures(const Features& x, float* predicts) const {
+  size_t feat_num = x.size();
+  size_t flag_num = this->sel_feat_flags_.size();
+  const char* flags = flag_num == 0 ? nullptr : this->sel_feat_flags_.data();
+  auto selected = [flag_num, flags](index_t index) {
+    return flag_num == 0 || (index < flag_num && flags[index] != 0);
+  };
+
+  // the crossed features are computed on the fly instead of expanding the
+  // data as Model::PreProcess
+  SelectedFeatures<Features, decltype(selected)> selected_x = {x, selected};
+  bool crossed = !this->feature_cross_.empty();
+
+  real_t norm = 1;
+  if (this->norm_type_ != op::OpType::kNone) {
+    norm = 0;
+    bool l1 = this->norm_type_ == op::OpType::kL1;
+    for (size_t i = 0; i < feat_num; ++i) {
+      if (!selected(x.index(i))) continue;
+      real_t val = x.feature(i);
+      norm += l1 ? (val > 0 ? val : -val) : val * val;
+    }
+    if (crossed) {
+      this->feature_cross_.ForEach(
+          selected_x, [l1, &norm](index_t, real_t val) {
+            norm += l1 ? (val > 0 ? val : -val) : val * val;
+          });
+    }
+    if (this->norm_type_ == op::OpType::kL2) norm = sqrt(norm);
+  }
+
+  // the same as dotmul, features beyond the dimension are ignored
+  size_t dim = this->weights_[0].dim();
+  for (int c = 0; c < this->clf_num_; ++c) {
+    const real_t* w = this->weights_[c].data();
+    real_t val = 0;
+    for (size_t i = 0; i < feat_num; ++i) {
+      index_t index = x.index(i);
+      if (index >= dim || !selected(index)) continue;
+      real_t feat = x.feature(i);
+      if (this->norm_type_ != op::OpType::kNone) feat /= norm;
+      val += w[index] * feat;
+    }
+    if (crossed) {
+      this->feature_cross_.ForEach(
+          selected_x, [this, w, dim, norm, &val](index_t index, real_t feat) {
+            if (index >= dim) return;
+            if (this->norm_type_ != op::OpType::kNone) feat /= norm;
+            val += w[index] * feat;
+          });
+    }
+    predicts[c] = val + w[0];
+  }
+  return this->PredictLabel(predicts);
+}
+
+label_t Predictor::PredictPreProcessed(const DataPoint& x,
+                                       float* predicts) const {
+  size_t feat_num = x.size();
+  size_t dim = this->weights_[0].dim();
+  for (int c = 0; c < this->clf_num_; ++c) {
+    const real_t* w = this->weights_[c].data();
+    real_t val = 0;
+    for (size_t i = 0; i < feat_num; ++i) {
+      index_t index = x.index(i);
+      if (index < dim) val += w[index] * x.feature(i);
+    }
+    predicts[c] = val + w[0];
+  }
+  return this->PredictLabel(predicts);
+}
+
+void Predictor::PredictBatch(const MiniBatch& mb, float* scores,
+                             label_t* labels) const {
+  bool preprocessed = mb.preprocessor == this->source_;
+  for (int i = 0; i < mb.size(); ++i) {
+    float* predicts = scores + i * this->clf_num_;
+    label_t label = preprocessed ? this->PredictPreProcessed(mb[i], predicts)
+                                 : this->Predict(mb[i], predicts);
+    if (labels != nullptr) labels[i] = label;
+  }
+}
+
+template <typename IType, typename DType>
+void Predictor::PredictCsr(const IType* indptr, const IType* indices,
+                           const DType* data, size_t row_num, float* scores,
+                           label_t* labels) const {
+  // indptr may not start from zero, as in CsrMatrixReader
+  for (size_t i = 0; i < row_num; ++i) {
+    size_t offset = size_t(indptr[i] - indptr[0]);
+    CsrRow<IType, DType> row = {indices + offset, data + offset,
+                                size_t(indptr[i + 1] - indptr[i])};
+    label_t label = this->PredictFeatures(row, scores + i * this->clf_num_);
+    if (labels != nullptr) labels[i] = label;
+  }
+}
+
+template <typename DType>
+void Predictor::PredictDense(const DType* X, size_t row_num, size_t col_num,
+                             size_t row_stride, float* scores,
+                             label_t* labels) const {
+  const char* row_begin = reinterpret_cast<const char*>(X);
+  for (size_t i = 0; i < row_num; ++i, row_begin += row_stride) {
+    DenseRow<DType> row = {reinterpret_cast<const DType*>(row_begin), col_num};
+    label_t label = this->PredictFeatures(row, scores + i * this->clf_num_);
+    if (labels != nullptr) labels[i] = label;
+  }
+}
+
+// the instances of the C API
+template void Predictor::PredictCsr(const int32_t*, const int32_t*,
+                                    const float*, size_t, float*,
+                                    label_t*) const;
+template void Predictor::PredictCsr(const int32_t*, const int32_t*,
+                                    const double*, size_t, float*,
+                                    label_t*) const;
+template void Predictor::PredictCsr(const int64_t*, const int64_t*,
+                                    const float*, size_t, float*,
+                                    label_t*) const;
+template void Predictor::PredictCsr(const int64_t*, const int64_t*,
+                                    const double*, size_t, float*,
+                                    label_t*) const;
+template void Predictor::PredictDense(const float*, size_t, size_t, size_t,
+                                      float*, label_t*) const;
+template void Predictor::PredictDense(const double*, size_t, size_t, size_t,
+                                      float*, label_t*) const;
+
+float Predictor::Test(DataIter& data_iter, std::ostream* os, int thread_num,
+                      Evaluator* evaluator) const {
+  if (os != nullptr) {
+    (*os) << "label\tpredict\tscores\n";
+  }
+
+  // mini-batches are fetched in order under fetch_mutex, and the results are
+  // written in the same order
+  Mutex fetch_mutex;
+  Monitor write_monitor;
+  size_t fetch_no = 0;
+  size_t write_no = 0;
+  atomic<size_t> data_num(0);
+  atomic<size_t> err_num(0);
+
+  auto test_func = [&]() {
+    vector<float> scores;
+    vector<label_t> labels;
+    ostringstream oss;
+    unique_ptr<Evaluator> local_evaluator;
+    if (evaluator != nullptr) {
+      local_evaluator.reset(new Evaluator(evaluator->mode()));
+    }
+    while (1) {
+      // the mini-batches are recycled before waiting for the next one, as
+      // the readers may wait for them
+      fetch_mutex.lock();
+      MiniBatch* mb = data_iter.Next(nullptr);
+      size_t batch_no = fetch_no++;
+      fetch_mutex.unlock();
+      if (mb == nullptr) break;
+
+      int batch_size = mb->size();
+      scores.resize(batch_size * this->clf_num_);
+      labels.resize(batch_size);
+      this->PredictBatch(*mb, scores.data(), labels.data());
+
+      size_t batch_err_num = 0;
+      oss.str("");
+      for (int i = 0; i < batch_size; ++i) {
+        label_t x_label = (*mb)[i].label();
+        if (this->clf_num_ == 1) x_label = x_label == 1 ? 1 : -1;
+        if (labels[i] != x_label) ++batch_err_num;
+        if (local_evaluator) {
+          local_evaluator->Add(x_label, labels[i],
+                               scores.data() + i * this->clf_num_,
+                               this->clf_num_);
+        }
+        if (os != nullptr) {
+          oss << x_label << "\t" << labels[i];
+          for (int k = 0; k < this->clf_num_; ++k) {
+            oss << "\t" << scores[i * this->clf_num_ + k];
+          }
+          oss << "\n";
+        }
+      }
+      data_iter.Recycle(mb);
+      data_num += batch_size;
+      err_num += batch_err_num;
+
+      if (os != nullptr) {
+        write_monitor.lock();
+        while (write_no != batch_no) write_monitor.wait();
+        (*os) << oss.str();
+        ++write_no;
+        write_monitor.notify_all();
+        write_monitor.unlock();
+      }
+    }
+
+    if (local_evaluator) {
+      fetch_mutex.lock();
+      evaluator->Merge(*local_evaluator);
+      fetch_mutex.unlock();
+    }
+  };
+
+  if (thread_num <= 1) {
+    test_func();
+  } else {
+    vector<unique_ptr<FunctionTask>> tasks;
+    for (int i = 0; i < thread_num; ++i) {
+      tasks.emplace_back(new FunctionTask(test_func));
+      tasks.back()->Start();
+    }
+    for (unique_ptr<FunctionTask>& task : tasks) {
+      task->Join();
+    }
+  }
+  return float(double(err_num) / data_num);
+}
+
+}  // namespace model
+}  // namespace sol
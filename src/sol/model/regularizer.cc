@@ -48,7 +48,8 @@ void OnlineL1Regularizer::FinalizeRegularization(math::Vector<real_t> &w) {
   });
 }
 
-LazyOnlineL1Regularizer::LazyOnlineL1Regularizer() : initial_t_(0) {
+LazyOnlineL1Regularizer::LazyOnlineL1Regularizer()
+    : initial_t_(0), lambda2_(0) {
   this->last_update_time_.resize(1);
   this->last_update_time_ = 0;
 }
@@ -58,12 +59,22 @@ int LazyOnlineL1Regularizer::SetParameter(const std::string &name,
   if (name == "t0") {
     this->initial_t_ = stof(value);
     this->last_update_time_ = this->initial_t_;
+  } else if (name == "lambda2") {
+    this->lambda2_ = stof(value);
+    if (this->lambda2_ < 0) return Status_Invalid_Argument;
   } else {
     return OnlineL1Regularizer::SetParameter(name, value);
   }
   return Status_OK;
 }
 
+void LazyOnlineL1Regularizer::GetRegularizerInfo(Json::Value &root) const {
+  OnlineL1Regularizer::GetRegularizerInfo(root);
+  if (this->lambda2_ != 0) {
+    root["regularizer"]["lambda2"] = this->lambda2_;
+  }
+}
+
 void LazyOnlineL1Regularizer::BeginIterate(const pario::DataPoint &dp) {
   // update dim
   size_t d = this->last_update_time_.dim();
@@ -0,0 +1,297 @@
+/*********************************************************************************
+*     File Name           :     sparse_model.cc
+*     Created By          :     yuewu
+*     Description         :     compact read-only linear model with only the
+*                               non-zero weights
+**********************************************************************************/
+#include "sol/model/sparse_model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <json/json.h>
+
+#include "sol/loss/loss.h"
+#include "sol/util/error_code.h"
+
+using namespace std;
+using namespace sol::math::expr;
+using namespace sol::pario;
+
+namespace sol {
+namespace model {
+
+// format: SparseHeader, json info and the arrays indexes_, weights_ and
+// sel_feats_ in the native byte order
+static const char kSparseMagic[8] = {'S', 'O', 'L', 'S', 'P', 'A', 'R', 'S'};
+static const uint32_t kSparseVersion = 1;
+
+struct SparseHeader {
+  char magic[sizeof(kSparseMagic)];
+  uint32_t version;
+  // size of real_t
+  uint16_t real_size;
+  // size of index_t
+  uint16_t index_size;
+  // size of the json info
+  uint64_t info_size;
+};
+
+SparseModel::SparseModel()
+    : class_num_(0), clf_num_(0), norm_type_(op::OpType::kNone), dim_(0) {}
+
+int SparseModel::Build(OnlineLinearModel& model) {
+  if (model.model_updated()) model.EndTrain();
+
+  this->name_ = model.name();
+  this->class_num_ = model.class_num();
+  this->clf_num_ = model.clf_num();
+  this->norm_type_ = model.norm_type();
+  this->feature_cross_ = model.feature_cross();
+  this->dim_ = index_t(model.w(0).dim());
+
+  this->indexes_.clear();
+  this->weights_.clear();
+  for (index_t i = 0; i < this->dim_; ++i) {
+    bool non_zero = i == 0;
+    for (int c = 0; c < this->clf_num_ && !non_zero; ++c) {
+      non_zero = model.w(c)[i] != 0;
+    }
+    if (non_zero == false) continue;
+    this->indexes_.push_back(i);
+    for (int c = 0; c < this->clf_num_; ++c) {
+      this->weights_.push_back(model.w(c)[i]);
+    }
+  }
+
+  this->sel_feats_.clear();
+  const math::Vector<char>& sel_feat_flags = model.sel_feat_flags();
+  for (size_t i = 0; i < sel_feat_flags.size(); ++i) {
+    if (sel_feat_flags[i] != 0) this->sel_feats_.push_back(index_t(i));
+  }
+  return Status_OK;
+}
+
+int SparseModel::Save(const string& path) const {
+  Json::Value root;
+  root["model"] = this->name_;
+  root["cls_num"] = this->class_num_;
+  root["clf_num"] = this->clf_num_;
+  root["norm"] = int(this->norm_type_);
+  root["dim"] = Json::UInt64(this->dim_);
+  root["feat_num"] = Json::UInt64(this->indexes_.size());
+  root["sel_feat_num"] = Json::UInt64(this->sel_feats_.size());
+  if (!this->feature_cross_.empty()) {
+    root["cross"] = this->feature_cross_.crosses();
+    root["cross_bits"] = this->feature_cross_.bits();
+    root["cross_dim"] = Json::UInt64(this->feature_cross_.input_dim());
+  }
+  Json::FastWriter writer;
+  const string& info = writer.write(root);
+
+  SparseHeader header;
+  memcpy(header.magic, kSparseMagic, sizeof(kSparseMagic));
+  header.version = kSparseVersion;
+  header.real_size = uint16_t(sizeof(real_t));
+  header.index_size = uint16_t(sizeof(index_t));
+  header.info_size = info.size();
+
+  ofstream out_file(path.c_str(), ios::out | ios::binary);
+  if (!out_file) {
+    cerr << "open file " << path << " failed\n";
+    return Status_IO_Error;
+  }
+  out_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out_file.write(info.data(), info.size());
+  out_file.write(reinterpret_cast<const char*>(this->indexes_.data()),
+                 this->indexes_.size() * sizeof(index_t));
+  out_file.write(reinterpret_cast<const char*>(this->weights_.data()),
+                 this->weights_.size() * sizeof(real_t));
+  out_file.write(reinterpret_cast<const char*>(this->sel_feats_.data()),
+                 this->sel_feats_.size() * sizeof(index_t));
+  out_file.close();
+  if (!out_file) {
+    cerr << "write file " << path << " failed\n";
+    return Status_IO_Error;
+  }
+  return Status_OK;
+}
+
+int SparseModel::Load(const string& path) {
+  ifstream in_file(path.c_str(), ios::in | ios::binary);
+  if (!in_file) {
+    cerr << "open file " << path << " failed\n";
+    return Status_IO_Error;
+  }
+  SparseHeader header;
+  in_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in_file || memcmp(header.magic, kSparseMagic, sizeof(kSparseMagic)) ||
+      header.version != kSparseVersion ||
+      header.real_size != sizeof(real_t) ||
+      header.index_size != sizeof(index_t)) {
+    cerr << "invalid sparse model file " << path << "\n";
+    return Status_Invalid_Format;
+  }
+
+  string info(size_t(header.info_size), '\0');
+  in_file.read(&info[0], info.size());
+  Json::Value root;
+  Json::Reader reader;
+  if (!in_file || reader.parse(info, root) == false) {
+    cerr << "parse sparse model file " << path << " failed\n";
+    return Status_Invalid_Format;
+  }
+  this->name_ = root.get("model", "").asString();
+  this->class_num_ = root.get("cls_num", 0).asInt();
+  this->clf_num_ = root.get("clf_num", 0).asInt();
+  this->norm_type_ = op::OpType(root.get("norm", 0).asInt());
+  this->dim_ = index_t(root.get("dim", 0).asUInt64());
+  size_t feat_num = size_t(root.get("feat_num", 0).asUInt64());
+  size_t sel_feat_num = size_t(root.get("sel_feat_num", 0).asUInt64());
+  try {
+    this->feature_cross_.set_bits(root.get("cross_bits", 18).asInt());
+    this->feature_cross_.set_dim(
+        index_t(root.get("cross_dim", 0).asUInt64()));
+    this->feature_cross_.set_crosses(root.get("cross", "").asString());
+  }
+  catch (invalid_argument& err) {
+    cerr << "invalid sparse model file " << path << ": " << err.what() << "\n";
+    return Status_Invalid_Format;
+  }
+  if (this->class_num_ < 2 || this->clf_num_ < 1 || feat_num == 0) {
+    cerr << "invalid sparse model file " << path << "\n";
+    return Status_Invalid_Format;
+  }
+
+  this->indexes_.resize(feat_num);
+  this->weights_.resize(feat_num * this->clf_num_);
+  this->sel_feats_.resize(sel_feat_num);
+  in_file.read(reinterpret_cast<char*>(this->indexes_.data()),
+               this->indexes_.size() * sizeof(index_t));
+  in_file.read(reinterpret_cast<char*>(this->weights_.data()),
+               this->weights_.size() * sizeof(real_t));
+  in_file.read(reinterpret_cast<char*>(this->sel_feats_.data()),
+               this->sel_feats_.size() * sizeof(index_t));
+  if (!in_file) {
+    cerr << "read sparse model file " << path << " failed\n";
+    return Status_IO_Error;
+  }
+  return Status_OK;
+}
+
+bool SparseModel::IsSparseModel(const string& path) {
+  ifstream in_file(path.c_str(), ios::in | ios::binary);
+  char magic[sizeof(kSparseMagic)] = {0};
+  in_file.read(magic, sizeof(magic));
+  return in_file && memcmp(magic, kSparseMagic, sizeof(magic)) == 0;
+}
+
+label_t SparseModel::Predict(const DataPoint& x, float* predicts) const {
+  size_t feat_num = x.size();
+  const vector<index_t>& sel_feats = this->sel_feats_;
+  auto selected = [&sel_feats](index_t index) {
+    return sel_feats.empty() ||
+           binary_search(sel_feats.begin(), sel_feats.end(), index);
+  };
+
+  real_t norm = 1;
+  // the crossed features are computed on the fly, see Predictor
+  SelectedFeatures<DataPoint, decltype(selected)> selected_x = {x, selected};
+  bool crossed = !this->feature_cross_.empty();
+  if (this->norm_type_ != op::OpType::kNone) {
+    norm = 0;
+    bool l1 = this->norm_type_ == op::OpType::kL1;
+    for (size_t i = 0; i < feat_num; ++i) {
+      if (!selected(x.index(i))) continue;
+      real_t val = x.feature(i);
+      norm += l1 ? (val > 0 ? val : -val) : val * val;
+    }
+    if (crossed) {
+      this->feature_cross_.ForEach(
+          selected_x, [l1, &norm](index_t, real_t val) {
+            norm += l1 ? (val > 0 ? val : -val) : val * val;
+          });
+    }
+    if (this->norm_type_ == op::OpType::kL2) norm = sqrt(norm);
+  }
+
+  for (int c = 0; c < this->clf_num_; ++c) predicts[c] = 0;
+  // the features are usually sorted, so the lookup starts from the last
+  // matched feature
+  auto begin = this->indexes_.begin();
+  auto end = this->indexes_.end();
+  auto iter = begin;
+  index_t last_index = 0;
+  auto add_feature = [&](index_t index, real_t val) {
+    if (index < last_index) iter = begin;
+    last_index = index;
+    iter = lower_bound(iter, end, index);
+    if (iter == end) {
+      iter = begin;
+      return;
+    }
+    if (*iter != index) return;
+    if (this->norm_type_ != op::OpType::kNone) val /= norm;
+    const real_t* w = this->weights_.data() + (iter - begin) * this->clf_num_;
+    for (int c = 0; c < this->clf_num_; ++c) predicts[c] += w[c] * val;
+  };
+  for (size_t i = 0; i < feat_num; ++i) {
+    if (selected(x.index(i))) add_feature(x.index(i), x.feature(i));
+  }
+  if (crossed) this->feature_cross_.ForEach(selected_x, add_feature);
+  // bias
+  for (int c = 0; c < this->clf_num_; ++c) {
+    predicts[c] += this->weights_[c];
+  }
+
+  if (this->clf_num_ == 1) {
+    return loss::Loss::Sign(*predicts);
+  } else {
+    return label_t(max_element(predicts, predicts + this->clf_num_) -
+                   predicts);
+  }
+}
+
+float SparseModel::Test(DataIter& data_iter, std::ostream* os,
+                        Evaluator* evaluator) const {
+  size_t err_num = 0;
+  size_t data_num = 0;
+
+  if (os != nullptr) {
+    (*os) << "label\tpredict\tscores\n";
+  }
+
+  vector<float> predicts(this->clf_num_);
+  MiniBatch* mb = nullptr;
+  while (1) {
+    mb = data_iter.Next(mb);
+    if (mb == nullptr) break;
+    for (int i = 0; i < mb->size(); ++i) {
+      const DataPoint& x = (*mb)[i];
+      label_t label = this->Predict(x, predicts.data());
+      label_t x_label = x.label();
+      if (this->clf_num_ == 1) x_label = x_label == 1 ? 1 : -1;
+
+      if (label != x_label) err_num++;
+      if (evaluator != nullptr) {
+        evaluator->Add(x_label, label, predicts.data(), this->clf_num_);
+      }
+      if (os != nullptr) {
+        (*os) << x_label << "\t" << label;
+        for (int k = 0; k < this->clf_num_; ++k) {
+          (*os) << "\t" << predicts[k];
+        }
+        (*os) << "\n";
+      }
+      ++data_num;
+    }
+  }
+  return float(double(err_num) / data_num);
+}
+
+}  // namespace model
+}  // namespace sol
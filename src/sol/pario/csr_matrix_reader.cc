@@ -28,6 +28,12 @@ int CsrMatrixReader::Open(const std::string& path, const char* mode) {
 
 void CsrMatrixReader::Rewind() { this->x_idx_ = 0; }
 
+int CsrMatrixReader::Seek(int64_t pos) {
+  if (pos < 0 || pos > this->n_samples_) return Status_Invalid_Argument;
+  this->x_idx_ = int(pos);
+  return Status_OK;
+}
+
 std::string CsrMatrixReader::GeneratePath(int* indices, int* indptr,
                                           double* features, double* y,
                                           int n_samples) {
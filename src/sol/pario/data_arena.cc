@@ -0,0 +1,106 @@
+/*********************************************************************************
+*     File Name           :     data_arena.cc
+*     Created By          :     yuewu
+*     Description         :     in-memory dataset in CSR layout
+**********************************************************************************/
+
+#include "sol/pario/data_arena.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "sol/util/error_code.h"
+
+using namespace std;
+
+namespace sol {
+namespace pario {
+
+int DataArena::Load(DataIter& data_iter) {
+  this->labels_.clear();
+  this->indptr_.assign(1, 0);
+  this->indexes_.clear();
+  this->features_.clear();
+  this->dim_ = 0;
+
+  MiniBatch* mb = nullptr;
+  while (1) {
+    mb = data_iter.Next(mb);
+    if (mb == nullptr) break;
+    for (int i = 0; i < mb->size(); ++i) this->Append((*mb)[i]);
+  }
+  return Status_OK;
+}
+
+void DataArena::Append(const DataPoint& x) {
+  size_t feat_num = x.size();
+  this->labels_.push_back(x.label());
+  if (feat_num > 0) {
+    const index_t* indexes = x.indexes().begin();
+    const real_t* features = x.features().begin();
+    this->indexes_.insert(this->indexes_.end(), indexes, indexes + feat_num);
+    this->features_.insert(this->features_.end(), features,
+                           features + feat_num);
+  }
+  this->indptr_.push_back(this->indexes_.size());
+  if (this->dim_ < x.dim()) this->dim_ = x.dim();
+}
+
+void DataArena::CopyTo(size_t i, DataPoint& dst_pt) const {
+  size_t begin = this->indptr_[i];
+  size_t feat_num = this->indptr_[i + 1] - begin;
+  dst_pt.set_label(this->labels_[i]);
+  dst_pt.Reserve(feat_num);
+  dst_pt.Resize(feat_num);
+  if (feat_num == 0) return;
+  memcpy(dst_pt.indexes().begin(), this->indexes_.data() + begin,
+         feat_num * sizeof(index_t));
+  memcpy(dst_pt.features().begin(), this->features_.data() + begin,
+         feat_num * sizeof(real_t));
+}
+
+ArenaIter::ArenaIter(const DataArena& arena, const vector<size_t>& rows,
+                     int pass_num, int batch_size)
+    : DataIter(batch_size, 2),
+      arena_(arena),
+      rows_(rows),
+      pass_num_(pass_num),
+      pass_(0),
+      pos_(0) {}
+
+MiniBatch* ArenaIter::Next(MiniBatch* prev_batch) {
+  if (prev_batch != nullptr) {
+    this->mini_batch_factory_.Enqueue(prev_batch);
+  }
+  // wait for a free mini-batch before claiming the rows, so that the lock is
+  // not held while waiting
+  MiniBatch* mb = this->mini_batch_factory_.Dequeue();
+  size_t begin = 0, end = 0;
+  {
+    lock_guard<mutex> lock(this->pos_mutex_);
+    if (this->pos_ == this->rows_.size()) {
+      ++this->pass_;
+      this->pos_ = 0;
+    }
+    if (this->pass_ < this->pass_num_) {
+      begin = this->pos_;
+      end = (std::min)(begin + size_t(mb->capacity()), this->rows_.size());
+      this->pos_ = end;
+    }
+  }
+  if (begin == end) {
+    this->mini_batch_factory_.Enqueue(mb);
+    return nullptr;
+  }
+
+  mb->data_num = 0;
+  mb->preprocessor = nullptr;
+  for (size_t i = begin; i < end; ++i) {
+    this->arena_.CopyTo(this->rows_[i], (*mb)[mb->data_num++]);
+  }
+  this->ApplyTransforms(*mb);
+  return mb;
+}
+
+}  // namespace pario
+}  // namespace sol
@@ -7,6 +7,7 @@
 **********************************************************************************/
 
 #include "sol/pario/data_iter.h"
+#include "sol/util/stats.h"
 #include "sol/util/util.h"
 
 using namespace std;
@@ -23,6 +24,9 @@ DataIter::DataIter(int batch_size, int batch_num)
   // signal to start next reader
   this->mini_batch_buf_.Enqueue(nullptr);
   this->running_reader_idx_ = -1;
+  this->pos_.reader = -1;
+  this->pos_.pass = 0;
+  this->pos_.offset = -1;
 }
 
 DataIter::~DataIter() {
@@ -66,7 +70,8 @@ int DataIter::AddReader(const std::string& path, const std::string& dtype,
                         int pass_num) {
   int ret = Status_OK;
   shared_ptr<DataReadTask> reader(new DataReadTask(
-      path, dtype, this->mini_batch_factory_, this->mini_batch_buf_, pass_num));
+      path, dtype, this->mini_batch_factory_, this->mini_batch_buf_, pass_num,
+      this->transforms_, int(this->readers_.size())));
   if (reader->Good()) {
     this->readers_.push_back(reader);
   } else {
@@ -77,10 +82,38 @@ int DataIter::AddReader(const std::string& path, const std::string& dtype,
   return ret;
 }
 
+int DataIter::AddTransform(const std::string& spec) {
+  return Transform::CreateList(spec, this->transforms_);
+}
+
+int DataIter::Seek(const DataPos& pos) {
+  if (this->running_reader_idx_ >= 0 || pos.reader < 0 ||
+      pos.reader >= static_cast<int>(this->readers_.size())) {
+    fprintf(stderr, "seek to reader %d of %d readers failed\n", pos.reader,
+            int(this->readers_.size()));
+    return Status_Invalid_Argument;
+  }
+  int ret = this->readers_[pos.reader]->Seek(pos.pass, pos.offset);
+  if (ret != Status_OK) return ret;
+  // the readers before are not started
+  this->running_reader_idx_ = pos.reader - 1;
+  this->pos_ = pos;
+  return Status_OK;
+}
+
+bool DataIter::position(DataPos& pos) {
+  this->pos_mutex_.lock();
+  pos = this->pos_;
+  this->pos_mutex_.unlock();
+  return pos.reader >= 0 && pos.offset >= 0;
+}
+
 MiniBatch* DataIter::Next(MiniBatch* prev_batch) {
   if (prev_batch != nullptr) {
     this->mini_batch_factory_.Enqueue(prev_batch);
   }
+  Stats::Local* stats = Stats::local();
+  uint64_t start_time = stats != nullptr ? Stats::now_ns() : 0;
   MiniBatch* el = nullptr;
   do {
     el = this->mini_batch_buf_.Dequeue();
@@ -95,6 +128,12 @@ MiniBatch* DataIter::Next(MiniBatch* prev_batch) {
       }
     }
   } while (el == nullptr);
+  if (stats != nullptr) stats->Lap(Stats::kTrainerWaitNs, start_time);
+  if (el != nullptr) {
+    this->pos_mutex_.lock();
+    this->pos_ = el->pos;
+    this->pos_mutex_.unlock();
+  }
   return el;
 }
 
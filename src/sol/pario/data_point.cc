@@ -92,5 +92,21 @@ void DataPoint::Sort() {
   }
 }
 
+void DataPoint::MergeDuplicates() {
+  size_t feat_num = this->size();
+  if (feat_num == 0) return;
+  size_t k = 0;
+  for (size_t i = 1; i < feat_num; ++i) {
+    if (this->index(i) == this->index(k)) {
+      this->feature(k) += this->feature(i);
+    } else {
+      ++k;
+      this->index(k) = this->index(i);
+      this->feature(k) = this->feature(i);
+    }
+  }
+  this->Resize(k + 1);
+}
+
 }  // namespace pario
 }  // namespace sol
@@ -8,15 +8,21 @@
 
 #include "sol/pario/data_read_task.h"
 #include "sol/util/error_code.h"
+#include "sol/util/stats.h"
 
 namespace sol {
 namespace pario {
-DataReadTask::DataReadTask(const std::string& path, const std::string& dtype,
-                           BlockQueue<MiniBatch*>& mini_batch_factory,
-                           BlockQueue<MiniBatch*>& mini_batch_buf, int pass_num)
+DataReadTask::DataReadTask(
+    const std::string& path, const std::string& dtype,
+    BlockQueue<MiniBatch*>& mini_batch_factory,
+    BlockQueue<MiniBatch*>& mini_batch_buf, int pass_num,
+    const std::vector<std::shared_ptr<Transform>>& transforms, int index)
     : mini_batch_factory_(mini_batch_factory),
       mini_batch_buf_(mini_batch_buf),
-      pass_num_(pass_num) {
+      pass_num_(pass_num),
+      pass_(0),
+      index_(index),
+      transforms_(transforms) {
   DataReader* reader = DataReader::Create(dtype);
   if (reader != nullptr) {
     if (reader->Open(path) != Status_OK) {
@@ -27,16 +33,34 @@ DataReadTask::DataReadTask(const std::string& path, const std::string& dtype,
   this->reader_.reset(reader);
 }
 
+int DataReadTask::Seek(int pass, int64_t offset) {
+  if (pass < 0 || pass > this->pass_ + this->pass_num_) {
+    return Status_Invalid_Argument;
+  }
+  this->pass_num_ -= pass - this->pass_;
+  this->pass_ = pass;
+  if (offset < 0 || this->pass_num_ == 0) return Status_OK;
+  return this->reader_->Seek(offset);
+}
+
 void DataReadTask::run() {
   int status = Status_OK;
   DataReader* reader = this->reader_.get();
   while (status == Status_OK && this->pass_num_ > 0) {
+    Stats::Local* stats = Stats::local();
+    uint64_t start_time = stats != nullptr ? Stats::now_ns() : 0;
     MiniBatch* mini_batch = this->mini_batch_factory_.Dequeue();
     if (mini_batch == nullptr) {  // exit signal
       this->mini_batch_factory_.Enqueue(nullptr);
       break;
     }
+    uint64_t read_bytes = 0;
+    if (stats != nullptr) {
+      start_time = stats->Lap(Stats::kReaderWaitNs, start_time);
+      read_bytes = reader->read_bytes();
+    }
     mini_batch->data_num = 0;
+    mini_batch->preprocessor = nullptr;
     while (mini_batch->data_num < mini_batch->capacity() &&
            status == Status_OK) {
       status = reader->Next((*mini_batch)[mini_batch->data_num]);
@@ -45,12 +69,24 @@ void DataReadTask::run() {
         continue;
       } else if (status == Status_EndOfFile) {
         --this->pass_num_;
+        ++this->pass_;
         reader->Rewind();
         status = Status_OK;
         break;
       } else
         break;
     }
+    if (stats != nullptr) {
+      stats->Lap(Stats::kParseNs, start_time);
+      stats->Add(Stats::kParseNum, uint64_t(mini_batch->data_num));
+      stats->Add(Stats::kReadBytes, reader->read_bytes() - read_bytes);
+    }
+    mini_batch->pos.reader = this->index_;
+    mini_batch->pos.pass = this->pass_;
+    mini_batch->pos.offset = reader->Tell();
+    for (const std::shared_ptr<Transform>& trans : this->transforms_) {
+      trans->Apply(*mini_batch);
+    }
     this->mini_batch_buf_.Enqueue(mini_batch);
   }
   reader->Close();
@@ -9,8 +9,10 @@
 #include "sol/pario/data_reader.h"
 
 #include <cstdlib>
+#include <stdexcept>
 
 #include "sol/util/error_code.h"
+#include "sol/util/str_util.h"
 
 using namespace std;
 
@@ -18,13 +20,38 @@ namespace sol {
 namespace pario {
 
 DataReader* DataReader::Create(const std::string& type) {
-  auto create_func = CreateObject<DataReader>(std::string(type) + "_reader");
-  return create_func == nullptr ? nullptr : create_func();
+  // parameters follow the type as 'type:param=val,param=val'
+  size_t pos = type.find(':');
+  auto create_func = CreateObject<DataReader>(type.substr(0, pos) + "_reader");
+  if (create_func == nullptr) return nullptr;
+  DataReader* reader = create_func();
+  if (pos == string::npos) return reader;
+
+  for (const string& param : split(type.substr(pos + 1), ',')) {
+    if (strip(param).empty()) continue;
+    const vector<string>& param_pair = split(param, '=');
+    try {
+      if (param_pair.size() != 2) {
+        throw invalid_argument("invalid reader parameter: " + param);
+      }
+      reader->SetParameter(strip(param_pair[0]), strip(param_pair[1]));
+    }
+    catch (invalid_argument& err) {
+      fprintf(stderr, "%s\n", err.what());
+      delete reader;
+      return nullptr;
+    }
+  }
+  return reader;
 }
 
 DataReader::DataReader() {}
 DataReader::~DataReader() {}
 
+void DataReader::SetParameter(const string& name, const string& value) {
+  throw invalid_argument("unknown reader parameter " + name);
+}
+
 DataFileReader::DataFileReader() {
   this->read_buf_size_ = 4096;
   this->read_buf_ = (char*)malloc(this->read_buf_size_ * sizeof(char));
@@ -22,9 +22,9 @@ using namespace std;
 namespace sol {
 namespace pario {
 
-FileReader::FileReader() : file_(nullptr), mode_(kUnknown) {}
+FileReader::FileReader() : file_(nullptr), mode_(kUnknown), read_bytes_(0) {}
 FileReader::FileReader(const char* path, const char* mode)
-    : file_(nullptr), mode_(kUnknown) {
+    : file_(nullptr), mode_(kUnknown), read_bytes_(0) {
   this->Open(path, mode);
 }
 
@@ -55,6 +55,7 @@ int FileReader::Open(const char* path, const char* mode) {
     fprintf(stderr, "Error: open file (%s) failed.\n", path);
     return Status_IO_Error;
   }
+  this->read_bytes_ = 0;
 
   return Status_OK;
 }
@@ -71,6 +72,19 @@ void FileReader::Rewind() {
   if (this->file_ != nullptr) rewind(this->file_);
 }
 
+int64_t FileReader::Tell() {
+  return this->file_ == nullptr ? -1 : tell_file(this->file_);
+}
+
+int FileReader::Seek(int64_t pos) {
+  if (this->file_ == nullptr || pos < 0 || !seek_file(this->file_, pos)) {
+    fprintf(stderr, "Error %d: seek to %lld failed\n", Status_IO_Error,
+            (long long)(pos));
+    return Status_IO_Error;
+  }
+  return Status_OK;
+}
+
 bool FileReader::Good() {
   // we do not need to handle eof here, when eof is set, ferror still returns
   // 0
@@ -79,6 +93,7 @@ bool FileReader::Good() {
 
 int FileReader::Read(char* dst, size_t length) {
   size_t read_len = fread(dst, 1, length, this->file_);
+  this->read_bytes_ += read_len;
   if (read_len == length) {
     return Status_OK;
   } else if (feof(this->file_)) {
@@ -96,7 +111,6 @@ int FileReader::ReadLine(char*& dst, int& dst_len) {
         "ReadLine can only be called when only file is opened with `text` "
         "mode.\n");
   }
-  int len(0);
   if (fgets(dst, dst_len, this->file_) == nullptr) {
     if (feof(this->file_)) {
       return Status_EndOfFile;
@@ -105,12 +119,16 @@ int FileReader::ReadLine(char*& dst, int& dst_len) {
       return Status_IO_Error;
     }
   }
-  while (strrchr(dst, '\n') == nullptr) {
+  // fgets stops after the first '\n', so the line is complete if it ends
+  // with '\n'
+  int len = int(strlen(dst));
+  while (len == 0 || dst[len - 1] != '\n') {
     dst_len *= 2;
     dst = (char*)realloc(dst, dst_len);
-    len = int(strlen(dst));
     if (fgets(dst + len, dst_len - len, this->file_) == nullptr) break;
+    len += int(strlen(dst + len));
   }
+  this->read_bytes_ += len;
   return Status_OK;
 }
 
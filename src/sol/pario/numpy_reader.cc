@@ -27,6 +27,12 @@ int NumpyReader::Open(const std::string& path, const char* mode) {
 
 void NumpyReader::Rewind() { this->x_idx_ = 0; }
 
+int NumpyReader::Seek(int64_t pos) {
+  if (pos < 0 || pos > this->n_samples_) return Status_Invalid_Argument;
+  this->x_idx_ = int(pos);
+  return Status_OK;
+}
+
 std::string NumpyReader::GeneratePath(double* x, double* y, int rows, int cols,
                                       int stride) {
   ostringstream path;
@@ -0,0 +1,208 @@
+/*********************************************************************************
+*     File Name           :     transform.cc
+*     Created By          :     yuewu
+*     Description         :     transforms of the data in mini-batches
+**********************************************************************************/
+
+#include "sol/pario/transform.h"
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "sol/util/error_code.h"
+#include "sol/util/hash.h"
+#include "sol/util/str_util.h"
+
+using namespace std;
+using namespace sol::math::expr;
+
+namespace sol {
+namespace pario {
+
+Transform* Transform::Create(const std::string& type) {
+  auto create_func = CreateObject<Transform>(std::string(type) + "_transform");
+  return create_func == nullptr ? nullptr : create_func();
+}
+
+void Transform::SetParameter(const string& name, const string& value) {
+  throw invalid_argument("unknown transform parameter " + name);
+}
+
+int Transform::CreateList(const string& spec,
+                          vector<shared_ptr<Transform>>& transforms) {
+  for (const string& item : split(spec, ';')) {
+    string trans_spec = strip(item);
+    if (trans_spec.empty()) continue;
+    size_t pos = trans_spec.find(':');
+    const string& name = strip(trans_spec.substr(0, pos));
+    shared_ptr<Transform> trans(Transform::Create(name));
+    if (trans == nullptr) return Status_Invalid_Argument;
+    if (pos != string::npos) {
+      for (const string& param : split(trans_spec.substr(pos + 1), ',')) {
+        if (strip(param).empty()) continue;
+        const vector<string>& param_pair = split(param, '=');
+        if (param_pair.size() != 2) {
+          fprintf(stderr, "invalid transform parameter: %s\n", param.c_str());
+          return Status_Invalid_Argument;
+        }
+        try {
+          trans->SetParameter(strip(param_pair[0]), strip(param_pair[1]));
+        }
+        catch (invalid_argument& err) {
+          fprintf(stderr, "%s\n", err.what());
+          return Status_Invalid_Argument;
+        }
+      }
+    }
+    transforms.push_back(trans);
+  }
+  return Status_OK;
+}
+
+RegisterTransform(NormTransform, "norm", "L1 or L2 normalization");
+
+void NormTransform::SetParameter(const string& name, const string& value) {
+  if (name == "type") {
+    if (value == "l1" || value == "L1") {
+      this->l2_ = false;
+    } else if (value == "l2" || value == "L2") {
+      this->l2_ = true;
+    } else {
+      throw invalid_argument("unknown norm type " + value);
+    }
+  } else {
+    Transform::SetParameter(name, value);
+  }
+}
+
+void NormTransform::Apply(DataPoint& x) const {
+  if (x.size() == 0) return;
+  real_t norm = 0;
+  if (this->l2_) {
+    norm = reduce<op::plus>(L2(x.data()));
+    x.data() /= sqrt(norm);
+  } else {
+    norm = reduce<op::plus>(L1(x.data()));
+    x.data() /= norm;
+  }
+}
+
+RegisterTransform(FilterTransform, "filter", "remove features not selected");
+
+void FilterTransform::SetParameter(const string& name, const string& value) {
+  if (name == "path") {
+    ifstream in_file(value.c_str(), ios::in);
+    if (!in_file) {
+      throw invalid_argument("open file " + value + " failed");
+    }
+    this->sel_feat_flags_.clear();
+    string line;
+    while (getline(in_file, line)) {
+      const char* p = line.c_str();
+      while (*p == ' ' || *p == '\t') ++p;
+      // skip comments and empty lines
+      if (*p == '#' || *p == '\0') continue;
+      int index = stoi(line);
+      if (index <= 0) {
+        throw invalid_argument("parse index " + line + " failed");
+      }
+      if (size_t(index) >= this->sel_feat_flags_.size()) {
+        this->sel_feat_flags_.resize(index + 1, 0);
+      }
+      this->sel_feat_flags_[index] = 1;
+    }
+  } else {
+    Transform::SetParameter(name, value);
+  }
+}
+
+void FilterTransform::Apply(DataPoint& x) const {
+  size_t max_index = this->sel_feat_flags_.size();
+  size_t feat_num = x.size();
+  size_t k = 0;
+  for (size_t i = 0; i < feat_num; ++i) {
+    index_t index = x.index(i);
+    if (index < max_index && this->sel_feat_flags_[index] != 0) {
+      x.index(k) = index;
+      x.feature(k) = x.feature(i);
+      ++k;
+    }
+  }
+  x.Resize(k);
+}
+
+RegisterTransform(BinarizeTransform, "binarize", "binarize the features");
+
+void BinarizeTransform::SetParameter(const string& name, const string& value) {
+  if (name == "thresh") {
+    this->thresh_ = real_t(stof(value));
+  } else {
+    Transform::SetParameter(name, value);
+  }
+}
+
+void BinarizeTransform::Apply(DataPoint& x) const {
+  size_t feat_num = x.size();
+  for (size_t i = 0; i < feat_num; ++i) {
+    x.feature(i) = x.feature(i) > this->thresh_ ? 1 : -1;
+  }
+}
+
+RegisterTransform(ClipTransform, "clip", "clip the features to a range");
+
+ClipTransform::ClipTransform()
+    : min_(-numeric_limits<real_t>::max()),
+      max_(numeric_limits<real_t>::max()) {}
+
+void ClipTransform::SetParameter(const string& name, const string& value) {
+  if (name == "min") {
+    this->min_ = real_t(stof(value));
+  } else if (name == "max") {
+    this->max_ = real_t(stof(value));
+  } else {
+    Transform::SetParameter(name, value);
+  }
+}
+
+void ClipTransform::Apply(DataPoint& x) const {
+  size_t feat_num = x.size();
+  for (size_t i = 0; i < feat_num; ++i) {
+    real_t& feat = x.feature(i);
+    if (feat < this->min_) {
+      feat = this->min_;
+    } else if (feat > this->max_) {
+      feat = this->max_;
+    }
+  }
+}
+
+RegisterTransform(HashTransform, "hash", "hash the feature indexes");
+
+void HashTransform::SetParameter(const string& name, const string& value) {
+  if (name == "bits") {
+    int bits = stoi(value);
+    if (bits <= 0 || bits > 31) {
+      throw invalid_argument("hash bits should be in [1, 31]");
+    }
+    this->bits_ = bits;
+  } else {
+    Transform::SetParameter(name, value);
+  }
+}
+
+void HashTransform::Apply(DataPoint& x) const {
+  size_t feat_num = x.size();
+  if (feat_num == 0) return;
+  uint32_t mask = (uint32_t(1) << this->bits_) - 1;
+  for (size_t i = 0; i < feat_num; ++i) {
+    x.index(i) = index_t(fmix32(uint32_t(x.index(i))) & mask) + 1;
+  }
+  x.Sort();
+  x.MergeDuplicates();
+}
+
+}  // namespace pario
+}  // namespace sol
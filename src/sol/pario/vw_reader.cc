@@ -0,0 +1,125 @@
+/*********************************************************************************
+*     File Name           :     vw_reader.cc
+*     Created By          :     yuewu
+*     Description         :     reader of vowpal wabbit format data
+**********************************************************************************/
+
+#include "sol/pario/vw_reader.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "sol/pario/numeric_parser.h"
+#include "sol/util/hash.h"
+
+using namespace std;
+
+namespace sol {
+namespace pario {
+
+VWReader::VWReader() : bits_(18), mask_((uint32_t(1) << 18) - 1) {}
+
+void VWReader::SetParameter(const string& name, const string& value) {
+  if (name == "bits") {
+    int bits = stoi(value);
+    if (bits <= 0 || bits > 31) {
+      throw invalid_argument("hash bits should be in [1, 31]");
+    }
+    this->bits_ = bits;
+    this->mask_ = (uint32_t(1) << bits) - 1;
+  } else {
+    DataReader::SetParameter(name, value);
+  }
+}
+
+/// \brief  end of a name of feature or namespace
+inline char *SkipName(char *p) {
+  while (*p != '\0' && *p != ':' && *p != '|' &&
+         NumericParser::is_space(p) == false) {
+    ++p;
+  }
+  return p;
+}
+
+int VWReader::Next(DataPoint &dst_data) {
+  int ret = this->file_reader_.ReadLine(this->read_buf_, this->read_buf_size_);
+  if (ret != Status_OK) return ret;
+
+  char *iter = this->read_buf_, *endptr = nullptr;
+  char *bar = strchr(iter, '|');
+  if (bar == nullptr) {
+    fprintf(stderr, "incorrect line, no namespace found\n");
+    this->is_good_ = false;
+    return Status_Invalid_Format;
+  }
+
+  dst_data.Clear();
+  // 1. parse label, the importance and the tag are ignored
+  dst_data.set_label(label_t(NumericParser::ParseInt(iter, endptr)));
+  if (endptr == iter || endptr > bar) {
+    fprintf(stderr, "parse label failed.\n");
+    this->is_good_ = false;
+    return Status_Invalid_Format;
+  }
+  iter = bar;
+
+  // 2. parse namespaces and features
+  uint32_t seed = 0;
+  real_t scale = 1;
+  while (*iter != '\0') {
+    if (NumericParser::is_space(iter)) {
+      ++iter;
+    } else if (*iter == '|') {
+      // the namespace name follows '|' directly
+      char *name = ++iter;
+      iter = SkipName(iter);
+      seed = murmur3_32(name, iter - name, 0);
+      scale = 1;
+      if (*iter == ':') {
+        ++iter;
+        scale = NumericParser::ParseFloat(iter, endptr);
+        if (endptr == iter) {
+          fprintf(stderr, "parse namespace scale (%s) failed!\n", iter);
+          this->is_good_ = false;
+          return Status_Invalid_Format;
+        }
+        iter = endptr;
+      }
+    } else {
+      char *name = iter;
+      iter = SkipName(iter);
+      size_t name_len = iter - name;
+      if (name_len == 0) {
+        // a single ':' without name
+        fprintf(stderr, "incorrect input file (%s)!\n", iter);
+        this->is_good_ = false;
+        return Status_Invalid_Format;
+      }
+      real_t feat = 1;
+      if (*iter == ':') {
+        ++iter;
+        feat = NumericParser::ParseFloat(iter, endptr);
+        if (endptr == iter) {
+          fprintf(stderr, "parse feature value (%s) failed!\n", iter);
+          this->is_good_ = false;
+          return Status_Invalid_Format;
+        }
+        iter = endptr;
+      }
+      if (feat == 0) continue;
+      index_t index =
+          index_t(murmur3_32(name, name_len, seed) & this->mask_) + 1;
+      dst_data.AddNewFeat(index, feat * scale);
+    }
+  }
+  dst_data.Sort();
+  dst_data.MergeDuplicates();
+
+  return ret;
+}
+
+RegisterDataReader(VWReader, "vw", "vowpal wabbit format data reader");
+
+}  // namespace pario
+}  // namespace sol
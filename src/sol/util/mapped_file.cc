@@ -0,0 +1,101 @@
+/*********************************************************************************
+*     File Name           :     mapped_file.cc
+*     Created By          :     yuewu
+*     Description         :     file mapped into memory
+**********************************************************************************/
+#include "sol/util/mapped_file.h"
+
+#include <fstream>
+
+#if !_WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "sol/util/error_code.h"
+
+using namespace std;
+
+namespace sol {
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), mapped_(false) {}
+
+MappedFile::~MappedFile() { this->Close(); }
+
+#if _WIN32
+
+int MappedFile::Open(const string& path) {
+  this->Close();
+  ifstream in_file(path.c_str(), ios::in | ios::binary);
+  if (!in_file) {
+    fprintf(stderr, "open file %s failed\n", path.c_str());
+    return Status_IO_Error;
+  }
+  in_file.seekg(0, ios::end);
+  size_t size = size_t(in_file.tellg());
+  in_file.seekg(0, ios::beg);
+  this->data_ = new char[size];
+  if (!in_file.read(this->data_, size)) {
+    fprintf(stderr, "read file %s failed\n", path.c_str());
+    this->Close();
+    return Status_IO_Error;
+  }
+  this->size_ = size;
+  return Status_OK;
+}
+
+void MappedFile::Close() {
+  DeleteArray(this->data_);
+  this->size_ = 0;
+}
+
+#else
+
+int MappedFile::Open(const string& path) {
+  this->Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "open file %s failed\n", path.c_str());
+    return Status_IO_Error;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    fprintf(stderr, "stat file %s failed\n", path.c_str());
+    close(fd);
+    return Status_IO_Error;
+  }
+  size_t size = size_t(st.st_size);
+  if (size == 0) {
+    close(fd);
+    return Status_OK;
+  }
+  // private and writable, so that the loaded model can still be trained
+  void* addr =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    fprintf(stderr, "map file %s failed\n", path.c_str());
+    return Status_IO_Error;
+  }
+  this->data_ = static_cast<char*>(addr);
+  this->size_ = size;
+  this->mapped_ = true;
+  return Status_OK;
+}
+
+void MappedFile::Close() {
+  if (this->mapped_) {
+    munmap(this->data_, this->size_);
+    this->data_ = nullptr;
+    this->mapped_ = false;
+  } else {
+    DeleteArray(this->data_);
+  }
+  this->size_ = 0;
+}
+
+#endif
+
+}  // namespace sol
@@ -0,0 +1,103 @@
+/*********************************************************************************
+*     File Name           :     stats.cc
+*     Created By          :     yuewu
+*     Description         :     counters of the stages of the training pipeline
+**********************************************************************************/
+#include "sol/util/stats.h"
+
+#include <memory>
+#include <vector>
+
+#include "sol/util/mutex.h"
+
+using namespace std;
+
+namespace sol {
+
+std::atomic<bool> Stats::enabled_(false);
+
+namespace {
+
+/// \brief  counters of all the threads, the counters of the exited threads
+// are reused by the new threads so that the sums are kept
+struct LocalPool {
+  Mutex mutex;
+  vector<unique_ptr<Stats::Local>> locals;
+  vector<Stats::Local*> free_locals;
+};
+
+LocalPool& pool() {
+  static LocalPool local_pool;
+  return local_pool;
+}
+
+/// \brief  return the counters of a thread to the pool when the thread exits
+struct LocalHolder {
+  Stats::Local* local = nullptr;
+  ~LocalHolder() {
+    if (this->local == nullptr) return;
+    LocalPool& p = pool();
+    p.mutex.lock();
+    p.free_locals.push_back(this->local);
+    p.mutex.unlock();
+  }
+};
+
+thread_local LocalHolder local_holder;
+
+}  // namespace
+
+Stats::Local::Local() {
+  for (int i = 0; i < kCounterNum; ++i) this->counters_[i].store(0);
+}
+
+Stats::Local* Stats::AcquireLocal() {
+  if (local_holder.local != nullptr) return local_holder.local;
+  LocalPool& p = pool();
+  p.mutex.lock();
+  if (p.free_locals.empty()) {
+    p.locals.emplace_back(new Local());
+    local_holder.local = p.locals.back().get();
+  } else {
+    local_holder.local = p.free_locals.back();
+    p.free_locals.pop_back();
+  }
+  p.mutex.unlock();
+  return local_holder.local;
+}
+
+void Stats::Collect(PipelineStats& stats) {
+  uint64_t sums[kCounterNum] = {0};
+  LocalPool& p = pool();
+  p.mutex.lock();
+  for (const unique_ptr<Local>& local : p.locals) {
+    for (int i = 0; i < kCounterNum; ++i) {
+      sums[i] += local->counters_[i].load(memory_order_relaxed);
+    }
+  }
+  p.mutex.unlock();
+
+  stats.parse_ns = sums[kParseNs];
+  stats.parse_num = sums[kParseNum];
+  stats.read_bytes = sums[kReadBytes];
+  stats.reader_wait_ns = sums[kReaderWaitNs];
+  stats.trainer_wait_ns = sums[kTrainerWaitNs];
+  stats.predict_ns = sums[kPredictNs];
+  stats.loss_ns = sums[kLossNs];
+  stats.update_ns = sums[kUpdateNs];
+  stats.realloc_num = sums[kReallocNum];
+  stats.realloc_bytes = sums[kReallocBytes];
+}
+
+void Stats::Reset() {
+  LocalPool& p = pool();
+  p.mutex.lock();
+  for (const unique_ptr<Local>& local : p.locals) {
+    for (int i = 0; i < kCounterNum; ++i) {
+      local->counters_[i].store(0, memory_order_relaxed);
+    }
+  }
+  p.mutex.unlock();
+}
+
+}  // namespace sol
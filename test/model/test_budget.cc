@@ -0,0 +1,107 @@
+/*********************************************************************************
+*     File Name           :     test_budget.cc
+*     Created By          :     yuewu
+*     Description         :     test the weight budget of online linear models
+**********************************************************************************/
+#include <cstdio>
+#include <memory>
+
+#include <sol/sol.h>
+#include <sol/model/online_linear_model.h>
+
+using namespace std;
+using namespace sol;
+using namespace sol::pario;
+using namespace sol::model;
+
+int test_budget(const string& algo, const string& budget,
+                const vector<DataPoint>& points) {
+  unique_ptr<Model> model(Model::Create(algo, 2));
+  OnlineLinearModel* olm = dynamic_cast<OnlineLinearModel*>(model.get());
+  if (olm == nullptr) {
+    fprintf(stderr, "create model %s failed\n", algo.c_str());
+    return 1;
+  }
+  olm->SetParameter("budget", budget);
+  olm->BeginTrain();
+
+  // the budget holds after each update, through several passes
+  float predicts[1];
+  size_t max_active_num = 0;
+  for (int pass = 0; pass < 3; ++pass) {
+    for (const DataPoint& x : points) {
+      olm->Iterate(x, predicts);
+      size_t active_num = olm->active_feature_num();
+      if (active_num > olm->budget()) {
+        fprintf(stderr, "%s: %d active features exceed the budget %s\n",
+                algo.c_str(), int(active_num), budget.c_str());
+        return 1;
+      }
+      if (active_num > max_active_num) max_active_num = active_num;
+    }
+  }
+  olm->EndTrain();
+  printf("%s: at most %d active features with budget %s, %d evicted\n",
+         algo.c_str(), int(max_active_num), budget.c_str(),
+         int(olm->evict_num()));
+  return 0;
+}
+
+/// \brief  check the budget whenever it is reported while training
+void CheckBudget(void* user_context, long long iter_num, long long active_num,
+                 long long evict_num) {
+  pair<size_t, int>* status = static_cast<pair<size_t, int>*>(user_context);
+  if (size_t(active_num) > status->first) {
+    fprintf(stderr, "%d active features exceed the budget %d at iteration %d\n",
+            int(active_num), int(status->first), int(iter_num));
+    status->second = 1;
+  }
+}
+
+int test_train_budget(const string& algo, const string& budget,
+                      const char* path) {
+  unique_ptr<Model> model(Model::Create(algo, 2));
+  OnlineLinearModel* olm = dynamic_cast<OnlineLinearModel*>(model.get());
+  if (olm == nullptr) {
+    fprintf(stderr, "create model %s failed\n", algo.c_str());
+    return 1;
+  }
+  olm->SetParameter("budget", budget);
+  olm->set_iterate_callback(nullptr, nullptr);
+  pair<size_t, int> status(stoul(budget), 0);
+  olm->set_budget_callback(CheckBudget, &status);
+
+  DataIter iter;
+  iter.AddReader(path, "svm", 3);
+  olm->Train(iter, NULL, NULL, NULL, NULL, NULL, NULL);
+  if (olm->active_feature_num() > olm->budget()) status.second = 1;
+  if (status.second != 0) {
+    fprintf(stderr, "%s: training exceeds the budget %s\n", algo.c_str(),
+            budget.c_str());
+  }
+  return status.second;
+}
+
+int main() {
+  const char* path = "data/a1a";
+  unique_ptr<DataReader> reader(DataReader::Create("svm"));
+  if (reader == nullptr || reader->Open(path) != Status_OK) {
+    fprintf(stderr, "open %s failed\n", path);
+    return 1;
+  }
+  vector<DataPoint> points;
+  DataPoint x;
+  while (reader->Next(x) == Status_OK) points.push_back(x.Clone());
+  reader->Close();
+
+  // the budgets are at least the number of features of an instance, whose
+  // features are always kept
+  int ret = 0;
+  ret |= test_budget("ogd", "20", points);
+  ret |= test_budget("ogd", "40", points);
+  ret |= test_budget("ada-fobos", "40", points);
+  ret |= test_budget("ada-rda", "40", points);
+  ret |= test_train_budget("ogd", "20", path);
+  ret |= test_train_budget("ada-fobos", "40", path);
+  return ret;
+}
@@ -0,0 +1,72 @@
+/*********************************************************************************
+*     File Name           :     test_evaluator.cc
+*     Created By          :     yuewu
+*     Description         :     test the AUC of the evaluator
+**********************************************************************************/
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <sol/model/evaluator.h>
+
+using namespace std;
+using namespace sol;
+using namespace sol::model;
+
+int main() {
+  size_t data_num = 10000;
+  mt19937 gen(0);
+  normal_distribution<float> dis(0, 1);
+  vector<label_t> labels(data_num);
+  vector<float> scores(data_num);
+  for (size_t i = 0; i < data_num; ++i) {
+    labels[i] = gen() % 3 == 0 ? 1 : -1;
+    // rounded scores to have ties
+    scores[i] = roundf((dis(gen) + labels[i] * 0.5f) * 100) / 100;
+  }
+
+  // AUC by pairs, ties are counted as half
+  double pairs = 0;
+  double correct = 0;
+  for (size_t i = 0; i < data_num; ++i) {
+    if (labels[i] != 1) continue;
+    for (size_t j = 0; j < data_num; ++j) {
+      if (labels[j] == 1) continue;
+      ++pairs;
+      if (scores[i] > scores[j]) correct += 1;
+      if (scores[i] == scores[j]) correct += 0.5;
+    }
+  }
+  float expected = float(correct / pairs);
+
+  // accumulate in two evaluators and merge them
+  Evaluator exact(AucMode::Exact), approx(AucMode::Approx);
+  Evaluator exact2(AucMode::Exact), approx2(AucMode::Approx);
+  for (size_t i = 0; i < data_num; ++i) {
+    label_t predict = scores[i] >= 0 ? 1 : -1;
+    (i % 2 == 0 ? exact : exact2).Add(labels[i], predict, &scores[i], 1);
+    (i % 2 == 0 ? approx : approx2).Add(labels[i], predict, &scores[i], 1);
+  }
+  exact.Merge(exact2);
+  approx.Merge(approx2);
+
+  float tpr_fig[Evaluator::kRocFigSize] = {0};
+  float fpr_fig[Evaluator::kRocFigSize] = {0};
+  float tpr_tab[Evaluator::kRocTabSize] = {0};
+  float fpr_tab[Evaluator::kRocTabSize] = {0};
+  float exact_auc = exact.Roc(tpr_fig, fpr_fig, tpr_tab, fpr_tab);
+  float approx_auc = approx.AUC();
+  fprintf(stdout, "AUC: %f, exact: %f, approx: %f\n", expected, exact_auc,
+          approx_auc);
+
+  int ret = fabs(exact_auc - expected) < 1e-6f ? 0 : 1;
+  ret |= fabs(approx_auc - expected) < 1e-2f ? 0 : 1;
+  ret |= exact.data_num() == data_num ? 0 : 1;
+  // the whole curve ends at (1, 1)
+  ret |= tpr_tab[Evaluator::kRocTabSize - 1] == 1 ? 0 : 1;
+  ret |= fabs(fpr_tab[Evaluator::kRocTabSize - 1] - 1) < 1e-5f ? 0 : 1;
+
+  fprintf(stdout, ret == 0 ? "test passed\n" : "test failed\n");
+  return ret;
+}
@@ -0,0 +1,86 @@
+/*********************************************************************************
+*     File Name           :     test_feature_cross.cc
+*     Created By          :     yuewu
+*     Description         :     test the crosses of features
+**********************************************************************************/
+#include <cstdio>
+#include <stdexcept>
+
+#include <sol/model/feature_cross.h>
+
+using namespace std;
+using namespace sol;
+using namespace sol::pario;
+using namespace sol::model;
+
+int main() {
+  FeatureCross cross;
+  cross.set_bits(4);
+  cross.set_crosses("1-4*1-4,1-2*5-6*7");
+
+  DataPoint x;
+  for (index_t i = 1; i <= 7; ++i) x.AddNewFeat(i, real_t(i));
+  // filtered features are zero
+  x.feature(2) = 0;
+
+  size_t cross_num = 0;
+  real_t sum = 0;
+  cross.ForEach(x, [&](index_t index, real_t val) {
+    if (index <= 7 || index > 7 + 16) {
+      fprintf(stderr, "invalid crossed index %d\n", int(index));
+      cross_num = 1000;
+    }
+    ++cross_num;
+    sum += val;
+  });
+  // pairs of {1, 2, 4} with themselves: 6, triples of {1, 2} x {5, 6} x {7}: 4
+  real_t expected_sum = (1 * 1 + 1 * 2 + 1 * 4 + 2 * 2 + 2 * 4 + 4 * 4) +
+                        (1 + 2) * (5 + 6) * 7;
+  if (cross_num != 10 || sum != expected_sum) {
+    fprintf(stderr, "%d crosses of sum %f, expected 10 crosses of sum %f\n",
+            int(cross_num), sum, expected_sum);
+    return 1;
+  }
+
+  cross.Expand(x);
+  if (x.size() != 17) {
+    fprintf(stderr, "%d features after expanding\n", int(x.size()));
+    return 1;
+  }
+  for (size_t i = 0; i < x.size(); ++i) {
+    if (x.index(i) >= x.dim()) {
+      fprintf(stderr, "dimension of expanded data is not kept\n");
+      return 1;
+    }
+  }
+
+  // crossed features are placed after the declared input dimension
+  cross.set_dim(100);
+  DataPoint y;
+  for (index_t i = 1; i <= 7; ++i) y.AddNewFeat(i, real_t(i));
+  y.AddNewFeat(100, 1);
+  cross.ForEach(y, [&](index_t index, real_t val) {
+    if (index <= 100) cross_num = 1000;
+  });
+  if (cross_num == 1000 || !cross.Expand(y)) {
+    fprintf(stderr, "crossed features overlap with the input features\n");
+    return 1;
+  }
+  DataPoint z;
+  z.AddNewFeat(1, 1);
+  z.AddNewFeat(2, 1);
+  z.AddNewFeat(200, 1);
+  if (cross.Expand(z)) {
+    fprintf(stderr, "features above the input dimension not detected\n");
+    return 1;
+  }
+
+  try {
+    cross.set_crosses("1-4");
+    fprintf(stderr, "single range not detected\n");
+    return 1;
+  }
+  catch (invalid_argument&) {
+  }
+  return 0;
+}
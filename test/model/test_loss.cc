@@ -0,0 +1,96 @@
+/*********************************************************************************
+*     File Name           :     test_loss.cc
+*     Created By          :     yuewu
+*     Description         :     test the batch gradients of loss functions
+**********************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sol/loss/loss.h>
+#include <sol/math/fast_math.h>
+
+using namespace std;
+using namespace sol;
+using namespace sol::loss;
+
+/// \brief  check the batch gradients against the gradients of each instance
+int test_loss(const string& name, int cls_num, float tolerance) {
+  unique_ptr<Loss> loss(Loss::Create(name));
+  if (loss == nullptr) {
+    fprintf(stderr, "create loss %s failed\n", name.c_str());
+    return -1;
+  }
+
+  size_t data_num = 1000;
+  mt19937 gen(0);
+  uniform_real_distribution<float> dis(-20, 20);
+  vector<label_t> labels(data_num), predict_labels(data_num);
+  vector<float> predicts(data_num * cls_num);
+  for (size_t i = 0; i < data_num; ++i) {
+    float* predict = predicts.data() + i * cls_num;
+    for (int c = 0; c < cls_num; ++c) predict[c] = dis(gen);
+    if (cls_num == 1) {
+      labels[i] = dis(gen) > 0 ? 1 : -1;
+      predict_labels[i] = Loss::Sign(*predict);
+    } else {
+      labels[i] = label_t(gen() % cls_num);
+      predict_labels[i] =
+          label_t(max_element(predict, predict + cls_num) - predict);
+    }
+  }
+
+  vector<float> gradients(data_num * cls_num), losses(data_num);
+  loss->BatchGradient(labels.data(), predicts.data(), predict_labels.data(),
+                      gradients.data(), losses.data(), data_num, cls_num);
+
+  pario::DataPoint dp;
+  vector<float> gradient(cls_num);
+  float max_err = 0;
+  for (size_t i = 0; i < data_num; ++i) {
+    dp.set_label(labels[i]);
+    vector<float> predict(predicts.begin() + i * cls_num,
+                          predicts.begin() + (i + 1) * cls_num);
+    fill(gradient.begin(), gradient.end(), 0.f);
+    float l = loss->gradient(dp, predict.data(), predict_labels[i],
+                             gradient.data(), cls_num);
+    max_err = (max)(max_err, fabs(l - losses[i]) / (1.f + fabs(l)));
+    for (int c = 0; c < cls_num; ++c) {
+      max_err = (max)(max_err, fabs(gradient[c] - gradients[i * cls_num + c]));
+    }
+  }
+  fprintf(stdout, "%s: max error %g\n", name.c_str(), max_err);
+  return max_err <= tolerance ? 0 : 1;
+}
+
+int main() {
+  // approximation error of the fast functions
+  float exp_err = 0, log1p_err = 0;
+  for (float x = -80; x <= 80; x += 0.01f) {
+    exp_err = (max)(exp_err, float(fabs(math::fast_exp(x) / exp(double(x)) -
+                                        1)));
+  }
+  for (float x = 1e-10f; x <= 1; x *= 1.01f) {
+    log1p_err = (max)(log1p_err, float(fabs(math::fast_log1p(x) /
+                                            log1p(double(x)) - 1)));
+  }
+  fprintf(stdout, "fast_exp: max relative error %g\n", exp_err);
+  fprintf(stdout, "fast_log1p: max relative error %g\n", log1p_err);
+  int ret = exp_err < 5e-7f && log1p_err < 2e-7f ? 0 : 1;
+
+  ret |= test_loss("hinge", 1, 0);
+  ret |= test_loss("logistic", 1, 1e-5f);
+  ret |= test_loss("square", 1, 0);
+  ret |= test_loss("bool", 1, 0);
+  ret |= test_loss("maxscore-hinge", 5, 0);
+  ret |= test_loss("maxscore-logistic", 5, 1e-5f);
+  ret |= test_loss("maxscore-bool", 5, 0);
+  ret |= test_loss("uniform-hinge", 5, 0);
+
+  fprintf(stdout, ret == 0 ? "test passed\n" : "test failed\n");
+  return ret;
+}
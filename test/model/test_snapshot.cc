@@ -0,0 +1,103 @@
+/*********************************************************************************
+*     File Name           :     test_snapshot.cc
+*     Created By          :     yuewu
+*     Description         :     test predicting with weight snapshots while
+*                               training
+**********************************************************************************/
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include <sol/sol.h>
+#include <sol/model/predictor.h>
+
+using namespace std;
+using namespace sol;
+using namespace sol::pario;
+using namespace sol::model;
+
+int test_snapshot(const string& algo, const char* path,
+                  const vector<DataPoint>& points) {
+  unique_ptr<Model> model(Model::Create(algo, 2));
+  OnlineLinearModel* olm = dynamic_cast<OnlineLinearModel*>(model.get());
+  if (olm == nullptr) {
+    fprintf(stderr, "create model %s failed\n", algo.c_str());
+    return 1;
+  }
+  olm->set_iterate_callback(nullptr, nullptr);
+  olm->SetParameter("snapshot_interval", "100");
+
+  // predict with the latest snapshot while training
+  atomic<bool> training(true);
+  size_t predict_num = 0;
+  thread reader([&]() {
+    float predicts[1];
+    while (training) {
+      shared_ptr<const Predictor> snapshot = olm->snapshot();
+      if (snapshot == nullptr) continue;
+      for (const DataPoint& x : points) snapshot->Predict(x, predicts);
+      ++predict_num;
+    }
+  });
+  DataIter iter(16);
+  iter.AddReader(path, "svm");
+  olm->Train(iter, NULL, NULL, NULL, NULL, NULL, NULL);
+  training = false;
+  reader.join();
+
+  // the last snapshot is the same as the finalized model
+  shared_ptr<const Predictor> snapshot = olm->snapshot();
+  Predictor predictor(*olm);
+  for (const DataPoint& x : points) {
+    float expected, predict;
+    predictor.Predict(x, &expected);
+    snapshot->Predict(x, &predict);
+    if (std::abs(expected - predict) > 1e-5f * (1 + std::abs(expected))) {
+      fprintf(stderr, "%s: snapshot predicts %f, model predicts %f\n",
+              algo.c_str(), predict, expected);
+      return 1;
+    }
+  }
+  printf("%s: %d predictions on snapshots\n", algo.c_str(), int(predict_num));
+  return 0;
+}
+
+int main() {
+  const char* path = "tmp_test_snapshot.svm";
+  mt19937 gen(1);
+  uniform_int_distribution<int> index_dis(1, 100);
+  normal_distribution<float> value_dis;
+  vector<DataPoint> points;
+  ofstream out_file(path, ios::out);
+  for (int i = 0; i < 5000; ++i) {
+    DataPoint x;
+    for (int k = 0; k < 10; ++k) x.AddNewFeat(index_dis(gen), value_dis(gen));
+    x.Sort();
+    x.MergeDuplicates();
+    float score = 0;
+    for (size_t k = 0; k < x.size(); ++k) {
+      score += x.index(k) % 2 == 0 ? x.feature(k) : -x.feature(k);
+    }
+    x.set_label(score > 0 ? 1 : -1);
+    out_file << x.label();
+    for (size_t k = 0; k < x.size(); ++k) {
+      out_file << " " << x.index(k) << ":" << x.feature(k);
+    }
+    out_file << "\n";
+    if (points.size() < 100) points.push_back(x);
+  }
+  out_file.close();
+
+  int ret = 0;
+  for (const char* algo : {"ogd", "stg", "fobos-l1", "ada-fobos-l1",
+                           "ada-rda", "ada-rda-l1", "rda-l1", "erda-l1",
+                           "sop", "arow"}) {
+    ret |= test_snapshot(algo, path, points);
+  }
+  delete_file(path, true);
+  return ret;
+}
@@ -0,0 +1,66 @@
+/*********************************************************************************
+*     File Name           :     test_transform.cc
+*     Created By          :     yuewu
+*     Description         :     test the transforms of mini-batches
+**********************************************************************************/
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <sol/pario/transform.h>
+#include <sol/util/error_code.h>
+
+using namespace sol;
+using namespace sol::pario;
+using namespace std;
+
+int main() {
+  vector<shared_ptr<Transform>> transforms;
+  int ret = Transform::CreateList(
+      "clip:min=-2,max=2; binarize:thresh=0.5 ;hash:bits=3", transforms);
+  if (ret != Status_OK || transforms.size() != 3) {
+    fprintf(stderr, "create transforms failed\n");
+    return 1;
+  }
+
+  MiniBatch mb(2);
+  mb.data_num = 2;
+  for (index_t i = 1; i <= 20; ++i) {
+    mb[0].AddNewFeat(i, real_t(i) / 10);
+    mb[1].AddNewFeat(i * 7, -real_t(i));
+  }
+  for (const shared_ptr<Transform>& trans : transforms) {
+    trans->Apply(mb);
+  }
+
+  for (int k = 0; k < mb.size(); ++k) {
+    const DataPoint& x = mb[k];
+    real_t sum = 0;
+    cout << "data point " << k << ":";
+    for (size_t i = 0; i < x.size(); ++i) {
+      cout << " " << x.index(i) << ":" << x.feature(i);
+      if (x.index(i) < 1 || x.index(i) > 8 ||
+          (i > 0 && x.index(i) <= x.index(i - 1))) {
+        fprintf(stderr, "\ninvalid hashed index %d\n", int(x.index(i)));
+        return 1;
+      }
+      sum += x.feature(i);
+    }
+    cout << endl;
+    // 15 of the 20 features are larger than 0.5 for the first, none for the
+    // second
+    real_t expected = k == 0 ? 10.f : -20.f;
+    if (sum != expected) {
+      fprintf(stderr, "sum of features %f, expected %f\n", sum, expected);
+      return 1;
+    }
+  }
+
+  if (Transform::CreateList("clip:lower=1", transforms) == Status_OK) {
+    fprintf(stderr, "invalid parameter not detected\n");
+    return 1;
+  }
+  return 0;
+}
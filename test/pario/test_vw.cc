@@ -0,0 +1,81 @@
+/*********************************************************************************
+*     File Name           :     test_vw.cc
+*     Created By          :     yuewu
+*     Description         :     test vowpal wabbit format reader
+**********************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "sol/pario/data_reader.h"
+#include "sol/util/hash.h"
+#include "sol/util/util.h"
+
+using namespace sol;
+using namespace sol::pario;
+using namespace std;
+
+int main() {
+  const char* test_data =
+      "1 |a x:2 y x |b:0.5 x z:0\n"
+      "-1 2.0 'tag|a y\n"
+      "1 |x :3\n";
+
+  const char* out_path = "tmp_test_vw_reader.vw";
+  ofstream out_file(out_path, ios::out);
+  if (!out_file) {
+    cerr << "open " << out_path << " failed!\n";
+    return -1;
+  }
+  out_file << test_data;
+  out_file.close();
+
+  DataReader* reader = DataReader::Create("vw:bits=10");
+  if (reader == nullptr) {
+    cerr << "create vw reader failed!\n";
+    return -1;
+  }
+  if (reader->Open(out_path) != Status_OK) {
+    delete reader;
+    return -1;
+  }
+
+  uint32_t mask = (1 << 10) - 1;
+  index_t ax = (murmur3_32("x", 1, murmur3_32("a", 1, 0)) & mask) + 1;
+  index_t ay = (murmur3_32("y", 1, murmur3_32("a", 1, 0)) & mask) + 1;
+  index_t bx = (murmur3_32("x", 1, murmur3_32("b", 1, 0)) & mask) + 1;
+
+  int ret = Status_OK;
+  DataPoint dp;
+  // duplicated features are summed, zero features are skipped
+  if (reader->Next(dp) != Status_OK || dp.label() != 1 || dp.size() != 3) {
+    cerr << "parse line 0 failed\n";
+    ret = Status_Error;
+  }
+  for (size_t i = 0; ret == Status_OK && i < dp.size(); ++i) {
+    real_t expected = dp.index(i) == ax ? 3 : dp.index(i) == ay ? 1 : 0.5;
+    if ((dp.index(i) != ax && dp.index(i) != ay && dp.index(i) != bx) ||
+        dp.feature(i) != expected ||
+        (i > 0 && dp.index(i - 1) >= dp.index(i))) {
+      cerr << "check features of line 0 failed\n";
+      ret = Status_Error;
+    }
+  }
+  // importance and tag are ignored
+  if (ret == Status_OK &&
+      (reader->Next(dp) != Status_OK || dp.label() != -1 || dp.size() != 1 ||
+       dp.index(0) != ay)) {
+    cerr << "parse line 1 failed\n";
+    ret = Status_Error;
+  }
+  if (ret == Status_OK && reader->Next(dp) != Status_Invalid_Format) {
+    cerr << "invalid line 2 not detected\n";
+    ret = Status_Error;
+  }
+  delete reader;
+  delete_file(out_path, true);
+
+  if (ret == Status_OK) cout << "check vw reader succeed!\n";
+  return ret;
+}
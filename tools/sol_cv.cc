@@ -0,0 +1,117 @@
+/*********************************************************************************
+*     File Name           :     sol_cv.cc
+*     Created By          :     yuewu
+*     Description         :     cross validation entry of sol
+**********************************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sol/sol.h>
+#include <sol/pario/data_arena.h>
+#include <sol/model/cross_validation.h>
+#include <cmdline/cmdline.h>
+
+using namespace sol;
+using namespace sol::pario;
+using namespace sol::model;
+using namespace std;
+
+int main(int argc, char** argv) {
+// check memory leak in VC++
+#if defined(_MSC_VER) && defined(_DEBUG)
+  int tmpFlag = _CrtSetDbgFlag(_CRTDBG_REPORT_FLAG);
+  tmpFlag |= _CRTDBG_LEAK_CHECK_DF;
+  _CrtSetDbgFlag(tmpFlag);
+//_CrtSetBreakAlloc(231);
+#endif
+
+  cmdline::parser parser;
+  parser.add<string>("format", 'f',
+                     "dataset format (csv, svm, bin, vw), parameters of the "
+                     "reader follow ':', e.g. 'vw:bits=20'",
+                     false, "io", "svm");
+  parser.add<int>("classes", 'c', "class number", false, "io", 2);
+  parser.add<int>("pass", 'p', "number of passes", false, "io", 1);
+  parser.add<int>("batchsize", 'b', "batch size", false, "io", 256);
+  parser.add<string>("algo", 'a', "learning algorithm", false, "model", "ogd");
+  parser.add<string>(
+      "params", 0, "fixed parameters, in the format 'param=val;param=val;...'",
+      false, "model", "");
+  parser.add<int>("fold", 'n', "number of folds", false, "cv", 5);
+  parser.add<string>(
+      "grid", 'g',
+      "parameters to search, in the format 'param=v1,v2;param=v1,v2;...'",
+      false, "cv", "");
+  parser.add<int>("threads", 't', "number of threads", false, "cv", 1);
+  parser.add("shuffle", 'r', "shuffle the data before splitting", "cv");
+  parser.add<unsigned int>("seed", 0, "random seed of shuffling", false, "cv",
+                           0);
+  parser.footer("data_file");
+
+  parser.parse_check(argc, argv);
+  if (parser.rest().size() != 1) {
+    fprintf(stderr, "%s\n", parser.usage().c_str());
+    return Status_Invalid_Argument;
+  }
+
+  // parse the data once
+  DataArena arena;
+  {
+    DataIter iter(parser.get<int>("batchsize"));
+    int ret = iter.AddReader(parser.rest()[0], parser.get<string>("format"));
+    if (ret != Status_OK) return ret;
+    ret = arena.Load(iter);
+    if (ret != Status_OK) return ret;
+  }
+  fprintf(stdout, "%lu examples loaded\n", (unsigned long)(arena.size()));
+
+  int fold_num = parser.get<int>("fold");
+  try {
+    CrossValidation cv(arena, parser.get<string>("algo"),
+                       parser.get<int>("classes"), fold_num);
+    for (const string& setting : CrossValidation::ExpandGrid(
+             parser.get<string>("grid"), parser.get<string>("params"))) {
+      int ret = cv.AddSetting(setting);
+      if (ret != Status_OK) return ret;
+    }
+
+    double start_time = get_current_time();
+    int ret = cv.Run(parser.get<int>("threads"), parser.get<int>("pass"),
+                     parser.get<int>("batchsize"), parser.exist("shuffle"),
+                     parser.get<unsigned int>("seed"));
+    if (ret != Status_OK) return ret;
+
+    size_t best = 0;
+    float best_accu = -1;
+    for (size_t i = 0; i < cv.setting_num(); ++i) {
+      float train_accu = 0, val_accu = 0;
+      fprintf(stdout, "params: %s\n\tvalidation accuracy:",
+              cv.setting(i).c_str());
+      for (int k = 0; k < fold_num; ++k) {
+        train_accu += cv.train_accuracy(i, k) / fold_num;
+        val_accu += cv.val_accuracy(i, k) / fold_num;
+        fprintf(stdout, " %.4f", cv.val_accuracy(i, k));
+      }
+      fprintf(stdout, "\n\taverage training accuracy: %.4f, validation "
+                      "accuracy: %.4f\n",
+              train_accu, val_accu);
+      if (val_accu > best_accu) {
+        best_accu = val_accu;
+        best = i;
+      }
+    }
+    fprintf(stdout, "best params: %s\nbest validation accuracy: %.4f\n",
+            cv.setting(best).c_str(), best_accu);
+    fprintf(stdout, "cross validation time: %.3f seconds\n",
+            get_current_time() - start_time);
+  }
+  catch (invalid_argument& err) {
+    fprintf(stderr, "%s\n", err.what());
+    return Status_Invalid_Argument;
+  }
+  return Status_OK;
+}
@@ -6,11 +6,16 @@
 *     Description         :     test entry of sol
 **********************************************************************************/
 
+#include <algorithm>
 #include <string>
 #include <cstdlib>
+#include <functional>
 #include <memory>
 
 #include <sol/sol.h>
+#include <sol/model/online_linear_model.h>
+#include <sol/model/predictor.h>
+#include <sol/model/sparse_model.h>
 #include <sol/util/str_util.h>
 #include <cmdline/cmdline.h>
 
@@ -21,6 +26,10 @@ using namespace std;
 
 void getparser(int argc, char** argv, cmdline::parser&);
 int test(cmdline::parser& parser);
+/// \brief  test the data set with the test function of the model
+int test(cmdline::parser& parser, const string& input_path,
+         const string& output_path,
+         const function<float(DataIter&, ostream*, Evaluator*)>& test_func);
 
 int main(int argc, char** argv) {
 // check memory leak in VC++
@@ -52,6 +61,22 @@ int test(cmdline::parser& parser) {
     return Status_Invalid_Argument;
   }
 
+  // sparse models exported by sol_train --export
+  if (SparseModel::IsSparseModel(model_path)) {
+    if (parser.exist("filter")) {
+      fprintf(stderr, "filter is not supported by sparse models\n");
+      return Status_Invalid_Argument;
+    }
+    SparseModel sparse_model;
+    int ret = sparse_model.Load(model_path);
+    if (ret != Status_OK) return ret;
+    return test(parser, input_path, output_path,
+                [&sparse_model](DataIter& iter, ostream* os,
+                                Evaluator* evaluator) {
+                  return sparse_model.Test(iter, os, evaluator);
+                });
+  }
+
   shared_ptr<Model> model(Model::Load(model_path));
   if (model == nullptr) return Status_Invalid_Argument;
   if (parser.exist("filter")) {
@@ -64,33 +89,88 @@ int test(cmdline::parser& parser) {
     }
   }
 
-  // load data
-  DataIter iter(parser.get<int>("batchsize"), parser.get<int>("bufsize"));
+  // score with the read-only predictor on multiple threads
+  int thread_num = parser.get<int>("threads");
+  if (thread_num > 1) {
+    OnlineLinearModel* olm = dynamic_cast<OnlineLinearModel*>(model.get());
+    if (olm == nullptr) {
+      fprintf(stderr, "multi-thread test is not supported by the model\n");
+      return Status_Invalid_Argument;
+    }
+    Predictor predictor(*olm);
+    model.reset();
+    return test(parser, input_path, output_path,
+                [&predictor, thread_num](DataIter& iter, ostream* os,
+                                         Evaluator* evaluator) {
+                  return predictor.Test(iter, os, thread_num, evaluator);
+                });
+  }
+
+  return test(parser, input_path, output_path,
+              [&model](DataIter& iter, ostream* os, Evaluator* evaluator) {
+                return model->Test(iter, os, evaluator);
+              });
+}
+
+int test(cmdline::parser& parser, const string& input_path,
+         const string& output_path,
+         const function<float(DataIter&, ostream*, Evaluator*)>& test_func) {
+  // load data, each thread holds a mini-batch while testing
+  int buf_size = (std::max)(parser.get<int>("bufsize"),
+                            parser.get<int>("threads") + 1);
+  DataIter iter(parser.get<int>("batchsize"), buf_size);
   int ret = iter.AddReader(input_path, parser.get<string>("format"));
   if (ret != Status_OK) return ret;
+  ret = iter.AddTransform(parser.get<string>("transform"));
+  if (ret != Status_OK) return ret;
+
+  unique_ptr<Evaluator> evaluator;
+  if (parser.exist("auc")) {
+    evaluator.reset(new Evaluator(parser.get<string>("auc") == "approx"
+                                      ? AucMode::Approx
+                                      : AucMode::Exact));
+  }
 
   double start_time = sol::get_current_time();
   float err_rate;
   if (!output_path.empty()) {
     ofstream out_file(output_path.c_str(), ios::out);
-	err_rate = model->Test(iter, &out_file, NULL, NULL, NULL, NULL, NULL);
+    err_rate = test_func(iter, &out_file, evaluator.get());
     out_file.close();
   } else {
-	  err_rate = model->Test(iter, nullptr, NULL, NULL, NULL, NULL, NULL);
+    err_rate = test_func(iter, nullptr, evaluator.get());
   }
+  float auc = evaluator ? evaluator->AUC() : 0;
   double end_time = sol::get_current_time();
   fprintf(stdout, "test accuracy: %.4f\n", 1.f - err_rate);
+  if (evaluator) {
+    if (evaluator->roc_num() > 0) fprintf(stdout, "test AUC: %.4f\n", auc);
+    fprintf(stdout, "test log loss: %.4f\n", evaluator->log_loss());
+  }
   fprintf(stdout, "test time: %.3f seconds\n", end_time - start_time);
   return Status_OK;
 }
 
 void getparser(int argc, char** argv, cmdline::parser& parser) {
   // pario related options
-  parser.add<string>("format", 'f', "dataset format", false, "", "svm",
-                     cmdline::oneof<string>("csv", "svm", "bin"));
+  parser.add<string>("format", 'f',
+                     "dataset format (csv, svm, bin, vw), parameters of the "
+                     "reader follow ':', e.g. 'vw:bits=20'",
+                     false, "", "svm");
   parser.add<int>("batchsize", 'b', "batch size", false, "", 256);
   parser.add<int>("bufsize", 0, "number of buffered minibatches", false, "", 2);
-
+  parser.add<string>("transform", 0,
+                     "transforms of the data on the reader threads, in the "
+                     "format 'name:param=val,...;name:param=val,...'",
+                     false, "", "");
+
+  parser.add<int>("threads", 't', "number of testing threads", false, "", 1);
+
+  parser.add<string>("auc", 0,
+                     "evaluate AUC and log loss, exact or approx (bounded "
+                     "memory)",
+                     false, "", "exact",
+                     cmdline::oneof<string>("exact", "approx"));
   parser.add<string>("filter", 0, "filtered features", false);
   parser.add("help", 'h', "print this message");
   parser.footer("model_file test_file [output_file]");
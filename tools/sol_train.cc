@@ -11,6 +11,11 @@
 #include <memory>
 
 #include <sol/sol.h>
+#include <sol/dist/coordinator.h>
+#include <sol/dist/shm_transport.h>
+#include <sol/model/online_linear_model.h>
+#include <sol/model/sparse_model.h>
+#include <sol/util/stats.h>
 #include <sol/util/str_util.h>
 #include <cmdline/cmdline.h>
 
@@ -21,6 +26,7 @@ using namespace std;
 
 void getparser(int argc, char** argv, cmdline::parser&);
 int train(cmdline::parser& parser);
+void ShowStats();
 
 int main(int argc, char** argv) {
 // check memory leak in VC++
@@ -48,8 +54,11 @@ int train(cmdline::parser& parser) {
     return Status_Invalid_Argument;
   }
 
+  int ret = Status_OK;
   shared_ptr<Model> model;
-  if (parser.exist("model")) {
+  if (parser.exist("resume")) {
+    model.reset(Model::Load(parser.get<string>("resume")));
+  } else if (parser.exist("model")) {
     model.reset(Model::Load(parser.get<string>("model")));
   } else if (parser.get<string>("algo").length()) {
     model.reset(
@@ -59,6 +68,10 @@ int train(cmdline::parser& parser) {
     return Status_Invalid_Argument;
   }
   if (model == nullptr) return Status_Invalid_Argument;
+  // keep writing checkpoints to the resumed one unless set in params
+  if (parser.exist("resume")) {
+    model->SetParameter("checkpoint", parser.get<string>("resume"));
+  }
 
   const string& model_params = parser.get<string>("params");
   if (model_params.length() > 0) {
@@ -78,13 +91,53 @@ int train(cmdline::parser& parser) {
     }
   }
 
+  // data-parallel workers on the same host
+  int worker_num = parser.get<int>("workers");
+  int rank = parser.get<int>("rank");
+  dist::ShmTransport transport;
+  unique_ptr<dist::Coordinator> coordinator;
+  if (worker_num > 1) {
+    OnlineLinearModel* olm = dynamic_cast<OnlineLinearModel*>(model.get());
+    if (olm == nullptr) {
+      fprintf(stderr, "distributed training is not supported by the model\n");
+      return Status_Invalid_Argument;
+    }
+    ret = transport.Open(parser.get<string>("shm"), rank, worker_num);
+    if (ret != Status_OK) return ret;
+    coordinator.reset(
+        new dist::Coordinator(&transport, parser.get<int>("sync")));
+    olm->set_coordinator(coordinator.get());
+  }
+
   // load data
   DataIter iter(parser.get<int>("batchsize"), parser.get<int>("bufsize"));
-  int ret = iter.AddReader(input_path, parser.get<string>("format"),
+  ret = iter.AddReader(input_path, parser.get<string>("format"),
                            parser.get<int>("pass"));
   if (ret != Status_OK) return ret;
+  ret = iter.AddTransform(parser.get<string>("transform"));
+  if (ret != Status_OK) return ret;
+  // preprocess the data of the model on the reader threads
+  if (parser.exist("reader-preprocess")) {
+    iter.AddTransform(make_shared<PreProcessTransform>(model.get()));
+  }
+
+  // skip the data trained before the checkpoint
+  if (parser.exist("resume")) {
+    OnlineModel* online_model = dynamic_cast<OnlineModel*>(model.get());
+    if (online_model == nullptr || online_model->resume_pos().reader < 0) {
+      fprintf(stderr,
+              "position of the data is not in the checkpoint, train from "
+              "the beginning of the data\n");
+    } else {
+      ret = iter.Seek(online_model->resume_pos());
+      if (ret != Status_OK) return ret;
+      fprintf(stdout, "resume from the checkpoint after %lu data\n",
+              (unsigned long)(online_model->cur_data_num()));
+    }
+  }
 
   cout << "Model Information: \n" << model->model_info() << "\n";
+  if (parser.exist("stats")) Stats::set_enabled(true);
   double start_time = sol::get_current_time();
 
   float err_rate = model->Train(iter, NULL, NULL, NULL, NULL, NULL, NULL);//modified by jing
@@ -92,16 +145,61 @@ int train(cmdline::parser& parser) {
   fprintf(stdout, "training accuracy: %.4f\n", 1.f - err_rate);
   fprintf(stdout, "training time: %.3f seconds\n", end_time - start_time);
   fprintf(stdout, "model sparsity: %.4f%%\n", model->model_sparsity() * 100.f);/////////////////////////////////////////////////////////////
+  vector<Model::MemoryBlock> blocks;
+  model->MemoryUsage(blocks);
+  size_t used_bytes = 0, allocated_bytes = 0;
+  for (const Model::MemoryBlock& block : blocks) {
+    used_bytes += block.used;
+    allocated_bytes += block.allocated;
+  }
+  fprintf(stdout, "model memory: %.2f MB allocated, %.2f MB used\n",
+          allocated_bytes / 1048576.0, used_bytes / 1048576.0);
+  if (parser.exist("stats")) ShowStats();
 
-  // save model
-  if (!output_path.empty()) {
-    model->Save(output_path);
+  // save model, the models of the workers are the same
+  if (!output_path.empty() && (worker_num <= 1 || rank == 0)) {
+    model->Save(output_path, parser.exist("binary"));
     fprintf(stdout, "save time: %.3f seconds\n", get_current_time() - end_time);
   }
 
+  // export the non-zero weights for inference
+  if (parser.exist("export") && (worker_num <= 1 || rank == 0)) {
+    OnlineLinearModel* olm = dynamic_cast<OnlineLinearModel*>(model.get());
+    if (olm == nullptr) {
+      fprintf(stderr, "sparse export is not supported by the model\n");
+      return Status_Invalid_Argument;
+    }
+    SparseModel sparse_model;
+    ret = sparse_model.Build(*olm);
+    if (ret == Status_OK) ret = sparse_model.Save(parser.get<string>("export"));
+    if (ret != Status_OK) return ret;
+    fprintf(stdout, "exported %lu of %lu features\n",
+            (unsigned long)(sparse_model.feat_num()),
+            (unsigned long)(sparse_model.dim()));
+  }
+
   return Status_OK;
 }
 
+/// \brief  show the counters of the stages of the training pipeline
+void ShowStats() {
+  PipelineStats stats;
+  Stats::Collect(stats);
+  fprintf(stdout, "pipeline stats (summed over threads):\n");
+  fprintf(stdout, "  parse: %.3f seconds, %llu data, %.2f MB read\n",
+          stats.parse_ns * 1e-9, (unsigned long long)(stats.parse_num),
+          stats.read_bytes / 1048576.0);
+  fprintf(stdout, "  reader wait: %.3f seconds\n", stats.reader_wait_ns * 1e-9);
+  fprintf(stdout, "  trainer wait: %.3f seconds\n",
+          stats.trainer_wait_ns * 1e-9);
+  fprintf(stdout, "  predict: %.3f seconds\n", stats.predict_ns * 1e-9);
+  fprintf(stdout, "  loss: %.3f seconds\n", stats.loss_ns * 1e-9);
+  fprintf(stdout, "  update: %.3f seconds\n", stats.update_ns * 1e-9);
+  fprintf(stdout, "  reallocations: %llu, %.2f MB\n",
+          (unsigned long long)(stats.realloc_num),
+          stats.realloc_bytes / 1048576.0);
+}
+
 /// \brief  show classes of a group in a group
 void showinfo(const std::string& group) {
   ClassFactory::ClsInfoMapType info_map = ClassFactory::ClassInfoMap();
@@ -116,19 +214,31 @@ void showinfo(const std::string& group) {
 
 void getparser(int argc, char** argv, cmdline::parser& parser) {
   parser.add<string>(
-      "show", 's', "show related information(model, loss, reader, writer)",
+      "show", 's',
+      "show related information(model, loss, reader, writer, transform)",
       false, "", "",
-      cmdline::oneof<string>("", "model", "loss", "reader", "writer"));
+      cmdline::oneof<string>("", "model", "loss", "reader", "writer",
+                             "transform"));
 
   // input & output
-  parser.add<string>("format", 'f', "dataset format", false, "io", "svm",
-                     cmdline::oneof<string>("csv", "svm", "bin"));
+  parser.add<string>("format", 'f',
+                     "dataset format (csv, svm, bin, vw), parameters of the "
+                     "reader follow ':', e.g. 'vw:bits=20'",
+                     false, "io", "svm");
   parser.add<int>("classes", 'c', "class number", false, "io", 2);
   parser.add<int>("pass", 'p', "number of passes", false, "io", 1);
   parser.add<string>("dim", 'd', "dimension of features", false, "io");
   parser.add<int>("batchsize", 'b', "batch size", false, "io", 256);
   parser.add<int>("bufsize", 0, "number of buffered minibatches", false, "io",
                   2);
+  parser.add<string>("transform", 0,
+                     "transforms of the data on the reader threads, in the "
+                     "format 'name:param=val,...;name:param=val,...'",
+                     false, "io", "");
+  parser.add("reader-preprocess", 0,
+             "preprocess the data of the model (normalization, feature "
+             "filtering) on the reader threads",
+             "io");
 
   // model setting
   parser.add<string>("algo", 'a', "learning algorithm", false, "model", "ogd");
@@ -136,6 +246,37 @@ void getparser(int argc, char** argv, cmdline::parser& parser) {
   parser.add<string>(
       "params", 0, "model parameters, in the format 'param=val;param=val;...'",
       false, "model");
+  parser.add<string>("resume", 0,
+                     "path to the checkpoint to resume the training from, "
+                     "which is written with the params "
+                     "'checkpoint=path;checkpoint_interval=N' or "
+                     "'checkpoint_sec=T', the data trained are skipped",
+                     false, "model");
+  parser.add("binary", 0,
+             "save the model in binary format, which is loaded by mapping "
+             "the file into memory",
+             "model");
+  parser.add("stats", 0,
+             "show the time of parsing, waiting for the data, predicting, "
+             "computing the losses and updating, and the reallocations of "
+             "the model",
+             "model");
+  parser.add<string>("export", 0,
+                     "path to export the non-zero weights as a sparse model "
+                     "for inference",
+                     false, "model");
+
+  // distributed training
+  parser.add<int>("workers", 0, "number of data-parallel worker processes",
+                  false, "dist", 1);
+  parser.add<int>("rank", 0, "rank of the worker, in [0, workers)", false,
+                  "dist", 0);
+  parser.add<int>("sync", 0,
+                  "number of instances of each worker between model "
+                  "synchronizations, 0 to synchronize at the end only",
+                  false, "dist", 10000);
+  parser.add<string>("shm", 0, "name of the shared memory of the workers",
+                     false, "dist", "sol_train");
 
   parser.add("help", 'h', "print this message");
   parser.footer("train_file [model_file]");